@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+#include <core/mesh.hpp>
+#include <geometry/constrained.hpp>
+#include <geometry/delaunay.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/**
+ * @brief state.range(0) points of a terrain scan: uniform in a square, with a height field.
+ *
+ */
+class DelaunayBench : public ::benchmark::Fixture
+{
+protected:
+  std::vector<geometry::Point2> points;
+
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+    points.resize(state.range(0));
+    for (geometry::Point2 &p : points)
+    {
+      p = {coordinate(rng), coordinate(rng)};
+    }
+  }
+};
+
+BENCHMARK_DEFINE_F(DelaunayBench, sort_hilbert)(::benchmark::State &state)
+{
+  std::vector<uint32_t> order;
+  for (auto _ : state)
+  {
+    geometry::sort_hilbert(points.data(), points.size(), order);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+BENCHMARK_DEFINE_F(DelaunayBench, triangulate)(::benchmark::State &state)
+{
+  geometry::DelaunayTriangulation triangulation;
+  for (auto _ : state)
+  {
+    geometry::delaunay(points.data(), points.size(), triangulation);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+BENCHMARK_DEFINE_F(DelaunayBench, triangulate_scan_lines)(::benchmark::State &state)
+{
+  // The points moved down to 10 scan lines, 100 apart.
+  std::vector<geometry::Point2> lines(points.size());
+  for (size_t i = 0; i < points.size(); i++)
+  {
+    lines[i] = {points[i].x, std::floor(points[i].y / 100.0) * 100.0};
+  }
+
+  geometry::DelaunayTriangulation triangulation;
+  for (auto _ : state)
+  {
+    geometry::delaunay(lines.data(), lines.size(), triangulation);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+BENCHMARK_DEFINE_F(DelaunayBench, triangulate_parallel)(::benchmark::State &state)
+{
+  geometry::DelaunayTriangulation triangulation;
+  for (auto _ : state)
+  {
+    geometry::delaunay_parallel(points.data(), points.size(), triangulation, static_cast<int>(state.range(1)));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+BENCHMARK_DEFINE_F(DelaunayBench, mesh)(::benchmark::State &state)
+{
+  std::vector<Core::Vertex::Vertex> terrain(points.size());
+  for (size_t i = 0; i < points.size(); i++)
+  {
+    terrain[i] = {points[i].x, points[i].y, std::sin(points[i].x * 0.01) * 10.0};
+  }
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(geometry::delaunay_mesh(terrain, "terrain", static_cast<int>(state.range(1))));
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+BENCHMARK_DEFINE_F(DelaunayBench, constrain)(::benchmark::State &state)
+{
+  std::vector<Core::Vertex::Vertex> terrain(points.size());
+  for (size_t i = 0; i < points.size(); i++)
+  {
+    terrain[i] = {points[i].x, points[i].y, 0.0};
+  }
+
+  // Breaklines along 100 columns, through the points of a band around each column by height.
+  std::vector<std::vector<int>> columns(100);
+  for (size_t i = 0; i < points.size(); i++)
+  {
+    const double column = points[i].x / 10.0;
+    if (column - std::floor(column) < 0.1)
+    {
+      columns[static_cast<int>(column)].push_back(static_cast<int>(i));
+    }
+  }
+  std::vector<geometry::Segment> segments;
+  for (std::vector<int> &column : columns)
+  {
+    std::sort(column.begin(), column.end(), [&](int a, int b)
+              { return points[a].y < points[b].y; });
+    for (size_t i = 1; i < column.size(); i++)
+    {
+      segments.push_back({column[i - 1], column[i]});
+    }
+  }
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    Core::Mesh *mesh = geometry::delaunay_mesh(terrain, "terrain", 1);
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(geometry::insert_constraints(mesh, segments));
+  }
+  state.SetItemsProcessed(state.iterations() * segments.size());
+}
+
+BENCHMARK_REGISTER_F(DelaunayBench, sort_hilbert)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(DelaunayBench, triangulate)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(DelaunayBench, triangulate_scan_lines)->RangeMultiplier(10)->Range(10000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(DelaunayBench, triangulate_parallel)->ArgsProduct({{100000, 1000000}, {1, 2, 8}})->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(DelaunayBench, mesh)->ArgsProduct({{100000}, {1, 0}})->Unit(benchmark::kMillisecond)->Iterations(1);
+BENCHMARK_REGISTER_F(DelaunayBench, constrain)->Arg(100000)->Unit(benchmark::kMillisecond)->Iterations(3);
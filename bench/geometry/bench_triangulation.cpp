@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include <core/mesh.hpp>
+#include <core/vector.hpp>
+#include <geometry/triangulation.hpp>
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A star polygon with state.range(0) vertices, concave on every other vertex.
+ *
+ */
+class PolygonTriangulationBench : public ::benchmark::Fixture
+{
+protected:
+  std::vector<geometry::Point2> polygon;
+  std::vector<geometry::Triangle> triangles;
+
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    const int count = static_cast<int>(state.range(0));
+    polygon.clear();
+    for (int i = 0; i < count; i++)
+    {
+      const double angle = 6.283185307179586 * i / count;
+      const double radius = i % 2 == 0 ? 1.0 : 0.6;
+      polygon.push_back({radius * std::cos(angle), radius * std::sin(angle)});
+    }
+    triangles.resize(count - 2);
+  }
+};
+
+BENCHMARK_DEFINE_F(PolygonTriangulationBench, ear_clipping)(::benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    geometry::ear_clipping(polygon.data(), static_cast<int>(polygon.size()), triangles.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * polygon.size());
+}
+
+BENCHMARK_DEFINE_F(PolygonTriangulationBench, monotone)(::benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    geometry::monotone_triangulation(polygon.data(), static_cast<int>(polygon.size()), triangles.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * polygon.size());
+}
+
+BENCHMARK_REGISTER_F(PolygonTriangulationBench, ear_clipping)->Arg(8)->Arg(32)->Arg(128)->Arg(512);
+BENCHMARK_REGISTER_F(PolygonTriangulationBench, monotone)->Arg(8)->Arg(32)->Arg(128)->Arg(512);
+
+/**
+ * @brief A grid of state.range(0) x state.range(0) quads, triangulated with state.range(1)
+ * threads (0 for one per hardware thread). The meshes are built once and shared by all runs.
+ *
+ */
+class MeshTriangulationBench : public ::benchmark::Fixture
+{
+protected:
+  Core::Mesh *mesh = nullptr;
+
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    static std::map<int, Core::Mesh *> grids;
+    const int n = static_cast<int>(state.range(0));
+    if (grids.count(n) == 0)
+    {
+      std::vector<Core::Vector *> vertexes;
+      for (int y = 0; y <= n; y++)
+      {
+        for (int x = 0; x <= n; x++)
+        {
+          vertexes.push_back(new Core::Vector(x, y, 0.0, 1.0, nullptr, "v"));
+        }
+      }
+      std::vector<std::vector<int>> faces;
+      for (int y = 0; y < n; y++)
+      {
+        for (int x = 0; x < n; x++)
+        {
+          const int v = y * (n + 1) + x;
+          faces.push_back({v, v + 1, v + n + 2, v + n + 1});
+        }
+      }
+      grids[n] = new Core::Mesh(vertexes, faces, "grid");
+    }
+    mesh = grids[n];
+  }
+};
+
+BENCHMARK_DEFINE_F(MeshTriangulationBench, triangulate_mesh)(::benchmark::State &state)
+{
+  geometry::MeshTriangulation triangulation;
+  for (auto _ : state)
+  {
+    geometry::triangulate_mesh(mesh, triangulation, static_cast<int>(state.range(1)));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * mesh->getFaces().size());
+}
+
+BENCHMARK_DEFINE_F(MeshTriangulationBench, cached)(::benchmark::State &state)
+{
+  geometry::TriangulationCache cache(static_cast<int>(state.range(1)));
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(cache.get(mesh).triangles.data());
+  }
+  state.SetItemsProcessed(state.iterations() * mesh->getFaces().size());
+}
+
+BENCHMARK_REGISTER_F(MeshTriangulationBench, triangulate_mesh)->ArgsProduct({{64, 256}, {1, 0}})->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(MeshTriangulationBench, cached)->ArgsProduct({{256}, {0}});
@@ -0,0 +1,184 @@
+#include <benchmark/benchmark.h>
+#include <math/math.hpp>
+#include <math/matrix.hpp>
+#include <pipeline/pipeline.hpp>
+
+#include <random>
+#include <vector>
+
+/**
+ * @brief The santa_catarina stages of the pipeline unit tests, as std::vector matrices, as dense
+ * Matrix4 and as matrix kinds, with a cloud of random points.
+ *
+ */
+class MatrixBench : public ::benchmark::Fixture
+{
+protected:
+  std::vector<std::vector<double>> sru2src;
+  std::vector<std::vector<double>> projection;
+  std::vector<std::vector<double>> src2srt;
+
+  std::vector<double> px;
+  std::vector<double> py;
+  std::vector<double> pz;
+  std::vector<double> ox;
+  std::vector<double> oy;
+  std::vector<double> oz;
+  std::vector<double> oh;
+
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    Core::Vertex::Vertex vrp = {25, 15, 80};
+    Core::Vertex::Vertex p = {20, 10, 25};
+    sru2src = pipeline::santa_catarina::sru2src(vrp, p);
+    projection = pipeline::santa_catarina::projection(vrp, p, 40);
+    src2srt = pipeline::santa_catarina::src2srt({0, 16, 0, 12}, {0, 319, 0, 239}, true);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinate(-20.0, 20.0);
+
+    px.resize(state.range(0));
+    py.resize(state.range(0));
+    pz.resize(state.range(0));
+    ox.resize(state.range(0));
+    oy.resize(state.range(0));
+    oz.resize(state.range(0));
+    oh.resize(state.range(0));
+    for (size_t i = 0; i < px.size(); i++)
+    {
+      px[i] = coordinate(generator);
+      py[i] = coordinate(generator);
+      pz[i] = coordinate(generator);
+    }
+  }
+};
+
+BENCHMARK_DEFINE_F(MatrixBench, compose_vector)(::benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(Math::multiply_matrix(src2srt, Math::multiply_matrix(projection, sru2src)));
+  }
+}
+
+BENCHMARK_DEFINE_F(MatrixBench, compose_dense)(::benchmark::State &state)
+{
+  Math::Matrix4 s = Math::to_matrix4(src2srt);
+  Math::Matrix4 p = Math::to_matrix4(projection);
+  Math::Matrix4 v = Math::to_matrix4(sru2src);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(s);
+    benchmark::DoNotOptimize(p);
+    benchmark::DoNotOptimize(v);
+    benchmark::DoNotOptimize(Math::multiply(s, Math::multiply(p, v)));
+  }
+}
+
+BENCHMARK_DEFINE_F(MatrixBench, compose_kinds)(::benchmark::State &state)
+{
+  Math::ScaleTranslateMatrix<double> s = Math::to_scale_translate(Math::to_matrix4(src2srt));
+  Math::PerspectiveMatrix<double> p = Math::to_perspective(Math::to_matrix4(projection));
+  Math::AffineMatrix<double> v = Math::to_affine(Math::to_matrix4(sru2src));
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(s);
+    benchmark::DoNotOptimize(p);
+    benchmark::DoNotOptimize(v);
+    benchmark::DoNotOptimize(Math::compose(s, p, v));
+  }
+}
+
+/**
+ * @brief The view stage applied to every point, as a dense matrix and as an affine one. The affine
+ * result always has h = 1, so it is not stored.
+ *
+ */
+BENCHMARK_DEFINE_F(MatrixBench, apply_dense)(::benchmark::State &state)
+{
+  Math::Matrix4 v = Math::to_matrix4(sru2src);
+
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < px.size(); i++)
+    {
+      Math::Point4<double> r = Math::apply(v, Math::Point4<double>{px[i], py[i], pz[i], 1});
+      ox[i] = r.x;
+      oy[i] = r.y;
+      oz[i] = r.z;
+      oh[i] = r.h;
+    }
+    benchmark::DoNotOptimize(ox.data());
+    benchmark::DoNotOptimize(oh.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * px.size());
+}
+
+BENCHMARK_DEFINE_F(MatrixBench, apply_affine)(::benchmark::State &state)
+{
+  Math::AffineMatrix<double> v = Math::to_affine(Math::to_matrix4(sru2src));
+
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < px.size(); i++)
+    {
+      Math::Point4<double> r = Math::apply_point(v, px[i], py[i], pz[i]);
+      ox[i] = r.x;
+      oy[i] = r.y;
+      oz[i] = r.z;
+    }
+    benchmark::DoNotOptimize(ox.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * px.size());
+}
+
+BENCHMARK_REGISTER_F(MatrixBench, compose_vector)->Arg(0);
+BENCHMARK_REGISTER_F(MatrixBench, compose_dense)->Arg(0);
+BENCHMARK_REGISTER_F(MatrixBench, compose_kinds)->Arg(0);
+BENCHMARK_REGISTER_F(MatrixBench, apply_dense)->Arg(1024)->Arg(4096);
+BENCHMARK_REGISTER_F(MatrixBench, apply_affine)->Arg(1024)->Arg(4096);
+
+/**
+ * @brief The view and screen stages applied to a batch, in single and in double precision.
+ *
+ */
+template <typename T>
+static void project_batch(::benchmark::State &state)
+{
+  Core::Vertex::Vertex vrp = {25, 15, 80};
+  Core::Vertex::Vertex p = {20, 10, 25};
+  Math::DenseMatrix<T> view = Math::matrix_cast<T>(Math::multiply(Math::to_matrix4(pipeline::santa_catarina::projection(vrp, p, 40)),
+                                                                  Math::to_matrix4(pipeline::santa_catarina::sru2src(vrp, p))));
+  Math::ScaleTranslateMatrix<T> screen = Math::matrix_cast<T>(Math::to_scale_translate(
+      Math::to_matrix4(pipeline::santa_catarina::src2srt({0, 16, 0, 12}, {0, 1919, 0, 1079}, true))));
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<T> coordinate(-20, 20);
+
+  size_t n = state.range(0);
+  std::vector<T> x(n), y(n), z(n), cx(n), cy(n), cz(n), ch(n), sx(n), sy(n), inv_h(n);
+  for (size_t i = 0; i < n; i++)
+  {
+    x[i] = p.x + coordinate(generator);
+    y[i] = p.y + coordinate(generator);
+    z[i] = p.z + coordinate(generator);
+  }
+
+  for (auto _ : state)
+  {
+    Math::apply_points(view, x.data(), y.data(), z.data(), n, cx.data(), cy.data(), cz.data(), ch.data());
+    Math::divide_points(screen, cx.data(), cy.data(), ch.data(), n, sx.data(), sy.data(), inv_h.data());
+    benchmark::DoNotOptimize(sx.data());
+    benchmark::DoNotOptimize(sy.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(project_batch, float)->Arg(1024)->Arg(16384);
+BENCHMARK_TEMPLATE(project_batch, double)->Arg(1024)->Arg(16384);
@@ -0,0 +1,201 @@
+#include <benchmark/benchmark.h>
+#include <core/camera.hpp>
+#include <core/vector.hpp>
+#include <math/math.hpp>
+#include <pipeline/pipeline.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/**
+ * @brief The camera of the pipeline unit tests, with a cloud of random points in front of it.
+ *
+ * Each benchmark reports, next to its cost, the largest distance (in pixels) between its screen
+ * coordinates and the ones of the staged pipeline.
+ */
+class PipelineBench : public ::benchmark::Fixture
+{
+protected:
+  Core::Vertex::Vertex vrp = {25, 15, 80};
+  Core::Vertex::Vertex p = {20, 10, 25};
+  double d = 40;
+
+  std::vector<double> window = {0, 16, 0, 12};
+  std::vector<double> viewport = {0, 319, 0, 239};
+  int int_window[4] = {0, 16, 0, 12};
+  int int_viewport[4] = {0, 319, 0, 239};
+
+  std::vector<Core::Vertex::Vertex> points;
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> inv_h;
+  std::vector<double> reference_x;
+  std::vector<double> reference_y;
+
+  // Core::Vector objects delete themselves, so the staged path reuses a single one.
+  Core::Vector *scratch = new Core::Vector(0.0, 0.0, 0.0, 1.0, nullptr);
+
+  void project_staged()
+  {
+    std::vector<std::vector<double>> sru2src = pipeline::santa_catarina::sru2src(vrp, p);
+    std::vector<std::vector<double>> proj = pipeline::santa_catarina::projection(vrp, p, d);
+    std::vector<std::vector<double>> src2srt = pipeline::santa_catarina::src2srt(window, viewport, true);
+
+    for (size_t i = 0; i < points.size(); i++)
+    {
+      Core::Vector *v = scratch;
+      v->setX(points[i].x);
+      v->setY(points[i].y);
+      v->setZ(points[i].z);
+      v->setH(1.0);
+
+      Math::apply_matrix(v, sru2src);
+      Math::apply_matrix(v, proj);
+      v->setX(v->getX() / v->getH());
+      v->setY(v->getY() / v->getH());
+      v->setZ(v->getZ() / v->getH());
+      inv_h[i] = 1 / v->getH();
+      v->setH(1.0);
+      Math::apply_matrix(v, src2srt);
+      x[i] = v->getX();
+      y[i] = v->getY();
+    }
+  }
+
+  void report_error(::benchmark::State &state)
+  {
+    double max_error = 0;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+      max_error = std::max(max_error, std::hypot(x[i] - reference_x[i], y[i] - reference_y[i]));
+    }
+    state.counters["max_error_px"] = max_error;
+    state.SetItemsProcessed(state.iterations() * points.size());
+  }
+
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinate(-20.0, 20.0);
+
+    points.resize(state.range(0));
+    for (Core::Vertex::Vertex &v : points)
+    {
+      v = {p.x + coordinate(generator), p.y + coordinate(generator), p.z + coordinate(generator)};
+    }
+
+    x.assign(points.size(), 0.0);
+    y.assign(points.size(), 0.0);
+    inv_h.assign(points.size(), 0.0);
+
+    project_staged();
+    reference_x = x;
+    reference_y = y;
+  }
+};
+
+/**
+ * @brief The stages applied one after the other, as std::vector matrices on Core::Vector objects.
+ *
+ */
+BENCHMARK_DEFINE_F(PipelineBench, staged_vector_matrices)(::benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    project_staged();
+    benchmark::DoNotOptimize(x.data());
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+  report_error(state);
+}
+
+/**
+ * @brief The generic path: the composed 4x4 transform of a pipeline, 16 multiply-adds and a divide.
+ *
+ */
+static void generic_transform(::benchmark::State &state, const Math::Matrix4 &m, const std::vector<Core::Vertex::Vertex> &points,
+                              std::vector<double> &x, std::vector<double> &y, std::vector<double> &inv_h)
+{
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < points.size(); i++)
+    {
+      const Core::Vertex::Vertex &v = points[i];
+      double tx = m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z + m[0][3];
+      double ty = m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z + m[1][3];
+      double tz = m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z + m[2][3];
+      double th = m[3][0] * v.x + m[3][1] * v.y + m[3][2] * v.z + m[3][3];
+      benchmark::DoNotOptimize(tz);
+
+      inv_h[i] = 1 / th;
+      x[i] = tx * inv_h[i];
+      y[i] = ty * inv_h[i];
+    }
+    benchmark::DoNotOptimize(x.data());
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+BENCHMARK_DEFINE_F(PipelineBench, santa_catarina_matrix4)(::benchmark::State &state)
+{
+  Core::Camera camera(vrp, p, d, viewport, window);
+  Math::Matrix4 m = pipeline::get_pipeline(pipeline::PipelineKind::SANTA_CATARINA).transform(camera);
+  generic_transform(state, m, points, x, y, inv_h);
+  report_error(state);
+}
+
+BENCHMARK_DEFINE_F(PipelineBench, madeiras_pereira_matrix4)(::benchmark::State &state)
+{
+  Core::Camera camera(vrp, p, d, viewport, window);
+  Math::Matrix4 m = pipeline::get_pipeline(pipeline::PipelineKind::MADEIRAS_PEREIRA).transform(camera);
+  generic_transform(state, m, points, x, y, inv_h);
+  report_error(state);
+}
+
+/**
+ * @brief The closed form of algebraic_pipeline_sta_catarina: 12 multiply-adds and a divide.
+ *
+ */
+BENCHMARK_DEFINE_F(PipelineBench, santa_catarina_algebraic)(::benchmark::State &state)
+{
+  pipeline::santa_catarina::ScreenProjection s = pipeline::santa_catarina::screen_projection(
+      pipeline::santa_catarina::algebraic_pipeline_sta_catarina(vrp, p, p, d, int_window, int_viewport));
+
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < points.size(); i++)
+    {
+      pipeline::santa_catarina::project_vertex(s, points[i], x[i], y[i], inv_h[i]);
+    }
+    benchmark::DoNotOptimize(x.data());
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+  report_error(state);
+}
+
+/**
+ * @brief The cost of building the matrices, paid once per frame.
+ *
+ */
+BENCHMARK_DEFINE_F(PipelineBench, build_matrices)(::benchmark::State &state)
+{
+  Core::Camera camera(vrp, p, d, viewport, window);
+  const pipeline::Pipeline &stages = pipeline::get_pipeline(static_cast<pipeline::PipelineKind>(state.range(0)));
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(stages.transform(camera));
+  }
+}
+
+BENCHMARK_REGISTER_F(PipelineBench, staged_vector_matrices)->RangeMultiplier(16)->Range(256, 65536);
+BENCHMARK_REGISTER_F(PipelineBench, santa_catarina_matrix4)->RangeMultiplier(16)->Range(256, 65536);
+BENCHMARK_REGISTER_F(PipelineBench, madeiras_pereira_matrix4)->RangeMultiplier(16)->Range(256, 65536);
+BENCHMARK_REGISTER_F(PipelineBench, santa_catarina_algebraic)->RangeMultiplier(16)->Range(256, 65536);
+BENCHMARK_REGISTER_F(PipelineBench, build_matrices)->Arg(0)->Arg(1);
@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include <core/camera.hpp>
+#include <core/mesh.hpp>
+#include <core/scene.hpp>
+#include <core/vector.hpp>
+#include <pipeline/projection.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+/**
+ * @brief A scene of state.range(0) vertexes in front of the camera, split in meshes of
+ * state.range(1) vertexes.
+ *
+ */
+class ProjectionBench : public ::benchmark::Fixture
+{
+protected:
+  Core::Scene *scene = nullptr;
+
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coordinate(-20.0, 20.0);
+
+    scene = new Core::Scene({}, new Core::Camera({25, 15, 80}, {20, 10, 25}, 40, {0, 1919, 0, 1079}, {0, 16, 0, 9}));
+    const size_t total = state.range(0);
+    const size_t per_mesh = state.range(1);
+    for (size_t first = 0; first < total; first += per_mesh)
+    {
+      std::vector<Core::Vector *> vertexes(std::min(per_mesh, total - first));
+      for (Core::Vector *&v : vertexes)
+      {
+        v = new Core::Vector(20 + coordinate(rng), 10 + coordinate(rng), 25 + coordinate(rng), 1.0, nullptr, "v");
+      }
+      scene->addObject(new Core::Mesh(vertexes, {}, "cloud"));
+    }
+  }
+};
+
+BENCHMARK_DEFINE_F(ProjectionBench, project_scene)(::benchmark::State &state)
+{
+  std::vector<pipeline::ProjectedVertexes> projected;
+  for (auto _ : state)
+  {
+    pipeline::project_scene(scene, pipeline::PipelineKind::SANTA_CATARINA, projected);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(ProjectionBench, project_points)(::benchmark::State &state)
+{
+  // The same vertexes already gathered into float arrays: the cost of project_scene without the
+  // reads through the Core::Vector objects.
+  std::vector<float> x, y, z;
+  for (Core::Mesh *mesh : scene->getObjects())
+  {
+    for (Core::Vector *v : mesh->getVertexes())
+    {
+      const Core::Vertex::Vertex p = v->getVertex();
+      x.push_back(static_cast<float>(p.x));
+      y.push_back(static_cast<float>(p.y));
+      z.push_back(static_cast<float>(p.z));
+    }
+  }
+  const Core::Camera &camera = *scene->getCamera();
+  const pipeline::Pipeline &stages = pipeline::get_pipeline(pipeline::PipelineKind::SANTA_CATARINA);
+  const Math::Matrix4 transform = stages.projectionView(camera);
+  const Math::ScaleTranslateMatrix<double> screen = Math::to_scale_translate(stages.screen(camera));
+
+  pipeline::ProjectedVertexes projected;
+  for (auto _ : state)
+  {
+    pipeline::project_points(transform, screen, x.data(), y.data(), z.data(), x.size(), projected);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(ProjectionBench, project_scene)->ArgsProduct({{100000, 1000000}, {1000, 100000}})->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(ProjectionBench, project_points)->ArgsProduct({{100000, 1000000}, {100000}})->Unit(benchmark::kMillisecond);
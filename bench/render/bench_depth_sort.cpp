@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+#include <render/depth_sort.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Depth keys of a million faces, as the painter's algorithm sorts them: positive 1/w
+ * values in a narrow range.
+ *
+ */
+class DepthSortBench : public ::benchmark::Fixture
+{
+protected:
+  std::vector<float> keys;
+  std::vector<uint32_t> order;
+
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> inv_w(1.0f / 200.0f, 1.0f / 50.0f);
+
+    keys.resize(state.range(0));
+    order.resize(state.range(0));
+    for (float &key : keys)
+    {
+      key = inv_w(generator);
+    }
+  }
+};
+
+BENCHMARK_DEFINE_F(DepthSortBench, radix_sort)(::benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    render::radix_sort(keys.data(), keys.size(), order.data(), static_cast<int>(state.range(1)));
+    benchmark::DoNotOptimize(order.data());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK_DEFINE_F(DepthSortBench, std_stable_sort)(::benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                     { return keys[a] < keys[b]; });
+    benchmark::DoNotOptimize(order.data());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK_REGISTER_F(DepthSortBench, radix_sort)->Args({1 << 20, 1})->Args({1 << 20, 0})->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(DepthSortBench, std_stable_sort)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
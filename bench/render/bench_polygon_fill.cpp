@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include <render/framebuffer.hpp>
+#include <render/rasterizer.hpp>
+
+#include <cmath>
+#include <vector>
+
+/**
+ * @brief A regular polygon with state.range(0) vertices and a radius of state.range(1) pixels,
+ * centered in a 512x512 frame buffer, with a different color on each vertex.
+ *
+ */
+class PolygonFillBench : public ::benchmark::Fixture
+{
+protected:
+  render::FrameBuffer fb = render::FrameBuffer(512, 512);
+  std::vector<render::RasterVertex> polygon;
+
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    const int count = static_cast<int>(state.range(0));
+    const float radius = static_cast<float>(state.range(1));
+    polygon.clear();
+    for (int i = 0; i < count; i++)
+    {
+      const float angle = 6.2831853f * i / count + 0.1f;
+      const float t = static_cast<float>(i) / count;
+      polygon.push_back({256.0f + radius * std::cos(angle), 256.0f + radius * std::sin(angle), 1.0f, {t, 1.0f - t, 0.5f}});
+    }
+    fb.clear(0);
+    fb.setDepthTest(false);
+  }
+};
+
+BENCHMARK_DEFINE_F(PolygonFillBench, active_edge_table)(::benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    render::fill_polygon(fb, polygon.data(), nullptr, static_cast<int>(polygon.size()));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(PolygonFillBench, triangle_fan)(::benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    for (size_t i = 1; i + 1 < polygon.size(); i++)
+    {
+      render::fill_triangle(fb, polygon[0], polygon[i], polygon[i + 1]);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(PolygonFillBench, active_edge_table)->ArgsProduct({{4, 8, 32}, {8, 100}});
+BENCHMARK_REGISTER_F(PolygonFillBench, triangle_fan)->ArgsProduct({{4, 8, 32}, {8, 100}});
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <core/common.hpp>
+#include <math/math.hpp>
+
+#include <cstdint>
 #include <vector>
 
 namespace Core
@@ -13,10 +16,22 @@ namespace Core
     double d;
     std::vector<double> view_port;
     std::vector<double> window;
+    // The view up vector, v is its projection onto the plane orthogonal to the view direction
+    Vertex::Vertex up;
+    // The sru2src matrix, kept up to date by move and rotate and rebuilt after setVRP, setP or setUp
+    mutable Math::Matrix4 view;
+    mutable bool view_dirty;
+    // Change whenever the stage of the pipeline they are named after changes, unique among all
+    // cameras but their copies
+    uint64_t view_version;
+    uint64_t projection_version;
+    uint64_t screen_version;
+
+    void updateView() const;
 
   public:
     Camera();
-    Camera(Vertex::Vertex vrp, Vertex::Vertex p, double d, std::vector<double> view_port, std::vector<double> window);
+    Camera(Vertex::Vertex vrp, Vertex::Vertex p, double d, std::vector<double> view_port, std::vector<double> window, Vertex::Vertex up = {0, 1, 0});
     Camera(const Camera &c);
     ~Camera();
 
@@ -25,12 +40,18 @@ namespace Core
     double getD() const;
     std::vector<double> getViewPort() const;
     std::vector<double> getWindow() const;
+    Vertex::Vertex getUp() const;
+    Math::Matrix4 getView() const;
+    uint64_t getViewVersion() const;
+    uint64_t getProjectionVersion() const;
+    uint64_t getScreenVersion() const;
 
     void setVRP(Vertex::Vertex vrp);
     void setP(Vertex::Vertex p);
     void setD(double d);
     void setViewPort(std::vector<double> view_port);
     void setWindow(std::vector<double> window);
+    void setUp(Vertex::Vertex up);
 
     friend std::ostream &operator<<(std::ostream &os, const Camera &c);
 
@@ -6,7 +6,10 @@
 namespace Core
 {
 
-  // Forward declaration of all classes
+  // Forward declaration of all classes.
+  // The destructors of Vector, HalfEdge, Face, Mesh and Scene end with delete this, so deleting one
+  // of them (or one on the stack going out of scope) frees it twice. They are always created with
+  // new and never deleted: the code done with them leaks them.
   class Vector;
   class Face;
   class HalfEdge;
@@ -17,6 +17,8 @@ namespace Core
     HalfEdge *next;
     Face *face;
     std::string id;
+    // A fixed edge (a breakline, an outline) that edge flips must keep
+    bool constrained;
 
   public:
     HalfEdge();
@@ -30,6 +32,7 @@ namespace Core
     HalfEdge *getNext() const;
     Face *getFace() const;
     std::string getId() const;
+    bool isConstrained() const;
 
     void setOrigin(Vector *origin);
     void setTwin(HalfEdge *twin);
@@ -37,6 +40,7 @@ namespace Core
     void setNext(HalfEdge *next);
     void setFace(Face *face);
     void setId(std::string id);
+    void setConstrained(bool constrained);
 
     friend std::ostream &operator<<(std::ostream &os, const HalfEdge &he);
     HalfEdge &operator=(const HalfEdge &he);
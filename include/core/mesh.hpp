@@ -2,8 +2,16 @@
 
 #include <core/common.hpp>
 
+#include <cstdint>
+
 namespace Core
 {
+  // A simplified version of a mesh, and the size of the details it lost, in the units of the mesh
+  typedef struct
+  {
+    Mesh *mesh;
+    double error;
+  } MeshLod;
 
   class Mesh
   {
@@ -18,6 +26,10 @@ namespace Core
     int num_faces;
     // The id of the object
     std::string id;
+    // Changes whenever the half-edges or the faces are replaced, unique among all meshes
+    uint64_t topology_version;
+    // The levels of detail of the object, from the finest to the coarsest
+    std::vector<MeshLod> lods;
 
   public:
     Mesh();
@@ -25,17 +37,21 @@ namespace Core
     Mesh(const Mesh &o);
     ~Mesh();
 
-    std::vector<Vector *> getVertexes() const;
+    const std::vector<Vector *> &getVertexes() const;
     std::vector<HalfEdge *> getMesh() const;
     std::vector<Face *> getFaces() const;
     int getNumFaces() const;
     std::string getId() const;
+    uint64_t getTopologyVersion() const;
+    const std::vector<MeshLod> &getLods() const;
 
     void setVertexes(std::vector<Vector *> vertexes);
     void setMesh(std::vector<HalfEdge *> mesh);
     void setFaces(std::vector<Face *> faces);
     void setNumFaces(int num_faces);
     void setId(std::string id);
+    void setLods(std::vector<MeshLod> lods);
+    void updateTopologyVersion();
 
     Mesh &operator=(const Mesh &o);
 
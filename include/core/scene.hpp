@@ -1,16 +1,41 @@
 #pragma once
 
 #include <core/common.hpp>
+#include <math/math.hpp>
+
+#include <cstdint>
 #include <vector>
 
 namespace Core
 {
+  // An entry of the scene graph: a mesh, or a group when it has none, placed by its model matrix
+  // relative to its parent
+  typedef struct
+  {
+    Mesh *mesh;
+    // The index of the parent node, -1 for a root. Parents always come before their children.
+    int parent;
+    // An affine matrix
+    Math::Matrix4 local;
+  } SceneNode;
+
   class Scene
   {
   private:
+    // The meshes of the nodes, in the order of the nodes, and the node of each one. A mesh placed
+    // by several nodes is shared by them, it appears once per node.
     std::vector<Mesh *> objects;
+    std::vector<int> object_nodes;
+    // The scene graph, flat and sorted so the world matrices are updated in a single pass
+    std::vector<SceneNode> nodes;
+    mutable std::vector<Math::Matrix4> world;
+    mutable bool world_dirty;
+    uint64_t transform_version;
     Core::Camera *camera;
 
+    void updateObjects();
+    void updateTransformVersion();
+
   public:
     Scene();
     Scene(std::vector<Mesh *> objects, Core::Camera *camera);
@@ -19,14 +44,24 @@ namespace Core
 
     std::vector<Mesh *> getObjects() const;
     Core::Camera *getCamera() const;
+    const std::vector<SceneNode> &getNodes() const;
+    Math::Matrix4 getLocalTransform(int node) const;
+    const Math::Matrix4 &getWorldTransform(int node) const;
+    std::vector<Math::Matrix4> getObjectTransforms() const;
+    uint64_t getTransformVersion() const;
 
     void setObjects(std::vector<Mesh *> objects);
+    void setObjects(std::vector<Mesh *> objects, std::vector<Math::Matrix4> transforms);
     void setCamera(Core::Camera *camera);
+    void setLocalTransform(int node, const Math::Matrix4 &local);
 
     Scene &operator=(const Scene &o);
 
     void addObject(Mesh *object);
+    int addInstance(Mesh *mesh, const Math::Matrix4 &model);
+    int addNode(Mesh *mesh, int parent, const Math::Matrix4 &local);
     void removeObject(Mesh *object);
+    void updateWorldTransforms() const;
 
     void moveCamera(Vector *direction);
     void rotateCamera(Vector *direction);
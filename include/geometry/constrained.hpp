@@ -0,0 +1,14 @@
+#pragma once
+
+#include <core/common.hpp>
+#include <geometry/geometry.hpp>
+
+#include <string>
+#include <vector>
+
+namespace geometry
+{
+  bool insert_constraint(Core::Mesh *mesh, Core::Vector *from, Core::Vector *to);
+  size_t insert_constraints(Core::Mesh *mesh, const std::vector<Segment> &segments);
+  Core::Mesh *constrained_delaunay_mesh(const std::vector<Core::Vertex::Vertex> &points, const std::vector<Segment> &segments, std::string id, int threads = 0);
+} // namespace geometry
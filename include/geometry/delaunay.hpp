@@ -0,0 +1,30 @@
+#pragma once
+
+#include <core/common.hpp>
+#include <geometry/geometry.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace geometry
+{
+  // Below this many points a mesh is triangulated in a single block
+  const size_t PARALLEL_DELAUNAY_MIN_POINTS = 1 << 16;
+
+  // A Delaunay triangulation, as flat arrays so large point sets don't need a Core::Mesh
+  typedef struct
+  {
+    // Counterclockwise triangles, as indices into the points
+    std::vector<Triangle> triangles;
+    // neighbours[3 * t + i] is the triangle across the edge opposite to corner i of the triangle
+    // t (a, b, c for i = 0, 1, 2), -1 for the edges of the convex hull
+    std::vector<int> neighbours;
+  } DelaunayTriangulation;
+
+  void sort_hilbert(const Point2 *points, size_t count, std::vector<uint32_t> &order);
+  void sort_brio(const Point2 *points, size_t count, std::vector<uint32_t> &order);
+  void delaunay(const Point2 *points, size_t count, DelaunayTriangulation &triangulation);
+  void delaunay_parallel(const Point2 *points, size_t count, DelaunayTriangulation &triangulation, int threads = 0);
+  Core::Mesh *delaunay_mesh(const std::vector<Core::Vertex::Vertex> &points, std::string id, int threads = 0);
+} // namespace geometry
@@ -0,0 +1,35 @@
+#pragma once
+
+namespace geometry
+{
+  // A point of the plane a polygon is projected to
+  typedef struct
+  {
+    double x;
+    double y;
+  } Point2;
+
+  // A triangle, as three indices into the points (or the loop) it was built from
+  typedef struct
+  {
+    int a;
+    int b;
+    int c;
+  } Triangle;
+
+  // A segment, as two indices into the points it was built from
+  typedef struct
+  {
+    int a;
+    int b;
+  } Segment;
+
+  /**
+   * @brief Twice the signed area of the triangle (a, b, c), positive if it turns counterclockwise.
+   *
+   */
+  inline double orient(const Point2 &a, const Point2 &b, const Point2 &c)
+  {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+  }
+} // namespace geometry
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <core/common.hpp>
+
+#include <string>
+#include <vector>
+
+namespace geometry
+{
+  std::vector<Core::Vertex::Vertex> read_xyz(const std::string &path);
+  bool write_obj(const Core::Mesh *mesh, const std::string &path);
+  Core::Mesh *read_xyz_delaunay(const std::string &path, std::string id);
+} // namespace geometry
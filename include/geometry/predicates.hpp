@@ -0,0 +1,9 @@
+#pragma once
+
+#include <geometry/geometry.hpp>
+
+namespace geometry
+{
+  double orient2d(const Point2 &a, const Point2 &b, const Point2 &c);
+  double incircle(const Point2 &a, const Point2 &b, const Point2 &c, const Point2 &d);
+} // namespace geometry
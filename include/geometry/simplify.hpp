@@ -0,0 +1,19 @@
+#pragma once
+
+#include <core/common.hpp>
+#include <core/mesh.hpp>
+
+#include <string>
+#include <vector>
+
+namespace geometry
+{
+  // Cells across the largest side of the bounding box of a mesh for its finest level of detail,
+  // each coarser level halves them
+  const int LOD_FINEST_CELLS = 64;
+  // A level is kept only if it has at most this fraction of the vertexes of the level before
+  const double LOD_MIN_REDUCTION = 0.75;
+
+  Core::Mesh *simplify_mesh(const Core::Mesh *mesh, double cell, std::string id);
+  std::vector<Core::MeshLod> build_lods(const Core::Mesh *mesh, int levels);
+} // namespace geometry
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <core/common.hpp>
+#include <geometry/geometry.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace geometry
+{
+  // Polygons with more vertices are triangulated by monotone decomposition instead of ear clipping
+  const int EAR_CLIPPING_MAX_VERTICES = 128;
+  // Below this many faces a mesh is triangulated on the calling thread only
+  const size_t PARALLEL_TRIANGULATION_MIN_FACES = 4096;
+
+  // The triangles of all the faces of a mesh, the corners are indices into the half-edge loops
+  typedef struct
+  {
+    // The triangles of face f are triangles[offsets[f], offsets[f + 1])
+    std::vector<uint32_t> offsets;
+    std::vector<Triangle> triangles;
+    // The topology version of the mesh they were computed for
+    uint64_t topology_version;
+  } MeshTriangulation;
+
+  bool ear_clipping(const Point2 *points, int count, Triangle *triangles);
+  bool monotone_triangulation(const Point2 *points, int count, Triangle *triangles);
+  void triangulate_polygon(const Point2 *points, int count, Triangle *triangles);
+  void project_face(const Core::Face *face, std::vector<Point2> &points);
+  void triangulate_mesh(const Core::Mesh *mesh, MeshTriangulation &triangulation, int threads = 0);
+
+  /**
+   * @brief TriangulationCache class - The triangulations of meshes, computed when first needed and
+   * again only after the topology of their mesh changed.
+   *
+   */
+  class TriangulationCache
+  {
+  private:
+    std::unordered_map<const Core::Mesh *, MeshTriangulation> meshes;
+    int threads;
+
+  public:
+    TriangulationCache();
+    TriangulationCache(int threads);
+    TriangulationCache(const TriangulationCache &c);
+    ~TriangulationCache();
+
+    int getThreads() const;
+    void setThreads(int threads);
+
+    const MeshTriangulation &get(const Core::Mesh *mesh);
+    void erase(const Core::Mesh *mesh);
+    void clear();
+
+    TriangulationCache &operator=(const TriangulationCache &c);
+  };
+} // namespace geometry
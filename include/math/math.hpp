@@ -1,12 +1,17 @@
 #pragma once
 
 #include <core/vector.hpp>
+#include <array>
+#include <bit>
 #include <cmath>
+#include <cstdint>
 
 #include <vector>
 
 namespace Math
 {
+  // A fixed size 4x4 matrix, row major. Unlike std::vector<std::vector<double>> it lives on the stack.
+  typedef std::array<std::array<double, 4>, 4> Matrix4;
 
   double angle(Core::Vector *v1, Core::Vector *v2);
   double angle(Core::Vertex::Vertex v1, Core::Vertex::Vertex v2);
@@ -23,9 +28,103 @@ namespace Math
   Core::Vertex::Vertex normalize(Core::Vertex::Vertex v);
   Core::Vector *cross(Core::Vector *v1, Core::Vector *v2);
   Core::Vertex::Vertex cross(Core::Vertex::Vertex v1, Core::Vertex::Vertex v2);
+  Core::Vertex::Vertex newell_normal(const std::vector<Core::Vertex::Vertex> &polygon);
+
+  Core::Vertex::Vertex fast_normalize(Core::Vertex::Vertex v);
+
+  /**
+   * @brief Approximation of 1/sqrt(x), with a relative error below 0.001%.
+   *
+   * It is defined in the header so the per-pixel loops that call it can be vectorized.
+   *
+   * @param x A positive number.
+   * @return float An approximation of 1/sqrt(x).
+   */
+  inline float fast_rsqrt(float x)
+  {
+    float y = std::bit_cast<float>(0x5f3759df - (std::bit_cast<uint32_t>(x) >> 1));
+    // Two Newton-Raphson iterations, one alone leaves visible banding in specular highlights.
+    y = y * (1.5f - 0.5f * x * y * y);
+    return y * (1.5f - 0.5f * x * y * y);
+  }
+
+  /**
+   * @brief c ? a : b, written with bit masks. With a plain select of a constant the compiler may
+   * branch to the constant result of the lanes that pick it, which keeps the loops scalar.
+   *
+   */
+  inline float mask_select(bool c, float a, float b)
+  {
+    const uint32_t mask = 0u - static_cast<uint32_t>(c);
+    return std::bit_cast<float>((std::bit_cast<uint32_t>(a) & mask) | (std::bit_cast<uint32_t>(b) & ~mask));
+  }
+
+  /**
+   * @brief Approximation of log2(x), with an absolute error below 1e-6.
+   *
+   * The exponent is read from the bits of x and the logarithm of the mantissa, brought to
+   * [sqrt(1/2), sqrt(2)), is an odd series in (m - 1) / (m + 1). It has no branches, so the loops
+   * that call it can be vectorized.
+   *
+   * @param x A positive, normal number.
+   * @return float An approximation of log2(x).
+   */
+  inline float fast_log2(float x)
+  {
+    const uint32_t bits = std::bit_cast<uint32_t>(x);
+    // Subtracting the bits of sqrt(1/2) moves the mantissas above sqrt(2) to the next exponent.
+    const int32_t offset = static_cast<int32_t>(bits - 0x3f3504f3u);
+    const int32_t exponent = offset >> 23;
+    const float m = std::bit_cast<float>(bits - (static_cast<uint32_t>(exponent) << 23));
+
+    const float t = (m - 1.0f) / (m + 1.0f);
+    const float t2 = t * t;
+    const float series = t * (2.0f + t2 * (2.0f / 3.0f + t2 * (2.0f / 5.0f + t2 * (2.0f / 7.0f))));
+    return static_cast<float>(exponent) + series * 1.44269504f;
+  }
+
+  /**
+   * @brief Approximation of 2^x, with a relative error below 1e-6.
+   *
+   * x is split in its nearest integer, which goes to the exponent bits, and a fraction in
+   * [-0.5, 0.5], whose power is a Taylor polynomial. It has no branches, so the loops that call
+   * it can be vectorized.
+   *
+   * @param x The exponent, at most 127. Below -126 it is taken as -126.
+   * @return float An approximation of 2^x.
+   */
+  inline float fast_exp2(float x)
+  {
+    x = mask_select(x < -126.0f, -126.0f, x);
+
+    // x + 127.5 is positive, so the conversion rounds it down and i is the nearest integer to x.
+    const int32_t i = static_cast<int32_t>(x + 127.5f) - 127;
+    const float f = (x - static_cast<float>(i)) * 0.693147181f;
+    const float p = 1.0f + f * (1.0f + f * (0.5f + f * (1.0f / 6.0f + f * (1.0f / 24.0f + f * (1.0f / 120.0f + f * (1.0f / 720.0f))))));
+    return p * std::bit_cast<float>(static_cast<uint32_t>(i + 127) << 23);
+  }
+
+  /**
+   * @brief Approximation of x^y for x in [0, 1], as 2^(y log2(x)), for specular highlights.
+   *
+   * @param x The base, 0 gives 0.
+   * @param y A positive exponent.
+   * @return float An approximation of x^y.
+   */
+  inline float fast_pow(float x, float y)
+  {
+    const float p = fast_exp2(y * fast_log2(mask_select(x < 1e-30f, 1e-30f, x)));
+    return mask_select(x > 0.0f, p, 0.0f);
+  }
 
   std::vector<std::vector<double>> multiply_matrix(std::vector<std::vector<double>> m1, std::vector<std::vector<double>> m2);
 
   void apply_matrix(Core::Vector *v, std::vector<std::vector<double>> m);
 
+  Matrix4 identity_matrix();
+  Matrix4 to_matrix4(const std::vector<std::vector<double>> &m);
+  std::vector<std::vector<double>> to_matrix(const Matrix4 &m);
+  Matrix4 multiply_matrix(const Matrix4 &m1, const Matrix4 &m2);
+  void apply_matrix(Core::Vector *v, const Matrix4 &m);
+
 } // namespace Math
\ No newline at end of file
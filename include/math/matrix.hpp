@@ -0,0 +1,394 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace Math
+{
+  /**
+   * @brief Matrix kinds - 4x4 matrices that only store their non-trivial entries.
+   *
+   * Most pipeline matrices have a known shape: sru2src is a rigid motion, projection only touches
+   * z and h, and src2srt is a scale plus a translation. The kind of a product is known at compile
+   * time from the kinds of its factors, so each overload of multiply and apply only computes the
+   * terms that can be non-zero. Everything is constexpr and templated on the scalar type.
+   */
+
+  // A point in homogeneous coordinates
+  template <typename T>
+  struct Point4
+  {
+    T x;
+    T y;
+    T z;
+    T h;
+  };
+
+  // | s[0], 0, 0, t[0] |
+  // | 0, s[1], 0, t[1] |
+  // | 0, 0, s[2], t[2] |
+  // | 0, 0, 0, 1 |
+  template <typename T>
+  struct ScaleTranslateMatrix
+  {
+    T s[3];
+    T t[3];
+  };
+
+  // The first three rows are stored, the last one is (0, 0, 0, 1)
+  template <typename T>
+  struct AffineMatrix
+  {
+    T m[3][4];
+  };
+
+  // | 1, 0, 0, 0 |
+  // | 0, 1, 0, 0 |
+  // | 0, 0, a, b |
+  // | 0, 0, c, e |
+  template <typename T>
+  struct PerspectiveMatrix
+  {
+    T a;
+    T b;
+    T c;
+    T e;
+  };
+
+  // Any 4x4 matrix, DenseMatrix<double> is the same type as Math::Matrix4
+  template <typename T>
+  using DenseMatrix = std::array<std::array<T, 4>, 4>;
+
+  // Conversions to a dense matrix
+
+  template <typename T>
+  constexpr DenseMatrix<T> to_dense(const DenseMatrix<T> &m)
+  {
+    return m;
+  }
+
+  template <typename T>
+  constexpr DenseMatrix<T> to_dense(const ScaleTranslateMatrix<T> &m)
+  {
+    return {{{m.s[0], 0, 0, m.t[0]}, {0, m.s[1], 0, m.t[1]}, {0, 0, m.s[2], m.t[2]}, {0, 0, 0, 1}}};
+  }
+
+  template <typename T>
+  constexpr DenseMatrix<T> to_dense(const AffineMatrix<T> &m)
+  {
+    return {{{m.m[0][0], m.m[0][1], m.m[0][2], m.m[0][3]},
+             {m.m[1][0], m.m[1][1], m.m[1][2], m.m[1][3]},
+             {m.m[2][0], m.m[2][1], m.m[2][2], m.m[2][3]},
+             {0, 0, 0, 1}}};
+  }
+
+  template <typename T>
+  constexpr DenseMatrix<T> to_dense(const PerspectiveMatrix<T> &m)
+  {
+    return {{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, m.a, m.b}, {0, 0, m.c, m.e}}};
+  }
+
+  // Conversions from a dense matrix, they read the entries of the kind and ignore the others
+
+  template <typename T>
+  constexpr ScaleTranslateMatrix<T> to_scale_translate(const DenseMatrix<T> &m)
+  {
+    return {{m[0][0], m[1][1], m[2][2]}, {m[0][3], m[1][3], m[2][3]}};
+  }
+
+  template <typename T>
+  constexpr AffineMatrix<T> to_affine(const DenseMatrix<T> &m)
+  {
+    return {{{m[0][0], m[0][1], m[0][2], m[0][3]},
+             {m[1][0], m[1][1], m[1][2], m[1][3]},
+             {m[2][0], m[2][1], m[2][2], m[2][3]}}};
+  }
+
+  template <typename T>
+  constexpr PerspectiveMatrix<T> to_perspective(const DenseMatrix<T> &m)
+  {
+    return {m[2][2], m[2][3], m[3][2], m[3][3]};
+  }
+
+  // Products, the most specialized overload is picked at compile time
+
+  template <typename T>
+  constexpr DenseMatrix<T> multiply(const DenseMatrix<T> &m1, const DenseMatrix<T> &m2)
+  {
+    DenseMatrix<T> result = {};
+    for (int i = 0; i < 4; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        result[i][j] = m1[i][0] * m2[0][j] + m1[i][1] * m2[1][j] + m1[i][2] * m2[2][j] + m1[i][3] * m2[3][j];
+      }
+    }
+    return result;
+  }
+
+  // Fallback for the pairs of kinds without a specialized product
+  template <typename A, typename B>
+  constexpr auto multiply(const A &m1, const B &m2)
+  {
+    return multiply(to_dense(m1), to_dense(m2));
+  }
+
+  template <typename T>
+  constexpr ScaleTranslateMatrix<T> multiply(const ScaleTranslateMatrix<T> &m1, const ScaleTranslateMatrix<T> &m2)
+  {
+    ScaleTranslateMatrix<T> result = {};
+    for (int i = 0; i < 3; i++)
+    {
+      result.s[i] = m1.s[i] * m2.s[i];
+      result.t[i] = m1.s[i] * m2.t[i] + m1.t[i];
+    }
+    return result;
+  }
+
+  template <typename T>
+  constexpr AffineMatrix<T> multiply(const ScaleTranslateMatrix<T> &m1, const AffineMatrix<T> &m2)
+  {
+    AffineMatrix<T> result = {};
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        result.m[i][j] = m1.s[i] * m2.m[i][j];
+      }
+      result.m[i][3] += m1.t[i];
+    }
+    return result;
+  }
+
+  template <typename T>
+  constexpr AffineMatrix<T> multiply(const AffineMatrix<T> &m1, const ScaleTranslateMatrix<T> &m2)
+  {
+    AffineMatrix<T> result = {};
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        result.m[i][j] = m1.m[i][j] * m2.s[j];
+      }
+      result.m[i][3] = m1.m[i][0] * m2.t[0] + m1.m[i][1] * m2.t[1] + m1.m[i][2] * m2.t[2] + m1.m[i][3];
+    }
+    return result;
+  }
+
+  template <typename T>
+  constexpr AffineMatrix<T> multiply(const AffineMatrix<T> &m1, const AffineMatrix<T> &m2)
+  {
+    AffineMatrix<T> result = {};
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        result.m[i][j] = m1.m[i][0] * m2.m[0][j] + m1.m[i][1] * m2.m[1][j] + m1.m[i][2] * m2.m[2][j];
+      }
+      result.m[i][3] += m1.m[i][3];
+    }
+    return result;
+  }
+
+  // The x and y rows are copied, z and h are combinations of the z row and (0, 0, 0, 1)
+  template <typename T>
+  constexpr DenseMatrix<T> multiply(const PerspectiveMatrix<T> &m1, const AffineMatrix<T> &m2)
+  {
+    DenseMatrix<T> result = {};
+    for (int j = 0; j < 4; j++)
+    {
+      result[0][j] = m2.m[0][j];
+      result[1][j] = m2.m[1][j];
+      result[2][j] = m1.a * m2.m[2][j];
+      result[3][j] = m1.c * m2.m[2][j];
+    }
+    result[2][3] += m1.b;
+    result[3][3] += m1.e;
+    return result;
+  }
+
+  // Each row is scaled and the translation is added times the h row
+  template <typename T>
+  constexpr DenseMatrix<T> multiply(const ScaleTranslateMatrix<T> &m1, const DenseMatrix<T> &m2)
+  {
+    DenseMatrix<T> result = {};
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        result[i][j] = m1.s[i] * m2[i][j] + m1.t[i] * m2[3][j];
+      }
+    }
+    result[3] = m2[3];
+    return result;
+  }
+
+  // The columns are scaled and the translation is folded into the last one, it moves the origin the
+  // points of a dense transform are given from
+  template <typename T>
+  constexpr DenseMatrix<T> multiply(const DenseMatrix<T> &m1, const ScaleTranslateMatrix<T> &m2)
+  {
+    DenseMatrix<T> result = {};
+    for (int i = 0; i < 4; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        result[i][j] = m1[i][j] * m2.s[j];
+      }
+      result[i][3] = m1[i][0] * m2.t[0] + m1[i][1] * m2.t[1] + m1[i][2] * m2.t[2] + m1[i][3];
+    }
+    return result;
+  }
+
+  /**
+   * @brief Multiply any number of matrices, from right to left (in the order the stages are applied),
+   * each step with the most specialized product.
+   *
+   */
+  template <typename A, typename B, typename... Rest>
+  constexpr auto compose(const A &m1, const B &m2, const Rest &...rest)
+  {
+    if constexpr (sizeof...(rest) == 0)
+    {
+      return multiply(m1, m2);
+    }
+    else
+    {
+      return multiply(m1, compose(m2, rest...));
+    }
+  }
+
+  // Applications to a point, they skip the terms known to be zero
+
+  template <typename T>
+  constexpr Point4<T> apply(const DenseMatrix<T> &m, const Point4<T> &p)
+  {
+    return {m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3] * p.h,
+            m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3] * p.h,
+            m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3] * p.h,
+            m[3][0] * p.x + m[3][1] * p.y + m[3][2] * p.z + m[3][3] * p.h};
+  }
+
+  template <typename T>
+  constexpr Point4<T> apply(const ScaleTranslateMatrix<T> &m, const Point4<T> &p)
+  {
+    return {m.s[0] * p.x + m.t[0] * p.h, m.s[1] * p.y + m.t[1] * p.h, m.s[2] * p.z + m.t[2] * p.h, p.h};
+  }
+
+  template <typename T>
+  constexpr Point4<T> apply(const AffineMatrix<T> &m, const Point4<T> &p)
+  {
+    return {m.m[0][0] * p.x + m.m[0][1] * p.y + m.m[0][2] * p.z + m.m[0][3] * p.h,
+            m.m[1][0] * p.x + m.m[1][1] * p.y + m.m[1][2] * p.z + m.m[1][3] * p.h,
+            m.m[2][0] * p.x + m.m[2][1] * p.y + m.m[2][2] * p.z + m.m[2][3] * p.h,
+            p.h};
+  }
+
+  template <typename T>
+  constexpr Point4<T> apply(const PerspectiveMatrix<T> &m, const Point4<T> &p)
+  {
+    return {p.x, p.y, m.a * p.z + m.b * p.h, m.c * p.z + m.e * p.h};
+  }
+
+  // Applications to a point with h = 1, the translation is added instead of multiplied
+
+  template <typename T>
+  constexpr Point4<T> apply_point(const DenseMatrix<T> &m, T x, T y, T z)
+  {
+    return {m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3],
+            m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3],
+            m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3],
+            m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3]};
+  }
+
+  template <typename T>
+  constexpr Point4<T> apply_point(const ScaleTranslateMatrix<T> &m, T x, T y, T z)
+  {
+    return {m.s[0] * x + m.t[0], m.s[1] * y + m.t[1], m.s[2] * z + m.t[2], 1};
+  }
+
+  template <typename T>
+  constexpr Point4<T> apply_point(const AffineMatrix<T> &m, T x, T y, T z)
+  {
+    return {m.m[0][0] * x + m.m[0][1] * y + m.m[0][2] * z + m.m[0][3],
+            m.m[1][0] * x + m.m[1][1] * y + m.m[1][2] * z + m.m[1][3],
+            m.m[2][0] * x + m.m[2][1] * y + m.m[2][2] * z + m.m[2][3],
+            1};
+  }
+
+  template <typename T>
+  constexpr Point4<T> apply_point(const PerspectiveMatrix<T> &m, T x, T y, T z)
+  {
+    return {x, y, m.a * z + m.b, m.c * z + m.e};
+  }
+
+  // Conversions between scalar types, compose in double and convert once to run the kernels in float
+
+  template <typename U, typename T>
+  constexpr DenseMatrix<U> matrix_cast(const DenseMatrix<T> &m)
+  {
+    DenseMatrix<U> result = {};
+    for (int i = 0; i < 4; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        result[i][j] = static_cast<U>(m[i][j]);
+      }
+    }
+    return result;
+  }
+
+  template <typename U, typename T>
+  constexpr ScaleTranslateMatrix<U> matrix_cast(const ScaleTranslateMatrix<T> &m)
+  {
+    return {{static_cast<U>(m.s[0]), static_cast<U>(m.s[1]), static_cast<U>(m.s[2])},
+            {static_cast<U>(m.t[0]), static_cast<U>(m.t[1]), static_cast<U>(m.t[2])}};
+  }
+
+  /**
+   * @brief Apply a matrix to a batch of points with h = 1, stored as a structure of arrays.
+   *
+   * The loop has no branches, so it is vectorized: with T = float each instruction handles twice as
+   * many points as with double.
+   *
+   * @param m The matrix.
+   * @param x, y, z The coordinates of the n points.
+   * @param n The number of points.
+   * @param out_x, out_y, out_z, out_h The transformed points, they must not overlap the inputs.
+   */
+  template <typename T>
+  void apply_points(const DenseMatrix<T> &m, const T *x, const T *y, const T *z, size_t n, T *out_x, T *out_y, T *out_z, T *out_h)
+  {
+    const DenseMatrix<T> c = m;
+    for (size_t i = 0; i < n; i++)
+    {
+      out_x[i] = c[0][0] * x[i] + c[0][1] * y[i] + c[0][2] * z[i] + c[0][3];
+      out_y[i] = c[1][0] * x[i] + c[1][1] * y[i] + c[1][2] * z[i] + c[1][3];
+      out_z[i] = c[2][0] * x[i] + c[2][1] * y[i] + c[2][2] * z[i] + c[2][3];
+      out_h[i] = c[3][0] * x[i] + c[3][1] * y[i] + c[3][2] * z[i] + c[3][3];
+    }
+  }
+
+  /**
+   * @brief Divide a batch of points by h and map them to the screen with a scale and a translation.
+   *
+   * @param m The screen stage.
+   * @param x, y, h The homogeneous coordinates of the n points. The ones with h = 0 end up at infinity,
+   * they must be clipped before they are used.
+   * @param n The number of points.
+   * @param screen_x, screen_y The screen coordinates.
+   * @param inv_h 1 / h of each point.
+   */
+  template <typename T>
+  void divide_points(const ScaleTranslateMatrix<T> &m, const T *x, const T *y, const T *h, size_t n, T *screen_x, T *screen_y, T *inv_h)
+  {
+    const ScaleTranslateMatrix<T> c = m;
+    for (size_t i = 0; i < n; i++)
+    {
+      T w = T(1) / h[i];
+      screen_x[i] = c.s[0] * (x[i] * w) + c.t[0];
+      screen_y[i] = c.s[1] * (y[i] * w) + c.t[1];
+      inv_h[i] = w;
+    }
+  }
+} // namespace Math
\ No newline at end of file
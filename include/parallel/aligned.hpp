@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace parallel
+{
+  // The size of a cache line, the unit two cores fight over when they write next to each other
+  const size_t CACHE_LINE = 64;
+
+  /**
+   * @brief CacheAlignedAllocator - Allocates arrays on a cache line boundary.
+   *
+   * When the threads write ranges of an array that start at multiples of CACHE_LINE bytes, no line
+   * is shared by two of them, so the writes don't bounce lines between the cores (false sharing).
+   */
+  template <typename T>
+  struct CacheAlignedAllocator
+  {
+    typedef T value_type;
+
+    CacheAlignedAllocator() = default;
+
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U> &)
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+      return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(CACHE_LINE)));
+    }
+
+    void deallocate(T *p, size_t)
+    {
+      ::operator delete(p, std::align_val_t(CACHE_LINE));
+    }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U> &) const
+    {
+      return true;
+    }
+  };
+} // namespace parallel
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel
+{
+  class Scheduler;
+
+  // What the profiling hook is told about each task once it has run
+  typedef struct
+  {
+    const char *name;
+    // The worker that ran it, -1 for a thread of the application waiting for its group
+    int worker;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+  } TaskProfile;
+
+  typedef std::function<void(const TaskProfile &)> ProfileHook;
+
+  /**
+   * @brief TaskGroup class - The tasks forked by a thread, joined by wait.
+   *
+   * The thread waiting for a group runs queued tasks meanwhile, so a task can fork and wait for
+   * tasks of its own without blocking a worker. Tasks must not throw.
+   */
+  class TaskGroup
+  {
+  private:
+    Scheduler *scheduler;
+    std::atomic<size_t> pending;
+
+    friend class Scheduler;
+
+  public:
+    TaskGroup();
+    TaskGroup(Scheduler *scheduler);
+    TaskGroup(const TaskGroup &g) = delete;
+    ~TaskGroup();
+
+    TaskGroup &operator=(const TaskGroup &g) = delete;
+
+    void run(std::function<void()> task, const char *name = "task");
+    void wait();
+  };
+
+  // A queued task and the group waiting for it
+  typedef struct
+  {
+    std::function<void()> function;
+    TaskGroup *group;
+    const char *name;
+  } Task;
+
+  // The tasks of one thread: it pushes and pops at the back, the others steal at the front
+  typedef struct
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  } TaskQueue;
+
+  /**
+   * @brief Scheduler class - A work-stealing thread pool shared by the parallel parts of the editor.
+   *
+   * Each worker has a queue of its own: it runs the tasks it forked last first, while they are
+   * still in its cache, and an idle worker steals the oldest task of another queue, which is
+   * usually the largest part of a split range. The threads of the application fork into a queue
+   * shared by all of them and help run the tasks while they wait for their group, so the pool
+   * has one worker less than the hardware threads and all parts together never run more threads
+   * than there are cores.
+   */
+  class Scheduler
+  {
+  private:
+    // One queue per worker, then the one of the threads of the application
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping;
+    ProfileHook profile_hook;
+    std::atomic<bool> profiling;
+
+    int ownQueue() const;
+    bool findTask(Task &task);
+    void execute(Task &task);
+    void work(int index);
+
+  public:
+    Scheduler();
+    Scheduler(int threads);
+    Scheduler(const Scheduler &s) = delete;
+    ~Scheduler();
+
+    static Scheduler &instance();
+
+    int getThreads() const;
+    int getWorkerIndex() const;
+
+    void setProfileHook(ProfileHook hook);
+
+    Scheduler &operator=(const Scheduler &s) = delete;
+
+    void spawn(TaskGroup *group, std::function<void()> function, const char *name);
+    bool runTask();
+  };
+
+  /**
+   * @brief Run a function on [begin, end), split in halves down to ranges of grain indices which
+   * the workers steal from each other.
+   *
+   * @param begin The first index.
+   * @param end The index after the last one.
+   * @param grain The largest range given to the function, large enough to pay for a task.
+   * @param function Called with the begin and end of each range.
+   * @param name The name of the tasks, for the profiling hook.
+   * @param scheduler The scheduler, the shared one by default.
+   */
+  template <typename Function>
+  void parallel_for(size_t begin, size_t end, size_t grain, const Function &function, const char *name = "parallel_for",
+                    Scheduler &scheduler = Scheduler::instance())
+  {
+    grain = grain == 0 ? 1 : grain;
+    if (end - begin <= grain || scheduler.getThreads() == 1)
+    {
+      function(begin, end);
+      return;
+    }
+
+    TaskGroup group(&scheduler);
+    while (end - begin > grain)
+    {
+      const size_t middle = begin + (end - begin) / 2;
+      group.run([middle, end, grain, &function, name, &scheduler]
+                { parallel_for(middle, end, grain, function, name, scheduler); },
+                name);
+      end = middle;
+    }
+    function(begin, end);
+    group.wait();
+  }
+
+  /**
+   * @brief Run a function on a fixed number of contiguous chunks of [0, size), as tasks of the
+   * scheduler. For the algorithms that keep state per chunk, like the histograms of a radix sort.
+   *
+   * @param size The number of indices.
+   * @param chunks The number of chunks, the calling thread runs the first one.
+   * @param function Called with the chunk and the begin and end of its range.
+   * @param name The name of the tasks, for the profiling hook.
+   * @param scheduler The scheduler, the shared one by default.
+   */
+  template <typename Function>
+  void for_each_chunk(size_t size, int chunks, const Function &function, const char *name = "chunk",
+                      Scheduler &scheduler = Scheduler::instance())
+  {
+    if (chunks <= 1)
+    {
+      function(0, static_cast<size_t>(0), size);
+      return;
+    }
+
+    TaskGroup group(&scheduler);
+    for (int c = 1; c < chunks; c++)
+    {
+      group.run([c, size, chunks, &function]
+                { function(c, size * c / chunks, size * (c + 1) / chunks); },
+                name);
+    }
+    function(0, static_cast<size_t>(0), size / chunks);
+    group.wait();
+  }
+} // namespace parallel
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <core/common.hpp>
+#include <cstdint>
+
+namespace pipeline
+{
+  /**
+   * @brief Clipping stage, run between the projection and the screen matrices.
+   *
+   * Vertices are clipped in homogeneous coordinates (x, y, z, h), before the division by h, so the
+   * attributes can be interpolated linearly. The window edges are the planes through the observer
+   * and the borders of the window, which is the same as clipping the projected polygon in 2D.
+   *
+   * Since the rasterizer scissors to the viewport, polygons that only overflow the window a little
+   * don't need to be clipped at all: only the near plane and the guard band edges are clipped.
+   */
+
+  // Capacity of the vertex buffers of a ClipPolygon
+  const int CLIP_MAX_VERTICES = 32;
+  // Maximum number of attributes (world position, normal, color, ...) carried by a ClipVertex
+  const int CLIP_MAX_ATTRIBUTES = 9;
+
+  // Outcode bits, one for each plane of the clip volume
+  const uint32_t CLIP_NEAR = 1 << 0;
+  const uint32_t CLIP_LEFT = 1 << 1;
+  const uint32_t CLIP_RIGHT = 1 << 2;
+  const uint32_t CLIP_BOTTOM = 1 << 3;
+  const uint32_t CLIP_TOP = 1 << 4;
+  const uint32_t CLIP_ALL = CLIP_NEAR | CLIP_LEFT | CLIP_RIGHT | CLIP_BOTTOM | CLIP_TOP;
+
+  // Outcode bits of the guard band, a larger window that the rasterizer can handle by itself
+  const uint32_t GUARD_LEFT = 1 << 5;
+  const uint32_t GUARD_RIGHT = 1 << 6;
+  const uint32_t GUARD_BOTTOM = 1 << 7;
+  const uint32_t GUARD_TOP = 1 << 8;
+  // Planes that really need clipping when the rasterizer scissors to the viewport
+  const uint32_t GUARD_ALL = CLIP_NEAR | GUARD_LEFT | GUARD_RIGHT | GUARD_BOTTOM | GUARD_TOP;
+
+  // How far (in pixels) the guard band extends beyond the viewport on each side. Together with the
+  // viewport it must stay within the range the rasterizer steps in fixed point.
+  const double GUARD_BAND_PIXELS = 4096.0;
+
+  // A vertex after the projection matrix, before the division by h
+  typedef struct
+  {
+    double x;
+    double y;
+    double z;
+    double h;
+    float attributes[CLIP_MAX_ATTRIBUTES];
+  } ClipVertex;
+
+  // The visible region: the window (x_min, x_max, y_min, y_max) and the near plane h >= h_near,
+  // plus the guard band around the window (in the same units as the window)
+  typedef struct
+  {
+    double x_min;
+    double x_max;
+    double y_min;
+    double y_max;
+    double h_near;
+    double guard_x_min;
+    double guard_x_max;
+    double guard_y_min;
+    double guard_y_max;
+  } ClipVolume;
+
+  // A polygon being clipped. Each plane reads one buffer and writes the other one, so no memory is
+  // allocated; buffers[current] holds the count vertices of the polygon.
+  typedef struct
+  {
+    ClipVertex buffers[2][CLIP_MAX_VERTICES];
+    int current;
+    int count;
+  } ClipPolygon;
+
+  ClipVolume clip_volume(std::vector<double> window, double h_near);
+  ClipVolume clip_volume(std::vector<double> window, std::vector<double> viewport, double h_near);
+  uint32_t outcode(const ClipVertex &v, const ClipVolume &volume);
+
+  void clip_polygon(ClipPolygon &polygon, const ClipVolume &volume, uint32_t planes, int num_attributes);
+  bool clip_segment(ClipVertex &a, ClipVertex &b, const ClipVolume &volume, int num_attributes);
+} // namespace pipeline
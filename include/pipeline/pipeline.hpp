@@ -1,9 +1,69 @@
 #pragma once
 
 #include <core/common.hpp>
+#include <math/math.hpp>
+#include <math/matrix.hpp>
 
 namespace pipeline
 {
+  // The projection stage split by kinds: the perspective matrix is applied after the affine one
+  typedef struct
+  {
+    Math::PerspectiveMatrix<double> perspective;
+    Math::AffineMatrix<double> affine;
+  } ProjectionStage;
+
+  /**
+   * @brief Pipeline class - The stages that take a vertex from the SRU to the screen.
+   *
+   * Each stage is a 4x4 matrix: view (SRU to the camera system), projection (camera system to
+   * homogeneous coordinates, where the clipping happens before the division by h, kept by kinds so
+   * it is composed with the cheaper products of math/matrix.hpp) and screen
+   * (after the division, a scale and a translation to the viewport). Both pipelines implement it, so the renderer can switch
+   * between them at runtime and be compared on the same scenes.
+   */
+  class Pipeline
+  {
+  public:
+    virtual ~Pipeline() = default;
+
+    virtual const char *getName() const = 0;
+
+    virtual Math::Matrix4 view(const Core::Camera &camera) const = 0;
+    virtual ProjectionStage projectionStage(const Core::Camera &camera) const = 0;
+    virtual Math::Matrix4 screen(const Core::Camera &camera) const = 0;
+
+    // The window after the projection, in the units of x / h and y / h
+    virtual std::vector<double> window(const Core::Camera &camera) const = 0;
+    // The h of a point distance units in front of the observer
+    virtual double depthToH(const Core::Camera &camera, double distance) const = 0;
+
+    Math::Matrix4 projection(const Core::Camera &camera) const;
+    Math::Matrix4 projectionView(const Core::Camera &camera) const;
+    Math::Matrix4 transform(const Core::Camera &camera) const;
+  };
+
+  Math::Matrix4 compose_projection_view(const ProjectionStage &projection, const Math::Matrix4 &view);
+
+  // The pipelines the renderer can switch between
+  enum class PipelineKind
+  {
+    SANTA_CATARINA,
+    MADEIRAS_PEREIRA
+  };
+
+  const Pipeline &get_pipeline(PipelineKind kind);
+
+  // The axes of the camera system in the SRU: u to the right, v up and n back, toward the observer
+  typedef struct
+  {
+    Core::Vertex::Vertex u;
+    Core::Vertex::Vertex v;
+    Core::Vertex::Vertex n;
+  } ViewBasis;
+
+  ViewBasis view_basis(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp, Core::Vertex::Vertex up);
+
   /**
    * @brief This is the namespace that contains all the classes and functions related to the pipeline
    proposed by the author Adair Santa Catarina.
@@ -11,11 +71,53 @@ namespace pipeline
    */
   namespace santa_catarina
   {
-    std::vector<std::vector<double>> sru2src(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp);
+    std::vector<std::vector<double>> sru2src(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp, Core::Vertex::Vertex up = {0, 1, 0});
     std::vector<std::vector<double>> projection(Core::Vertex::Vertex vrp, Core::Vertex::Vertex p, double d);
     std::vector<std::vector<double>> src2srt(std::vector<double> window, std::vector<double> viewport, bool reflection);
 
-    std::vector<std::vector<double>> algebraic_pipeline_sta_catarina(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp, Core::Vertex::Vertex p, double d, int *window, int *viewport);
+    std::vector<std::vector<double>> algebraic_pipeline_sta_catarina(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp, Core::Vertex::Vertex p, double d, int *window, int *viewport,
+                                                                     Core::Vertex::Vertex up = {0, 1, 0});
+
+    // The rows of the composed pipeline that give the screen coordinates: x and y are divided by h.
+    // The z row is left out, the depth test only needs 1 / h.
+    typedef struct
+    {
+      double x[4];
+      double y[4];
+      double h[4];
+    } ScreenProjection;
+
+    ScreenProjection screen_projection(const std::vector<std::vector<double>> &pipeline);
+
+    /**
+     * @brief Project a point of the SRU to the screen with the closed form pipeline: 12 multiply-adds
+     * and a single divide. It is defined in the header so the loops that call it can be vectorized.
+     *
+     * @param s The closed form pipeline.
+     * @param v The point, in the SRU.
+     * @param x The x screen coordinate.
+     * @param y The y screen coordinate.
+     * @param inv_h 1 / h, greater is closer.
+     */
+    inline void project_vertex(const ScreenProjection &s, const Core::Vertex::Vertex &v, double &x, double &y, double &inv_h)
+    {
+      inv_h = 1.0 / (s.h[0] * v.x + s.h[1] * v.y + s.h[2] * v.z + s.h[3]);
+      x = (s.x[0] * v.x + s.x[1] * v.y + s.x[2] * v.z + s.x[3]) * inv_h;
+      y = (s.y[0] * v.x + s.y[1] * v.y + s.y[2] * v.z + s.y[3]) * inv_h;
+    }
+
+    class SantaCatarinaPipeline : public Pipeline
+    {
+    public:
+      const char *getName() const override;
+
+      Math::Matrix4 view(const Core::Camera &camera) const override;
+      ProjectionStage projectionStage(const Core::Camera &camera) const override;
+      Math::Matrix4 screen(const Core::Camera &camera) const override;
+
+      std::vector<double> window(const Core::Camera &camera) const override;
+      double depthToH(const Core::Camera &camera, double distance) const override;
+    };
   } // namespace santa_catarina
 
   /**
@@ -25,6 +127,27 @@ namespace pipeline
    */
   namespace madeiras_pereira
   {
+    // Distances from the observer to the front and back planes of the view volume. The camera has
+    // neither, they only set the range of the normalized z.
+    const double FRONT_PLANE = 0.1;
+    const double BACK_PLANE = 1000.0;
+
+    Math::Matrix4 view_orientation(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp, Core::Vertex::Vertex up = {0, 1, 0});
+    Math::Matrix4 normalization(std::vector<double> window, double d, double back);
+    Math::Matrix4 perspective_to_parallel(double z_min);
+    Math::Matrix4 viewport_transform(std::vector<double> viewport);
+
+    class MadeirasPereiraPipeline : public Pipeline
+    {
+    public:
+      const char *getName() const override;
+
+      Math::Matrix4 view(const Core::Camera &camera) const override;
+      ProjectionStage projectionStage(const Core::Camera &camera) const override;
+      Math::Matrix4 screen(const Core::Camera &camera) const override;
 
+      std::vector<double> window(const Core::Camera &camera) const override;
+      double depthToH(const Core::Camera &camera, double distance) const override;
+    };
   } // namespace madeiras_pereira
 } // namespace pipeline
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <core/common.hpp>
+#include <math/math.hpp>
+#include <math/matrix.hpp>
+#include <parallel/aligned.hpp>
+#include <pipeline/pipeline.hpp>
+
+#include <vector>
+
+namespace pipeline
+{
+  // Vertexes projected by one task. A multiple of the floats in a cache line, so the tasks write
+  // whole lines of the output buffers, and small enough that the inputs and outputs of a chunk
+  // stay in the L2 cache.
+  const size_t PROJECTION_CHUNK_VERTEXES = 2048;
+
+  typedef std::vector<float, parallel::CacheAlignedAllocator<float>> ProjectionBuffer;
+
+  // The vertexes of a mesh after the projection, in the order of its vertexes: before the division
+  // by h (where they are clipped), and on the screen
+  typedef struct
+  {
+    ProjectionBuffer clip_x;
+    ProjectionBuffer clip_y;
+    ProjectionBuffer clip_z;
+    ProjectionBuffer clip_h;
+    ProjectionBuffer screen_x;
+    ProjectionBuffer screen_y;
+    ProjectionBuffer inv_h;
+  } ProjectedVertexes;
+
+  void resize_projection(ProjectedVertexes &projected, size_t n);
+  void project_points(const Math::Matrix4 &transform, const Math::ScaleTranslateMatrix<double> &screen, const float *x, const float *y, const float *z, size_t n,
+                      ProjectedVertexes &projected);
+  void project_meshes(const std::vector<Core::Mesh *> &meshes, const std::vector<Math::Matrix4> &transforms, const Math::ScaleTranslateMatrix<double> &screen,
+                      std::vector<ProjectedVertexes> &projected);
+  void project_scene(const Core::Scene *scene, PipelineKind kind, std::vector<ProjectedVertexes> &projected);
+} // namespace pipeline
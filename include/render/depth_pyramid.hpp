@@ -0,0 +1,39 @@
+#pragma once
+
+#include <render/framebuffer.hpp>
+
+#include <vector>
+
+namespace render
+{
+  /**
+   * @brief DepthPyramid class - A hierarchical z-buffer, for occlusion culling.
+   *
+   * Level 0 is a copy of the depth buffer and each texel of level k + 1 keeps the farthest (least
+   * 1/w) of the 2x2 texels below it, so a single texel of a coarse level bounds the depth of a
+   * whole block of pixels. A box whose nearest point is farther than everything drawn over its
+   * screen rectangle can't be visible.
+   */
+  class DepthPyramid
+  {
+  private:
+    std::vector<std::vector<float>> levels;
+    std::vector<int> widths;
+    std::vector<int> heights;
+
+  public:
+    DepthPyramid();
+    DepthPyramid(const DepthPyramid &p);
+    ~DepthPyramid();
+
+    int getNumLevels() const;
+    int getWidth(int level) const;
+    int getHeight(int level) const;
+    float getDepth(int level, int x, int y) const;
+
+    DepthPyramid &operator=(const DepthPyramid &p);
+
+    void build(const FrameBuffer &fb);
+    bool isOccluded(float x_min, float y_min, float x_max, float y_max, float max_inv_w) const;
+  };
+} // namespace render
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace render
+{
+  // Below this many keys the sort runs on the calling thread only
+  const size_t PARALLEL_SORT_MIN_KEYS = 1 << 16;
+
+  uint32_t sortable_key(float key);
+  void radix_sort(const float *keys, size_t count, uint32_t *order, int threads = 0);
+} // namespace render
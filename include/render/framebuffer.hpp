@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace render
+{
+  /**
+   * @brief FrameBuffer class - The color and depth targets of the software renderer.
+   *
+   */
+  class FrameBuffer
+  {
+  private:
+    int width;
+    int height;
+    // One RGBA8 pixel per entry, red in the lowest byte (the layout expected by sf::Texture::update)
+    std::vector<uint32_t> color;
+    // One 1/w value per pixel, the closest fragment is the one with the greatest value
+    std::vector<float> depth;
+    // The rectangle (x_min, y_min inclusive, x_max, y_max exclusive) fragments are restricted to
+    int scissor[4];
+    // Whether fragments farther than the depth buffer are discarded
+    bool depth_test;
+
+  public:
+    FrameBuffer();
+    FrameBuffer(int width, int height);
+    FrameBuffer(const FrameBuffer &fb);
+    ~FrameBuffer();
+
+    int getWidth() const;
+    int getHeight() const;
+    uint32_t *getColor();
+    const uint32_t *getColor() const;
+    float *getDepth();
+    const float *getDepth() const;
+    const uint8_t *getPixels() const;
+    int getScissorXMin() const;
+    int getScissorXMax() const;
+    int getScissorYMin() const;
+    int getScissorYMax() const;
+    bool getDepthTest() const;
+
+    uint32_t getPixel(int x, int y) const;
+    void setPixel(int x, int y, uint32_t color);
+    void setScissor(int x_min, int y_min, int x_max, int y_max);
+    void setDepthTest(bool depth_test);
+
+    FrameBuffer &operator=(const FrameBuffer &fb);
+
+    void resize(int width, int height);
+    void clear(uint32_t color);
+  };
+
+  uint32_t pack_color(float r, float g, float b);
+} // namespace render
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <render/framebuffer.hpp>
+#include <render/shading.hpp>
+
+namespace render
+{
+  // A vertex already in screen coordinates (SRT), ready to be rasterized
+  typedef struct
+  {
+    float x;
+    float y;
+    // 1/w of the vertex, interpolated linearly in screen space and used as depth
+    float inv_w;
+    Color color;
+  } RasterVertex;
+
+  // A vertex in screen coordinates (SRT) that also carries its world position and normal
+  typedef struct
+  {
+    float x;
+    float y;
+    float inv_w;
+    float px, py, pz;
+    float nx, ny, nz;
+  } PhongVertex;
+
+  void fill_triangle(FrameBuffer &fb, const RasterVertex &a, const RasterVertex &b, const RasterVertex &c);
+  void fill_polygon(FrameBuffer &fb, const RasterVertex *vertices, const int *loop, int count);
+  void fill_triangle_phong(FrameBuffer &fb, const PhongVertex &a, const PhongVertex &b, const PhongVertex &c,
+                           const Core::Vertex::Vertex &eye, const Material &material, const std::vector<Light> &lights);
+  void draw_line(FrameBuffer &fb, const RasterVertex &a, const RasterVertex &b);
+} // namespace render
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <core/camera.hpp>
+#include <core/common.hpp>
+#include <pipeline/pipeline.hpp>
+#include <render/framebuffer.hpp>
+#include <render/renderer.hpp>
+#include <render/shading.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace render
+{
+  // A frame for the worker to render: a copy of everything the UI thread may change while the
+  // worker projects the scene. The meshes are shared, they must not be edited until the frame is
+  // finished.
+  typedef struct
+  {
+    Core::Camera camera;
+    std::vector<Core::Mesh *> meshes;
+    // The model matrix of each mesh in the SRU
+    std::vector<Math::Matrix4> transforms;
+    pipeline::PipelineKind pipeline_kind;
+    ShadingMode shading_mode;
+    VisibilityMode visibility_mode;
+    bool occlusion_culling;
+    int width;
+    int height;
+  } RenderRequest;
+
+  /**
+   * @brief RenderWorker class - Renders the scene on a thread of its own, away from the UI thread.
+   *
+   * The UI thread submits a request each time the camera or the scene changes and keeps handling
+   * its events. The worker only keeps the latest request, the ones submitted while it is busy are
+   * replaced by the next one, so a burst of camera moves costs one frame once the worker is free.
+   *
+   * The frames are rendered into three buffers: the worker draws into the back one, the UI thread
+   * shows the front one, and the last finished one waits between them. Both threads hand over
+   * their buffer with an atomic exchange of the waiting one, so neither of them waits for a lock
+   * to get or publish a frame.
+   */
+  class RenderWorker
+  {
+  private:
+    Renderer renderer;
+    Core::Camera camera;
+    Core::Scene *scene;
+    FrameBuffer *back;
+    FrameBuffer *front;
+    // The finished frame between the threads, with FRESH_FRAME set until the UI thread takes it
+    std::atomic<uintptr_t> ready;
+    std::atomic<bool> busy;
+    std::atomic<int> culled_meshes;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    RenderRequest pending;
+    bool has_pending;
+    bool stopping;
+    std::thread thread;
+
+    void run();
+
+  public:
+    RenderWorker();
+    RenderWorker(const RenderWorker &w) = delete;
+    ~RenderWorker();
+
+    bool isBusy() const;
+    bool hasFrame() const;
+    int getCulledMeshes() const;
+
+    RenderWorker &operator=(const RenderWorker &w) = delete;
+
+    void submit(const RenderRequest &request);
+    const FrameBuffer *takeFrame();
+  };
+} // namespace render
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <core/common.hpp>
+#include <geometry/triangulation.hpp>
+#include <math/math.hpp>
+#include <math/matrix.hpp>
+#include <pipeline/clipping.hpp>
+#include <pipeline/pipeline.hpp>
+#include <pipeline/projection.hpp>
+#include <render/depth_pyramid.hpp>
+#include <render/framebuffer.hpp>
+#include <render/rasterizer.hpp>
+#include <render/shading.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace render
+{
+  // Distance from the observer to the near clipping plane, in world units
+  const double NEAR_PLANE = 0.1;
+  // The largest size on the screen, in pixels, of the details lost by the level of detail a mesh
+  // is drawn with
+  const double LOD_MAX_ERROR = 1.0;
+  // How far past LOD_MAX_ERROR, relative to it, the error goes before a mesh changes its level
+  const double LOD_HYSTERESIS = 0.25;
+  // Attributes carried through the clipping stage: world position, normal and color
+  const int NUM_CLIP_ATTRIBUTES = 9;
+
+  // How the renderer decides which surface is visible at each pixel
+  enum class VisibilityMode
+  {
+    // Every fragment is tested against the depth buffer
+    Z_BUFFER,
+    // The faces are sorted by depth and drawn from back to front, over each other
+    PAINTER
+  };
+
+  // A polygon recorded for the painter's algorithm, its vertexes are a range of the painter buffers.
+  // In wireframe mode it is filled with the background and its edges are drawn if outline is set; a
+  // polygon of two vertexes is an edge alone.
+  typedef struct
+  {
+    uint32_t first;
+    uint32_t count;
+    bool outline;
+  } PainterPolygon;
+
+  // The level of detail an object was drawn with, 0 for its mesh itself
+  typedef struct
+  {
+    Core::Mesh *mesh;
+    int level;
+  } ObjectLod;
+
+  // The geometry of a mesh where it is modeled, which doesn't depend on where it is placed: its
+  // vertexes with their normals, and the half-edge loop and normal of each face. The vertexes are
+  // stored relative to the origin, one of them, so they keep their precision in float. It is valid
+  // while the topology version of the mesh doesn't change.
+  typedef struct
+  {
+    uint64_t topology_version;
+    Core::Vertex::Vertex origin;
+    VertexBatch batch;
+    std::vector<std::vector<int>> loops;
+    std::vector<Core::Vertex::Vertex> normals;
+  } MeshGeometry;
+
+  // The vertexes of an object placed relative to the observer, with their normals, and projected.
+  // The placed vertexes are valid while the mesh, its topology, the model matrix and the eye don't
+  // change, the projected ones while the projection and the screen stage don't change either.
+  typedef struct
+  {
+    Core::Mesh *mesh;
+    uint64_t topology_version;
+    Math::Matrix4 model;
+    Core::Vertex::Vertex eye;
+    Math::Matrix4 view;
+    Math::ScaleTranslateMatrix<double> screen;
+    VertexBatch world;
+    std::vector<Core::Vertex::Vertex> world_normals;
+    pipeline::ProjectedVertexes projection;
+  } ObjectProjection;
+
+  // The stages of the pipeline for a camera, kept between frames. Each one is rebuilt only when
+  // the version of the camera stage it depends on changes.
+  typedef struct
+  {
+    const Core::Camera *camera;
+    pipeline::PipelineKind pipeline_kind;
+    uint64_t view_version;
+    uint64_t projection_version;
+    uint64_t screen_version;
+    Math::Matrix4 view;
+    pipeline::ProjectionStage projection;
+    // projection * view, the clipping stage sits between it and the screen stage
+    Math::Matrix4 projection_view;
+    Math::ScaleTranslateMatrix<double> screen;
+    pipeline::ClipVolume volume;
+  } CameraStages;
+
+  /**
+   * @brief Renderer class - Draws a Core::Scene into a FrameBuffer on the CPU.
+   *
+   * The meshes are projected with one of the pipelines without modifying their vertexes, so
+   * the world coordinates stay available for editing and lighting. Faces are clipped against the
+   * near plane and the guard band between the projection and screen stages, and the rasterizer
+   * scissors them to the viewport. Except with Phong shading, faces of any vertex count are filled
+   * directly from their half-edge loops, without triangulating them.
+   *
+   * With occlusion culling, the meshes visible in the previous frame are drawn first. A depth
+   * pyramid built from them then rejects the bounding boxes of the other meshes, and the meshes
+   * that pass the test become the visible set of the next frame.
+   *
+   * A mesh with levels of detail is drawn with the coarsest one whose lost details stay below
+   * LOD_MAX_ERROR pixels on the screen, and keeps it until the error leaves a margin around that
+   * threshold.
+   *
+   * A mesh may be placed by several objects of the scene. Its geometry is then gathered from the
+   * half-edges once per frame, and each instance only projects, lights and fills it with its own
+   * model matrix.
+   *
+   * With the painter's algorithm, the clipped polygons of all meshes are recorded instead of
+   * drawn, sorted by their mean depth and filled from back to front without the depth test. In
+   * wireframe mode they are filled with the background color under their edges, which hides the
+   * lines behind other faces.
+   */
+  class Renderer
+  {
+  private:
+    FrameBuffer *framebuffer;
+    pipeline::PipelineKind pipeline_kind;
+    ShadingMode shading_mode;
+    VisibilityMode visibility_mode;
+    Material material;
+    std::vector<Light> lights;
+    // The lights of the frame, relative to the observer
+    std::vector<Light> eye_lights;
+    Color background;
+    Color wireframe_color;
+    bool occlusion_culling;
+    DepthPyramid pyramid;
+    geometry::TriangulationCache triangulations;
+    // The mesh of each object visible in the last frame, nullptr for the hidden ones
+    std::vector<Core::Mesh *> visible_meshes;
+    // The level of detail of each object in the last frame
+    std::vector<ObjectLod> object_lods;
+    int culled_meshes;
+    int simplified_meshes;
+    int projected_meshes;
+    std::vector<PainterPolygon> painter_polygons;
+    std::vector<float> painter_keys;
+    std::vector<RasterVertex> painter_raster;
+    std::vector<PhongVertex> painter_phong;
+    CameraStages stages;
+    // The geometry of each mesh of the last frame, shared by its instances, and the placed and
+    // projected vertexes of each object
+    std::unordered_map<Core::Mesh *, MeshGeometry> geometries;
+    std::vector<ObjectProjection> object_projections;
+    // The outcodes, screen vertexes, colors and Phong vertexes of the mesh being drawn, kept
+    // between meshes and frames
+    std::vector<uint32_t> codes;
+    std::vector<RasterVertex> raster;
+    ColorBatch colors;
+    std::vector<PhongVertex> phong;
+
+    void updateStages(const Core::Camera &camera);
+    bool isMeshOccluded(Core::Mesh *mesh, const Math::Matrix4 &view, const Math::ScaleTranslateMatrix<double> &screen,
+                        const pipeline::ClipVolume &volume) const;
+    Core::Mesh *selectLod(size_t object, Core::Mesh *mesh, const Math::Matrix4 &view, const Math::ScaleTranslateMatrix<double> &screen,
+                          const pipeline::ClipVolume &volume);
+
+    void renderMesh(size_t object, Core::Mesh *mesh, const Math::Matrix4 &view, const Math::Matrix4 &model, const Math::ScaleTranslateMatrix<double> &screen,
+                    const pipeline::ClipVolume &volume, const Core::Vertex::Vertex &eye);
+    void drawPainterPolygons();
+
+  public:
+    Renderer();
+    Renderer(FrameBuffer *framebuffer);
+    Renderer(const Renderer &r);
+    ~Renderer();
+
+    FrameBuffer *getFrameBuffer() const;
+    pipeline::PipelineKind getPipeline() const;
+    ShadingMode getShadingMode() const;
+    VisibilityMode getVisibilityMode() const;
+    Material getMaterial() const;
+    std::vector<Light> getLights() const;
+    Color getBackground() const;
+    Color getWireframeColor() const;
+    bool getOcclusionCulling() const;
+    int getCulledMeshes() const;
+    int getSimplifiedMeshes() const;
+    int getProjectedMeshes() const;
+
+    void setFrameBuffer(FrameBuffer *framebuffer);
+    void setPipeline(pipeline::PipelineKind pipeline_kind);
+    void setShadingMode(ShadingMode shading_mode);
+    void setVisibilityMode(VisibilityMode visibility_mode);
+    void setMaterial(Material material);
+    void setLights(std::vector<Light> lights);
+    void setBackground(Color background);
+    void setWireframeColor(Color wireframe_color);
+    void setOcclusionCulling(bool occlusion_culling);
+
+    Renderer &operator=(const Renderer &r);
+
+    void addLight(Light light);
+    void render(Core::Scene *scene);
+  };
+} // namespace render
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <core/common.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace render
+{
+  // The shading models supported by the software renderer
+  enum class ShadingMode
+  {
+    WIREFRAME,
+    FLAT,
+    GOURAUD,
+    PHONG
+  };
+
+  // Number of fragments shaded together by the Phong model
+  const int FRAGMENT_LANES = 8;
+
+  // A RGB color (or intensity) with components in [0, 1]
+  typedef struct
+  {
+    float r;
+    float g;
+    float b;
+  } Color;
+
+  // A point light with separate ambient, diffuse and specular intensities
+  typedef struct
+  {
+    Core::Vertex::Vertex position;
+    Color ambient;
+    Color diffuse;
+    Color specular;
+  } Light;
+
+  // The reflection coefficients of a surface for the Phong illumination model
+  typedef struct
+  {
+    Color ka;
+    Color kd;
+    Color ks;
+    float shininess;
+  } Material;
+
+  // Positions and normals stored as a structure of arrays, so the lighting loops vectorize
+  typedef struct
+  {
+    std::vector<float> px, py, pz;
+    std::vector<float> nx, ny, nz;
+  } VertexBatch;
+
+  // The intensities computed for a VertexBatch, one entry per vertex
+  typedef struct
+  {
+    std::vector<float> r, g, b;
+  } ColorBatch;
+
+  // A group of fragments waiting to be shaded. The lanes past the last fragment keep the ones of
+  // the group before (zeros in the first group), they are shaded and their colors discarded.
+  typedef struct
+  {
+    alignas(32) float px[FRAGMENT_LANES];
+    alignas(32) float py[FRAGMENT_LANES];
+    alignas(32) float pz[FRAGMENT_LANES];
+    alignas(32) float nx[FRAGMENT_LANES];
+    alignas(32) float ny[FRAGMENT_LANES];
+    alignas(32) float nz[FRAGMENT_LANES];
+  } FragmentBatch;
+
+  Color shade_point(const Core::Vertex::Vertex &point, const Core::Vertex::Vertex &normal, const Core::Vertex::Vertex &eye,
+                    const Material &material, const std::vector<Light> &lights);
+  void shade_vertices(const VertexBatch &batch, const Core::Vertex::Vertex &eye, const Material &material,
+                      const std::vector<Light> &lights, ColorBatch &out);
+  void shade_fragments(const FragmentBatch &batch, const Core::Vertex::Vertex &eye, const Material &material,
+                       const std::vector<Light> &lights, uint32_t *out);
+} // namespace render
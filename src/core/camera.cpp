@@ -1,7 +1,25 @@
 #include <core/camera.hpp>
+#include <core/vector.hpp>
+#include <pipeline/pipeline.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 
 namespace Core
 {
+  // The dolly stops this close to the focal point, the view direction is undefined on it
+  static const double MIN_FOCAL_DISTANCE = 1e-3;
+
+  /**
+   * @brief A new version for a stage of a camera, unique among all cameras
+   *
+   */
+  static uint64_t next_version()
+  {
+    static std::atomic<uint64_t> next(1);
+    return next++;
+  }
 
   /**
    * @brief Construct a new Camera:: Camera object
@@ -14,6 +32,7 @@ namespace Core
     this->setD(100.0);
     this->setViewPort({0, 255, 0, 255});
     this->setWindow({-3, 3, -3, 3});
+    this->setUp({0.0, 1.0, 0.0});
   }
 
   /**
@@ -24,28 +43,26 @@ namespace Core
    * @param d A double that represents the distance between the VRP and the P point
    * @param view_port A vector of doubles that represents the view port (x_min, x_max, y_min, y_max)
    * @param window A vector of doubles that represents the window (u_min, u_max, v_min, v_max)
+   * @param up A Vertex::Vertex that represents the view up vector
    */
-  Camera::Camera(Vertex::Vertex vrp, Vertex::Vertex p, double d, std::vector<double> view_port, std::vector<double> window)
+  Camera::Camera(Vertex::Vertex vrp, Vertex::Vertex p, double d, std::vector<double> view_port, std::vector<double> window, Vertex::Vertex up)
   {
     this->setVRP(vrp);
     this->setP(p);
     this->setD(d);
     this->setViewPort(view_port);
     this->setWindow(window);
+    this->setUp(up);
   }
 
   /**
    * @brief Construct a new Camera:: Camera object
    *
-   * @param c The camera to be copied
+   * @param c The camera to be copied, with the versions of its stages
    */
   Camera::Camera(const Camera &c)
   {
-    this->setVRP(c.getVRP());
-    this->setP(c.getP());
-    this->setD(c.getD());
-    this->setViewPort(c.getViewPort());
-    this->setWindow(c.getWindow());
+    *this = c;
   }
 
   Camera::~Camera()
@@ -102,6 +119,60 @@ namespace Core
     return this->window;
   }
 
+  /**
+   * @brief This method is used to get the view up vector
+   *
+   * @return Vertex::Vertex The view up vector
+   */
+  Vertex::Vertex Camera::getUp() const
+  {
+    return this->up;
+  }
+
+  /**
+   * @brief This method is used to get the view matrix (sru2src), from the SRU to the camera system
+   *
+   * @return Math::Matrix4 The view matrix
+   */
+  Math::Matrix4 Camera::getView() const
+  {
+    this->updateView();
+    return this->view;
+  }
+
+  /**
+   * @brief This method is used to get the version of the view stage, it changes when the camera
+   * moves or turns
+   *
+   * @return uint64_t The version of the view stage
+   */
+  uint64_t Camera::getViewVersion() const
+  {
+    return this->view_version;
+  }
+
+  /**
+   * @brief This method is used to get the version of the projection stage, it changes with d and
+   * the window
+   *
+   * @return uint64_t The version of the projection stage
+   */
+  uint64_t Camera::getProjectionVersion() const
+  {
+    return this->projection_version;
+  }
+
+  /**
+   * @brief This method is used to get the version of the screen stage, it changes with the window
+   * and the view port
+   *
+   * @return uint64_t The version of the screen stage
+   */
+  uint64_t Camera::getScreenVersion() const
+  {
+    return this->screen_version;
+  }
+
   /**
    * @brief This method is used to set the VRP (View Reference Point)
    *
@@ -110,6 +181,8 @@ namespace Core
   void Camera::setVRP(Vertex::Vertex vrp)
   {
     this->vrp = vrp;
+    this->view_dirty = true;
+    this->view_version = next_version();
   }
 
   /**
@@ -120,6 +193,8 @@ namespace Core
   void Camera::setP(Vertex::Vertex p)
   {
     this->p = p;
+    this->view_dirty = true;
+    this->view_version = next_version();
   }
 
   /**
@@ -130,6 +205,7 @@ namespace Core
   void Camera::setD(double d)
   {
     this->d = d;
+    this->projection_version = next_version();
   }
 
   /**
@@ -140,6 +216,7 @@ namespace Core
   void Camera::setViewPort(std::vector<double> view_port)
   {
     this->view_port = view_port;
+    this->screen_version = next_version();
   }
 
   /**
@@ -150,6 +227,35 @@ namespace Core
   void Camera::setWindow(std::vector<double> window)
   {
     this->window = window;
+    this->projection_version = next_version();
+    this->screen_version = next_version();
+  }
+
+  /**
+   * @brief This method is used to set the view up vector. It only has to be out of the view
+   * direction, when it is along it the closest axis of the SRU is used.
+   *
+   * @param up The view up vector
+   */
+  void Camera::setUp(Vertex::Vertex up)
+  {
+    this->up = up;
+    this->view_dirty = true;
+    this->view_version = next_version();
+  }
+
+  /**
+   * @brief Rebuild the view matrix from the VRP, the P point and the up vector, if they were set
+   * since it was last built
+   *
+   */
+  void Camera::updateView() const
+  {
+    if (this->view_dirty)
+    {
+      this->view = Math::to_matrix4(pipeline::santa_catarina::sru2src(this->vrp, this->p, this->up));
+      this->view_dirty = false;
+    }
   }
 
   /**
@@ -172,18 +278,25 @@ namespace Core
   }
 
   /**
-   * @brief This method is used to copy a camera
+   * @brief This method is used to copy a camera, with the versions of its stages
    *
    * @param c The camera to be copied
    * @return Camera& The copied camera
    */
   Camera &Camera::operator=(const Camera &c)
   {
-    this->setVRP(c.getVRP());
-    this->setP(c.getP());
-    this->setD(c.getD());
-    this->setViewPort(c.getViewPort());
-    this->setWindow(c.getWindow());
+    this->vrp = c.vrp;
+    this->p = c.p;
+    this->d = c.d;
+    this->view_port = c.view_port;
+    this->window = c.window;
+    this->up = c.up;
+    this->view = c.view;
+    this->view_dirty = c.view_dirty;
+    // The copy has the same stages, so the renderers that built them for c can keep them.
+    this->view_version = c.view_version;
+    this->projection_version = c.projection_version;
+    this->screen_version = c.screen_version;
     return *this;
   }
 
@@ -200,7 +313,8 @@ namespace Core
            this->getP() == c.getP() &&
            this->getD() == c.getD() &&
            this->getViewPort() == c.getViewPort() &&
-           this->getWindow() == c.getWindow();
+           this->getWindow() == c.getWindow() &&
+           this->getUp() == c.getUp();
   }
 
   /**
@@ -216,32 +330,115 @@ namespace Core
   }
 
   /**
-   * @brief This method is used to move the camera
+   * @brief This method is used to move the camera: pan across the view and dolly toward the P point
    *
-   * @param direction The direction to move the camera
+   * The rotation of the view matrix doesn't change, the camera system is translated by the
+   * opposite of the direction, so only the last column of the matrix is updated.
+   *
+   * @param direction The direction to move the camera, along its axes: x to the right (u), y up
+   * (v) and z back (n). x and y move the P point too, z only moves the VRP and stops before the P
+   * point.
    */
   void Camera::move(Vector *direction)
   {
-    // this->setVRP(this->getVRP() + *direction);
+    this->updateView();
+
+    const Vertex::Vertex u = {this->view[0][0], this->view[0][1], this->view[0][2]};
+    const Vertex::Vertex v = {this->view[1][0], this->view[1][1], this->view[1][2]};
+    const Vertex::Vertex n = {this->view[2][0], this->view[2][1], this->view[2][2]};
+    const double x = direction->getX();
+    const double y = direction->getY();
+    const double z = std::max(direction->getZ(), MIN_FOCAL_DISTANCE - Math::length(this->vrp, this->p));
+
+    const Vertex::Vertex pan = {x * u.x + y * v.x, x * u.y + y * v.y, x * u.z + y * v.z};
+    this->p = {this->p.x + pan.x, this->p.y + pan.y, this->p.z + pan.z};
+    this->vrp = {this->vrp.x + pan.x + z * n.x, this->vrp.y + pan.y + z * n.y, this->vrp.z + pan.z + z * n.z};
+
+    // The rows of the rotation are u, v and n, so they take the translation to (x, y, z).
+    this->view[0][3] -= x;
+    this->view[1][3] -= y;
+    this->view[2][3] -= z;
+    this->view_version = next_version();
   }
 
   /**
-   * @brief This method is used to rotate the camera
+   * @brief This method is used to orbit the camera around the P point
    *
-   * @param direction The direction to rotate the camera
+   * The rotation is composed with the rotation of the view matrix, in the camera system, instead
+   * of building the matrix again. Its rows are orthonormalized again so the rounding errors of many
+   * small turns don't add up.
+   *
+   * @param direction The angles to turn the camera, in radians and counterclockwise, around its u
+   * axis (x, the camera goes down), its v axis (y, the camera goes to the right) and its n axis (z,
+   * the camera rolls, the VRP stays).
    */
   void Camera::rotate(Vector *direction)
   {
-    // TODO: Implement this
+    this->updateView();
+
+    const double cx = std::cos(direction->getX()), sx = std::sin(direction->getX());
+    const double cy = std::cos(direction->getY()), sy = std::sin(direction->getY());
+    const double cz = std::cos(direction->getZ()), sz = std::sin(direction->getZ());
+
+    // The turn in the camera system: around v, then around u, then around n.
+    Math::Matrix4 around_u = Math::identity_matrix();
+    around_u[1][1] = cx;
+    around_u[1][2] = -sx;
+    around_u[2][1] = sx;
+    around_u[2][2] = cx;
+    Math::Matrix4 around_v = Math::identity_matrix();
+    around_v[0][0] = cy;
+    around_v[0][2] = sy;
+    around_v[2][0] = -sy;
+    around_v[2][2] = cy;
+    Math::Matrix4 around_n = Math::identity_matrix();
+    around_n[0][0] = cz;
+    around_n[0][1] = -sz;
+    around_n[1][0] = sz;
+    around_n[1][1] = cz;
+    const Math::Matrix4 turn = Math::multiply_matrix(around_n, Math::multiply_matrix(around_u, around_v));
+
+    // The new axes in the SRU are the rows of turn^T * rotation.
+    Vertex::Vertex axes[3];
+    for (int i = 0; i < 3; i++)
+    {
+      axes[i] = {0, 0, 0};
+      for (int j = 0; j < 3; j++)
+      {
+        axes[i].x += turn[j][i] * this->view[j][0];
+        axes[i].y += turn[j][i] * this->view[j][1];
+        axes[i].z += turn[j][i] * this->view[j][2];
+      }
+    }
+    const Vertex::Vertex n = Math::normalize(axes[2]);
+    const Vertex::Vertex v_n = Math::dot(Math::dot(axes[1], n), n);
+    const Vertex::Vertex v = Math::normalize({axes[1].x - v_n.x, axes[1].y - v_n.y, axes[1].z - v_n.z});
+    const Vertex::Vertex u = Math::cross(v, n);
+
+    const double distance = Math::length(this->vrp, this->p);
+    this->vrp = {this->p.x + distance * n.x, this->p.y + distance * n.y, this->p.z + distance * n.z};
+
+    // The up vector follows the camera, so the view built again later (after setP) keeps the roll
+    // and turning over the poles stays smooth.
+    this->up = v;
+
+    const Vertex::Vertex rows[3] = {u, v, n};
+    for (int i = 0; i < 3; i++)
+    {
+      this->view[i] = {rows[i].x, rows[i].y, rows[i].z, -Math::dot(rows[i], this->vrp)};
+    }
+    this->view_version = next_version();
   }
 
   /**
-   * @brief This method is used to zoom the camera
+   * @brief This method is used to zoom the camera, by changing the distance d to the projection
+   * plane. Only the projection stage changes.
    *
-   * @param direction The direction to zoom the camera
+   * @param direction The zoom step, along the n axis of the camera like a dolly: d is multiplied by
+   * e^-z, so a negative z zooms in.
    */
   void Camera::zoom(Vector *direction)
   {
-    // TODO: Implement this
+    this->setD(this->d * std::exp(-direction->getZ()));
   }
 } // namespace Camera
\ No newline at end of file
@@ -20,6 +20,7 @@ namespace Core
     this->next = nullptr;
     this->face = nullptr;
     this->id = "";
+    this->constrained = false;
   }
 
   /**
@@ -39,6 +40,7 @@ namespace Core
     this->next = next;
     this->face = face;
     this->id = id;
+    this->constrained = false;
   }
 
   /**
@@ -54,6 +56,7 @@ namespace Core
     this->next = he.next;
     this->face = he.face;
     this->id = he.id;
+    this->constrained = he.constrained;
   }
 
   HalfEdge::~HalfEdge()
@@ -121,6 +124,17 @@ namespace Core
     return this->id;
   }
 
+  /**
+   * @brief Check if the HalfEdge object is a constrained edge
+   *
+   * @return true If edge flips must keep the edge.
+   * @return false Otherwise.
+   */
+  bool HalfEdge::isConstrained() const
+  {
+    return this->constrained;
+  }
+
   /**
    * @brief Set the origin of the HalfEdge object
    *
@@ -181,6 +195,16 @@ namespace Core
     this->id = id;
   }
 
+  /**
+   * @brief Set whether the HalfEdge object is a constrained edge
+   *
+   * @param constrained true if edge flips must keep the edge.
+   */
+  void HalfEdge::setConstrained(bool constrained)
+  {
+    this->constrained = constrained;
+  }
+
   /**
    * @brief Overload of the << operator of HalfEdge::HalfEdge object
    *
@@ -215,6 +239,7 @@ namespace Core
     this->next = he.next;
     this->face = he.face;
     this->id = he.id;
+    this->constrained = he.constrained;
 
     return *this;
   }
@@ -3,7 +3,11 @@
 #include <core/face.hpp>
 #include <core/half_edge.hpp>
 
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <unordered_map>
+#include <utility>
 
 namespace Core
 {
@@ -46,6 +50,7 @@ namespace Core
     this->setFaces(o.faces);
     this->setNumFaces(o.num_faces);
     this->setId(o.id);
+    this->setLods(o.lods);
   }
 
   Mesh::~Mesh()
@@ -56,9 +61,9 @@ namespace Core
   /**
    * @brief Get the vertexes of the Mesh object
    *
-   * @return std::vector<Vector> A vector of Vector objects.
+   * @return const std::vector<Vector *>& The vertexes, valid until they are set again.
    */
-  std::vector<Vector *> Mesh::getVertexes() const
+  const std::vector<Vector *> &Mesh::getVertexes() const
   {
     return this->vertexes;
   }
@@ -103,6 +108,40 @@ namespace Core
     return this->id;
   }
 
+  /**
+   * @brief Get the topology version of the Mesh object, the caches of data derived from the faces
+   * (such as their triangulations) are valid as long as it doesn't change.
+   *
+   * @return uint64_t The version, unique among all the meshes and all their topologies.
+   */
+  uint64_t Mesh::getTopologyVersion() const
+  {
+    return this->topology_version;
+  }
+
+  /**
+   * @brief Get the levels of detail of the Mesh object
+   *
+   * @return const std::vector<MeshLod>& The simplified meshes, from the finest to the coarsest,
+   * empty if the mesh is always drawn in full.
+   */
+  const std::vector<MeshLod> &Mesh::getLods() const
+  {
+    return this->lods;
+  }
+
+  /**
+   * @brief Give the Mesh object a new topology version, after its half-edges or faces changed
+   *
+   * The setters call it, code that edits the half-edges in place (edge flips) calls it once done.
+   *
+   */
+  void Mesh::updateTopologyVersion()
+  {
+    static std::atomic<uint64_t> next_version(1);
+    this->topology_version = next_version++;
+  }
+
   /**
    * @brief Set the vertexes of the Mesh object
    *
@@ -121,6 +160,7 @@ namespace Core
   void Mesh::setMesh(std::vector<HalfEdge *> mesh)
   {
     this->mesh = mesh;
+    this->updateTopologyVersion();
   }
 
   /**
@@ -131,6 +171,7 @@ namespace Core
   void Mesh::setFaces(std::vector<Face *> faces)
   {
     this->faces = faces;
+    this->updateTopologyVersion();
   }
 
   /**
@@ -153,6 +194,17 @@ namespace Core
     this->id = id;
   }
 
+  /**
+   * @brief Set the levels of detail of the Mesh object, drawn instead of it when it is small on the
+   * screen. They are not updated when the mesh is edited.
+   *
+   * @param lods The simplified meshes, from the finest to the coarsest (increasing error).
+   */
+  void Mesh::setLods(std::vector<MeshLod> lods)
+  {
+    this->lods = lods;
+  }
+
   /**
    * @brief Assignment operator of Mesh::Mesh object
    *
@@ -166,6 +218,8 @@ namespace Core
     this->faces = o.faces;
     this->num_faces = o.num_faces;
     this->id = o.id;
+    this->lods = o.lods;
+    this->updateTopologyVersion();
 
     return *this;
   }
@@ -237,24 +291,28 @@ namespace Core
       faces[i]->setEdges(face_half_edges);
     }
 
-    // set the twin of the half edges
+    // set the twin of the half edges, looking them up by their (origin, destination) pair
+    auto edge_hash = [](const std::pair<Vector *, Vector *> &edge)
+    {
+      return std::hash<Vector *>()(edge.first) * 31 + std::hash<Vector *>()(edge.second);
+    };
+    std::unordered_map<std::pair<Vector *, Vector *>, Core::HalfEdge *, decltype(edge_hash)> edges(mesh.size(), edge_hash);
+
     for (int i = 0; i < mesh.size(); i++)
     {
       Core::HalfEdge *he = mesh[i];
+      Vector *origin = he->getOrigin();
+      Vector *destination = he->getNext()->getOrigin();
 
-      if (he->getTwin() == nullptr)
+      auto twin = edges.find({destination, origin});
+      if (twin != edges.end() && twin->second->getTwin() == nullptr)
       {
-        for (int j = i + 1; j < mesh.size(); j++)
-        {
-          Core::HalfEdge *twin = mesh[j];
-
-          if (he->getOrigin() == twin->getNext()->getOrigin() && he->getNext()->getOrigin() == twin->getOrigin())
-          {
-            he->setTwin(twin);
-            twin->setTwin(he);
-            break;
-          }
-        }
+        he->setTwin(twin->second);
+        twin->second->setTwin(he);
+      }
+      else
+      {
+        edges.emplace(std::make_pair(origin, destination), he);
       }
     }
 
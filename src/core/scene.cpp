@@ -1,24 +1,35 @@
 #include <core/scene.hpp>
 #include <core/camera.hpp>
 
+#include <atomic>
+
 namespace Core
 {
+  /**
+   * @brief A transform version not given to any scene before
+   *
+   */
+  static uint64_t next_version()
+  {
+    static std::atomic<uint64_t> next(1);
+    return next++;
+  }
+
   Scene::Scene()
   {
-    this->objects = std::vector<Mesh *>();
+    this->setObjects(std::vector<Mesh *>());
     this->camera = new Core::Camera();
   }
 
   Scene::Scene(std::vector<Mesh *> objects, Core::Camera *camera)
   {
-    this->objects = objects;
+    this->setObjects(objects);
     this->camera = camera;
   }
 
   Scene::Scene(const Scene &o)
   {
-    this->objects = o.objects;
-    this->camera = o.camera;
+    *this = o;
   }
 
   Scene::~Scene()
@@ -36,9 +47,83 @@ namespace Core
     return this->camera;
   }
 
+  /**
+   * @brief Get the nodes of the scene graph, each parent before its children
+   *
+   */
+  const std::vector<SceneNode> &Scene::getNodes() const
+  {
+    return this->nodes;
+  }
+
+  /**
+   * @brief Get the model matrix of a node, relative to its parent
+   *
+   */
+  Math::Matrix4 Scene::getLocalTransform(int node) const
+  {
+    return this->nodes[node].local;
+  }
+
+  /**
+   * @brief Get the model matrix of a node in the SRU, the product of the ones of its ancestors
+   *
+   */
+  const Math::Matrix4 &Scene::getWorldTransform(int node) const
+  {
+    this->updateWorldTransforms();
+    return this->world[node];
+  }
+
+  /**
+   * @brief Get the model matrices in the SRU of the objects, in the order of getObjects
+   *
+   */
+  std::vector<Math::Matrix4> Scene::getObjectTransforms() const
+  {
+    this->updateWorldTransforms();
+    std::vector<Math::Matrix4> transforms(this->object_nodes.size());
+    for (size_t i = 0; i < this->object_nodes.size(); i++)
+    {
+      transforms[i] = this->world[this->object_nodes[i]];
+    }
+    return transforms;
+  }
+
+  /**
+   * @brief Get the transform version, which changes whenever a node is added, removed or moved
+   *
+   * @return uint64_t The version, unique among all the scenes.
+   */
+  uint64_t Scene::getTransformVersion() const
+  {
+    return this->transform_version;
+  }
+
+  /**
+   * @brief Replace the scene graph with the objects, each one a root where it is modeled
+   *
+   */
   void Scene::setObjects(std::vector<Mesh *> objects)
   {
-    this->objects = objects;
+    this->setObjects(objects, std::vector<Math::Matrix4>(objects.size(), Math::identity_matrix()));
+  }
+
+  /**
+   * @brief Replace the scene graph with the objects, each one a root placed by its matrix
+   *
+   * @param objects The meshes.
+   * @param transforms The model matrix of each mesh.
+   */
+  void Scene::setObjects(std::vector<Mesh *> objects, std::vector<Math::Matrix4> transforms)
+  {
+    this->nodes.clear();
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+      this->nodes.push_back({objects[i], -1, transforms[i]});
+    }
+    this->updateObjects();
+    this->updateTransformVersion();
   }
 
   void Scene::setCamera(Core::Camera *camera)
@@ -46,32 +131,155 @@ namespace Core
     this->camera = camera;
   }
 
+  /**
+   * @brief Move a node and its children. Only the matrix changes, so it takes constant time
+   * whatever the number of vertexes, and the world matrices are updated on their next use.
+   *
+   * @param node The node.
+   * @param local Its model matrix, relative to its parent.
+   */
+  void Scene::setLocalTransform(int node, const Math::Matrix4 &local)
+  {
+    this->nodes[node].local = local;
+    this->updateTransformVersion();
+  }
+
   Scene &Scene::operator=(const Scene &o)
   {
     this->objects = o.objects;
+    this->object_nodes = o.object_nodes;
+    this->nodes = o.nodes;
+    this->world = o.world;
+    this->world_dirty = o.world_dirty;
+    this->transform_version = o.transform_version;
     this->camera = o.camera;
     return *this;
   }
 
   void Scene::addObject(Mesh *object)
   {
-    this->objects.push_back(object);
+    this->addNode(object, -1, Math::identity_matrix());
+  }
+
+  /**
+   * @brief Place a mesh once more, without copying it. The instances share the vertexes and faces
+   * of the mesh, so editing it changes all of them.
+   *
+   * @param mesh The mesh, already in the scene or not.
+   * @param model Where this instance is placed in the SRU.
+   * @return int The index of the node of the instance.
+   */
+  int Scene::addInstance(Mesh *mesh, const Math::Matrix4 &model)
+  {
+    return this->addNode(mesh, -1, model);
+  }
+
+  /**
+   * @brief Add a node to the scene graph, after its parent
+   *
+   * @param mesh The mesh of the node, nullptr for a group.
+   * @param parent The index of the parent node, -1 for a root.
+   * @param local The model matrix, relative to the parent.
+   * @return int The index of the node, -1 if there is no such parent: the node isn't added.
+   */
+  int Scene::addNode(Mesh *mesh, int parent, const Math::Matrix4 &local)
+  {
+    // The world matrices are built in one pass, so the parent must already be in the scene.
+    if (parent < -1 || parent >= static_cast<int>(this->nodes.size()))
+    {
+      return -1;
+    }
+
+    this->nodes.push_back({mesh, parent, local});
+    if (mesh != nullptr)
+    {
+      this->objects.push_back(mesh);
+      this->object_nodes.push_back(static_cast<int>(this->nodes.size()) - 1);
+    }
+    this->updateTransformVersion();
+    return static_cast<int>(this->nodes.size()) - 1;
   }
 
+  /**
+   * @brief Remove an object from the scene, the first instance of a shared mesh. Its node stays as
+   * a group, so its children keep their place.
+   *
+   */
   void Scene::removeObject(Mesh *object)
   {
-    for (int i = 0; i < this->objects.size(); i++)
+    for (SceneNode &node : this->nodes)
     {
-      if (this->objects[i] == object)
+      if (node.mesh == object)
       {
-        this->objects.erase(this->objects.begin() + i);
+        node.mesh = nullptr;
+        this->updateObjects();
+        this->updateTransformVersion();
         break;
       }
     }
   }
 
+  /**
+   * @brief Bring the world matrices up to date, in a single pass over the nodes since each
+   * parent comes before its children
+   *
+   */
+  void Scene::updateWorldTransforms() const
+  {
+    if (!this->world_dirty)
+    {
+      return;
+    }
+
+    this->world.resize(this->nodes.size());
+    for (size_t i = 0; i < this->nodes.size(); i++)
+    {
+      const SceneNode &node = this->nodes[i];
+      this->world[i] = node.parent < 0 ? node.local : Math::multiply_matrix(this->world[node.parent], node.local);
+    }
+    this->world_dirty = false;
+  }
+
+  /**
+   * @brief Rebuild the list of objects from the nodes
+   *
+   */
+  void Scene::updateObjects()
+  {
+    this->objects.clear();
+    this->object_nodes.clear();
+    for (size_t i = 0; i < this->nodes.size(); i++)
+    {
+      if (this->nodes[i].mesh != nullptr)
+      {
+        this->objects.push_back(this->nodes[i].mesh);
+        this->object_nodes.push_back(static_cast<int>(i));
+      }
+    }
+  }
+
+  /**
+   * @brief Mark the world matrices out of date and give the scene a new transform version
+   *
+   */
+  void Scene::updateTransformVersion()
+  {
+    this->world_dirty = true;
+    this->transform_version = next_version();
+  }
+
   void Scene::moveCamera(Vector *direction)
   {
     this->camera->move(direction);
   }
-} // namespace Core
\ No newline at end of file
+
+  void Scene::rotateCamera(Vector *direction)
+  {
+    this->camera->rotate(direction);
+  }
+
+  void Scene::zoomCamera(Vector *direction)
+  {
+    this->camera->zoom(direction);
+  }
+} // namespace Core
@@ -0,0 +1,341 @@
+#include <geometry/constrained.hpp>
+#include <geometry/delaunay.hpp>
+#include <geometry/predicates.hpp>
+#include <core/face.hpp>
+#include <core/half_edge.hpp>
+#include <core/mesh.hpp>
+#include <core/vector.hpp>
+
+#include <deque>
+
+namespace geometry
+{
+  /**
+   * @brief The position of a vertex in the plane of the triangulation
+   *
+   */
+  static Point2 position(const Core::Vector *v)
+  {
+    return {v->getX(), v->getY()};
+  }
+
+  /**
+   * @brief Whether the points c and d are strictly on opposite sides of the line through a and b
+   *
+   */
+  static bool opposite_sides(const Point2 &a, const Point2 &b, const Point2 &c, const Point2 &d)
+  {
+    const double oc = orient2d(a, b, c);
+    const double od = orient2d(a, b, d);
+    return (oc > 0 && od < 0) || (oc < 0 && od > 0);
+  }
+
+  /**
+   * @brief Mark an edge as constrained, on both of its sides
+   *
+   */
+  static void constrain(Core::HalfEdge *he)
+  {
+    he->setConstrained(true);
+    if (he->getTwin() != nullptr)
+    {
+      he->getTwin()->setConstrained(true);
+    }
+  }
+
+  /**
+   * @brief Make three half-edges the loop of a triangular face
+   *
+   */
+  static void link_triangle(Core::Face *face, Core::HalfEdge *e0, Core::HalfEdge *e1, Core::HalfEdge *e2)
+  {
+    e0->setNext(e1);
+    e1->setNext(e2);
+    e2->setNext(e0);
+    e0->setPrev(e2);
+    e1->setPrev(e0);
+    e2->setPrev(e1);
+    e0->setFace(face);
+    e1->setFace(face);
+    e2->setFace(face);
+    face->setHalfEdge(e0);
+    face->setEdges({e0, e1, e2});
+  }
+
+  /**
+   * @brief Replace the diagonal of the quad made by two triangles with the other diagonal.
+   *
+   * The half-edge and its twin are reused for the new diagonal and keep their faces, the four
+   * other half-edges are relinked, so nothing is allocated and the twins outside the quad stay.
+   *
+   * @param he A half-edge (u, v) of the triangle (u, v, w), its twin in the triangle (v, u, x).
+   */
+  static void flip_edge(Core::HalfEdge *he)
+  {
+    Core::HalfEdge *twin = he->getTwin();
+    Core::HalfEdge *he_next = he->getNext();
+    Core::HalfEdge *he_prev = he->getPrev();
+    Core::HalfEdge *twin_next = twin->getNext();
+    Core::HalfEdge *twin_prev = twin->getPrev();
+    Core::Vector *u = he->getOrigin();
+    Core::Vector *v = twin->getOrigin();
+
+    // u and v lose the half-edges leaving them along the old diagonal.
+    if (u->getHalfEdge() == he)
+    {
+      u->setHalfEdge(twin_next);
+    }
+    if (v->getHalfEdge() == twin)
+    {
+      v->setHalfEdge(he_next);
+    }
+
+    // (u, v, w) and (v, u, x) become (x, w, u) and (w, x, v).
+    he->setOrigin(twin_prev->getOrigin());
+    twin->setOrigin(he_prev->getOrigin());
+    link_triangle(he->getFace(), he, he_prev, twin_next);
+    link_triangle(twin->getFace(), twin, twin_prev, he_next);
+  }
+
+  /**
+   * @brief The half-edges leaving a vertex
+   *
+   * @param v The vertex.
+   * @param edges Filled with the half-edges, counterclockwise and then clockwise from the one of
+   * the vertex when the vertex is on the boundary.
+   */
+  static void outgoing_edges(Core::Vector *v, std::vector<Core::HalfEdge *> &edges)
+  {
+    edges.clear();
+    Core::HalfEdge *first = v->getHalfEdge();
+    if (first == nullptr)
+    {
+      return;
+    }
+
+    Core::HalfEdge *he = first;
+    do
+    {
+      edges.push_back(he);
+      he = he->getPrev()->getTwin();
+    } while (he != nullptr && he != first);
+
+    if (he == nullptr)
+    {
+      for (he = first->getTwin(); he != nullptr; he = he->getNext()->getTwin())
+      {
+        edges.push_back(he->getNext());
+      }
+    }
+  }
+
+  /**
+   * @brief Insert the part of a constraint up to the first vertex on it, by flipping the edges it
+   * crosses (Sloan, 1993).
+   *
+   * The walk goes from `from` through the triangles crossed by the segment and collects the
+   * crossed edges until it reaches `to`, or a vertex lying on the segment, which ends this part.
+   * Each crossed edge is then flipped once its quad is convex, until no edge crosses the segment,
+   * and the edges made by the flips are flipped back toward Delaunay, except the constraint.
+   * Only the triangles crossed by the segment are touched.
+   *
+   * @param from The first vertex of the constraint.
+   * @param to The last vertex of the constraint.
+   * @param edges A scratch buffer.
+   * @return Core::Vector* The vertex the part ends at, nullptr if the segment crosses a constrained
+   * edge or a vertex is not in the triangulation.
+   */
+  static Core::Vector *insert_segment(Core::Vector *from, Core::Vector *to, std::vector<Core::HalfEdge *> &edges)
+  {
+    const Point2 a = position(from);
+    const Point2 b = position(to);
+
+    // Find the triangle around `from` the segment leaves through, or an edge along it.
+    outgoing_edges(from, edges);
+    Core::HalfEdge *crossing = nullptr;
+    for (Core::HalfEdge *he : edges)
+    {
+      Core::Vector *p = he->getNext()->getOrigin();
+      const Point2 pp = position(p);
+      const double op = orient2d(a, b, pp);
+      if (p == to || (op == 0 && (pp.x - a.x) * (b.x - a.x) + (pp.y - a.y) * (b.y - a.y) > 0))
+      {
+        constrain(he);
+        return p;
+      }
+      if (op < 0 && orient2d(a, b, position(he->getPrev()->getOrigin())) > 0)
+      {
+        crossing = he->getNext();
+      }
+    }
+    if (crossing == nullptr)
+    {
+      return nullptr;
+    }
+
+    // Walk across the crossed edges, each one from its end on the right of the segment to its end
+    // on the left.
+    std::deque<Core::HalfEdge *> crossed;
+    Core::Vector *end = nullptr;
+    while (end == nullptr)
+    {
+      Core::HalfEdge *twin = crossing->getTwin();
+      if (crossing->isConstrained() || twin == nullptr)
+      {
+        return nullptr;
+      }
+      crossed.push_back(crossing);
+
+      Core::Vector *r = twin->getPrev()->getOrigin();
+      const double orient_r = orient2d(a, b, position(r));
+      if (r == to || orient_r == 0)
+      {
+        end = r;
+      }
+      else
+      {
+        crossing = orient_r < 0 ? twin->getPrev() : twin->getNext();
+      }
+    }
+    const Point2 e = position(end);
+
+    // Flip the crossed edges away, putting back the ones whose quad is not convex yet.
+    std::vector<Core::HalfEdge *> created;
+    while (!crossed.empty())
+    {
+      Core::HalfEdge *he = crossed.front();
+      crossed.pop_front();
+
+      const Point2 u = position(he->getOrigin());
+      const Point2 v = position(he->getNext()->getOrigin());
+      const Point2 w = position(he->getPrev()->getOrigin());
+      const Point2 x = position(he->getTwin()->getPrev()->getOrigin());
+      if (!opposite_sides(x, w, u, v))
+      {
+        crossed.push_back(he);
+        continue;
+      }
+
+      flip_edge(he);
+      Core::Vector *p = he->getOrigin();
+      Core::Vector *q = he->getNext()->getOrigin();
+      if (p != from && p != end && q != from && q != end && opposite_sides(a, e, x, w))
+      {
+        crossed.push_back(he);
+      }
+      else
+      {
+        if ((p == from && q == end) || (p == end && q == from))
+        {
+          constrain(he);
+        }
+        created.push_back(he);
+      }
+    }
+
+    // Restore the Delaunay property around the new edges.
+    bool flipped = true;
+    while (flipped)
+    {
+      flipped = false;
+      for (Core::HalfEdge *he : created)
+      {
+        if (he->isConstrained())
+        {
+          continue;
+        }
+        const Point2 u = position(he->getOrigin());
+        const Point2 v = position(he->getNext()->getOrigin());
+        const Point2 w = position(he->getPrev()->getOrigin());
+        const Point2 x = position(he->getTwin()->getPrev()->getOrigin());
+        if (incircle(u, v, w, x) > 0)
+        {
+          flip_edge(he);
+          flipped = true;
+        }
+      }
+    }
+
+    return end;
+  }
+
+  /**
+   * @brief Insert a constraint without changing the topology version of the mesh
+   *
+   */
+  static bool insert_constraint_edges(Core::Vector *from, Core::Vector *to, std::vector<Core::HalfEdge *> &edges)
+  {
+    if (from == to)
+    {
+      return false;
+    }
+    while (from != to)
+    {
+      from = insert_segment(from, to, edges);
+      if (from == nullptr)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Insert a constraint (a breakline, an outline) in a triangle mesh, so the edges of the
+   * segment are kept by later flips.
+   *
+   * The mesh must be a triangulation of its vertexes in the xy plane, like the ones of
+   * delaunay_mesh, and stays constrained Delaunay. The segment is split at the vertexes lying on
+   * it, the time is proportional to the number of edges it crosses.
+   *
+   * @param mesh The mesh, edited in place.
+   * @param from The first vertex of the segment.
+   * @param to The last vertex of the segment.
+   * @return true If the segment is now made of constrained edges of the mesh.
+   * @return false If it crosses another constraint, or a vertex is not in the triangulation, the
+   * mesh is unchanged then unless the segment went through vertexes before the failure.
+   */
+  bool insert_constraint(Core::Mesh *mesh, Core::Vector *from, Core::Vector *to)
+  {
+    std::vector<Core::HalfEdge *> edges;
+    const bool inserted = insert_constraint_edges(from, to, edges);
+    mesh->updateTopologyVersion();
+    return inserted;
+  }
+
+  /**
+   * @brief Insert many constraints in a triangle mesh, one after the other
+   *
+   * @param mesh The mesh, edited in place.
+   * @param segments The constraints, as indices into the vertexes of the mesh.
+   * @return size_t The number of constraints inserted, the others cross a constraint before them.
+   */
+  size_t insert_constraints(Core::Mesh *mesh, const std::vector<Segment> &segments)
+  {
+    const std::vector<Core::Vector *> vertexes = mesh->getVertexes();
+    std::vector<Core::HalfEdge *> edges;
+    size_t inserted = 0;
+    for (const Segment &segment : segments)
+    {
+      inserted += insert_constraint_edges(vertexes[segment.a], vertexes[segment.b], edges);
+    }
+    mesh->updateTopologyVersion();
+    return inserted;
+  }
+
+  /**
+   * @brief Build the mesh of the constrained Delaunay triangulation of a point set
+   *
+   * @param points The points, triangulated in the xy plane, z is kept as the height.
+   * @param segments The constraints, as indices into the points.
+   * @param id The id of the mesh.
+   * @param threads The threads of the unconstrained triangulation, 0 for all the cores.
+   * @return Core::Mesh* The new mesh.
+   */
+  Core::Mesh *constrained_delaunay_mesh(const std::vector<Core::Vertex::Vertex> &points, const std::vector<Segment> &segments, std::string id, int threads)
+  {
+    Core::Mesh *mesh = delaunay_mesh(points, id, threads);
+    insert_constraints(mesh, segments);
+    return mesh;
+  }
+} // namespace geometry
@@ -0,0 +1,898 @@
+#include <geometry/delaunay.hpp>
+#include <geometry/predicates.hpp>
+#include <core/face.hpp>
+#include <core/half_edge.hpp>
+#include <core/mesh.hpp>
+#include <core/vector.hpp>
+#include <parallel/scheduler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <unordered_map>
+#include <utility>
+
+namespace geometry
+{
+  // The vertex at infinity, shared by the ghost triangles outside of the convex hull
+  static const int GHOST = -1;
+  // Circumcircles closer than this to the border of a block, relative to their radius, are
+  // treated as crossing it, which absorbs the rounding of their center
+  static const double BLOCK_MARGIN = 1e-6;
+  // The points of the first round of the insertion order are all sorted along the curve
+  static const size_t BRIO_FIRST_ROUND = 64;
+
+  /**
+   * @brief The distance of the cell (x, y) along a Hilbert curve through a 2^16 x 2^16 grid
+   *
+   */
+  static uint32_t hilbert_index(uint32_t x, uint32_t y)
+  {
+    uint32_t d = 0;
+    for (uint32_t s = 1u << 15; s > 0; s >>= 1)
+    {
+      const uint32_t rx = (x & s) > 0;
+      const uint32_t ry = (y & s) > 0;
+      d += s * s * ((3 * rx) ^ ry);
+
+      // Rotate the quadrant so the curve inside of it starts and ends at the right corners.
+      if (ry == 0)
+      {
+        if (rx == 1)
+        {
+          x = s - 1 - (x & (s - 1));
+          y = s - 1 - (y & (s - 1));
+        }
+        std::swap(x, y);
+      }
+    }
+    return d;
+  }
+
+  /**
+   * @brief The keys of points along a Hilbert curve through their bounding box: the index of the
+   * curve in the high bits and the index of the point in the low ones
+   *
+   */
+  static void hilbert_keys(const Point2 *points, size_t count, std::vector<uint64_t> &keys)
+  {
+    keys.resize(count);
+    if (count == 0)
+    {
+      return;
+    }
+
+    double x_min = points[0].x, x_max = points[0].x;
+    double y_min = points[0].y, y_max = points[0].y;
+    for (size_t i = 1; i < count; i++)
+    {
+      x_min = std::min(x_min, points[i].x);
+      x_max = std::max(x_max, points[i].x);
+      y_min = std::min(y_min, points[i].y);
+      y_max = std::max(y_max, points[i].y);
+    }
+    const double size = std::max(x_max - x_min, y_max - y_min);
+    const double cells = size > 0 ? 65535.0 / size : 0.0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+      const uint32_t x = static_cast<uint32_t>((points[i].x - x_min) * cells);
+      const uint32_t y = static_cast<uint32_t>((points[i].y - y_min) * cells);
+      keys[i] = static_cast<uint64_t>(hilbert_index(x, y)) << 32 | i;
+    }
+  }
+
+  /**
+   * @brief Sort points along a Hilbert curve, so points close in the order are close in the plane.
+   *
+   * @param points The points.
+   * @param count The number of points.
+   * @param order Filled with the indices of the points, in the order of the curve.
+   */
+  void sort_hilbert(const Point2 *points, size_t count, std::vector<uint32_t> &order)
+  {
+    std::vector<uint64_t> keys;
+    hilbert_keys(points, count, keys);
+    std::sort(keys.begin(), keys.end());
+
+    order.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      order[i] = static_cast<uint32_t>(keys[i]);
+    }
+  }
+
+  /**
+   * @brief Sort points in a biased randomized insertion order.
+   *
+   * The points are shuffled and split in rounds, each twice as large as the one before, and the
+   * points of each round are sorted along a Hilbert curve. Each round is a random sample of the
+   * points, so the triangulation built by the rounds before is a good map of the next one and
+   * the insertions stay cheap whatever the layout of the points, even on a few scan lines where a
+   * single curve goes back and forth between the lines. Inside of a round the curve keeps the
+   * walks short.
+   *
+   * @param points The points.
+   * @param count The number of points.
+   * @param order Filled with the indices of the points, in the order of insertion.
+   */
+  void sort_brio(const Point2 *points, size_t count, std::vector<uint32_t> &order)
+  {
+    std::vector<uint64_t> keys;
+    hilbert_keys(points, count, keys);
+
+    // A fixed seed, so the same points are always triangulated the same way.
+    std::mt19937 rng(1);
+    for (size_t i = count; i > 1; i--)
+    {
+      std::swap(keys[i - 1], keys[rng() % i]);
+    }
+
+    // The last round is the last half of the points, the one before the quarter before it, ...
+    size_t end = count;
+    while (end > 0)
+    {
+      const size_t begin = end > BRIO_FIRST_ROUND ? end / 2 : 0;
+      std::sort(keys.begin() + begin, keys.begin() + end);
+      end = begin;
+    }
+
+    order.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      order[i] = static_cast<uint32_t>(keys[i]);
+    }
+  }
+
+  /**
+   * @brief DelaunayBuilder - The state of a Bowyer-Watson triangulation while points are inserted.
+   *
+   * The convex hull is closed by ghost triangles, which join each of its edges to a vertex at
+   * infinity, so points outside of the hull are inserted like the ones inside: the triangles
+   * whose circumcircle contains the point are removed and the hole is filled with triangles
+   * joining its border to the point. The circumcircle of a ghost triangle is the open half-plane
+   * outside of its edge.
+   */
+  class DelaunayBuilder
+  {
+  private:
+    const Point2 *points;
+    // The corners of the triangles, and the triangles across the edges opposite to them
+    std::vector<int> corners;
+    std::vector<int> neighbours;
+    // The insertion that removed each triangle, it is free to reuse if it isn't the current one
+    std::vector<int> removed;
+    std::vector<int> free_triangles;
+    int insertion;
+    int last;
+    uint32_t seed;
+
+    // The cavity of the current insertion and the edges of its border
+    typedef struct
+    {
+      int from;
+      int to;
+      // The triangle outside of the cavity, and the corner of it opposite to the edge
+      int outside;
+      int slot;
+    } BorderEdge;
+    std::vector<int> stack;
+    std::vector<int> cavity;
+    std::vector<BorderEdge> border;
+    std::vector<std::pair<int, int>> starts;
+
+    int ghostCorner(int t) const
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        if (this->corners[3 * t + i] == GHOST)
+        {
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    int newTriangle(int a, int b, int c)
+    {
+      int t;
+      if (!this->free_triangles.empty())
+      {
+        t = this->free_triangles.back();
+        this->free_triangles.pop_back();
+      }
+      else
+      {
+        t = static_cast<int>(this->removed.size());
+        this->corners.resize(this->corners.size() + 3);
+        this->neighbours.resize(this->neighbours.size() + 3);
+        this->removed.push_back(0);
+      }
+      this->corners[3 * t] = a;
+      this->corners[3 * t + 1] = b;
+      this->corners[3 * t + 2] = c;
+      this->removed[t] = 0;
+      return t;
+    }
+
+    /**
+     * @brief Check if the circumcircle of a triangle contains a point
+     *
+     */
+    bool conflicts(int t, const Point2 &p) const
+    {
+      const int *v = &this->corners[3 * t];
+      const int g = this->ghostCorner(t);
+      if (g < 0)
+      {
+        return incircle(this->points[v[0]], this->points[v[1]], this->points[v[2]], p) > 0;
+      }
+
+      // The outside of the hull is on the left of the edge of a ghost triangle.
+      const Point2 &a = this->points[v[(g + 1) % 3]];
+      const Point2 &b = this->points[v[(g + 2) % 3]];
+      const double o = orient2d(a, b, p);
+      if (o != 0)
+      {
+        return o > 0;
+      }
+
+      // On the line of the edge: the edge is split if the point is inside of it.
+      if (a.x != b.x)
+      {
+        return (p.x > a.x) != (p.x > b.x) && p.x != a.x && p.x != b.x;
+      }
+      return (p.y > a.y) != (p.y > b.y) && p.y != a.y && p.y != b.y;
+    }
+
+    /**
+     * @brief Walk from the last triangle created towards a point, through the edges it is behind.
+     *
+     * @return int A triangle that contains the point, or a ghost triangle whose edge it is outside of.
+     */
+    int locate(const Point2 &p)
+    {
+      int t = this->last;
+      const int g = this->ghostCorner(t);
+      if (g >= 0)
+      {
+        t = this->neighbours[3 * t + g];
+      }
+
+      while (this->ghostCorner(t) < 0)
+      {
+        // Start from a pseudo-random edge, so the walk can't cycle.
+        this->seed = this->seed * 1664525u + 1013904223u;
+        const int first = static_cast<int>(this->seed >> 30) % 3;
+
+        bool moved = false;
+        for (int k = 0; k < 3 && !moved; k++)
+        {
+          const int i = (first + k) % 3;
+          const Point2 &a = this->points[this->corners[3 * t + (i + 1) % 3]];
+          const Point2 &b = this->points[this->corners[3 * t + (i + 2) % 3]];
+          if (orient2d(a, b, p) < 0)
+          {
+            t = this->neighbours[3 * t + i];
+            moved = true;
+          }
+        }
+
+        if (!moved)
+        {
+          break;
+        }
+      }
+      return t;
+    }
+
+  public:
+    DelaunayBuilder(const Point2 *points, int a, int b, int c)
+    {
+      this->points = points;
+      this->insertion = 0;
+      this->seed = 1;
+
+      if (orient2d(points[a], points[b], points[c]) < 0)
+      {
+        std::swap(b, c);
+      }
+
+      // The first triangle and the ghost triangles across its edges (opposite to a, b and c).
+      const int t = this->newTriangle(a, b, c);
+      const int ga = this->newTriangle(c, b, GHOST);
+      const int gb = this->newTriangle(a, c, GHOST);
+      const int gc = this->newTriangle(b, a, GHOST);
+      const int links[4][3] = {{ga, gb, gc}, {gc, gb, t}, {ga, gc, t}, {gb, ga, t}};
+      for (int i = 0; i < 4; i++)
+      {
+        for (int j = 0; j < 3; j++)
+        {
+          this->neighbours[3 * i + j] = links[i][j];
+        }
+      }
+      this->last = t;
+    }
+
+    /**
+     * @brief Insert a point, keeping the triangulation Delaunay
+     *
+     * @param v The index of the point
+     * @return true If the point was inserted
+     * @return false If it is a duplicate of a point already in the triangulation
+     */
+    bool insert(int v)
+    {
+      const Point2 &p = this->points[v];
+      const int start = this->locate(p);
+      if (this->ghostCorner(start) < 0)
+      {
+        for (int i = 0; i < 3; i++)
+        {
+          const Point2 &q = this->points[this->corners[3 * start + i]];
+          if (q.x == p.x && q.y == p.y)
+          {
+            return false;
+          }
+        }
+      }
+
+      // Remove the triangles in conflict with the point, they are connected.
+      this->insertion++;
+      this->cavity.clear();
+      this->border.clear();
+      this->stack.assign(1, start);
+      this->removed[start] = this->insertion;
+      while (!this->stack.empty())
+      {
+        const int t = this->stack.back();
+        this->stack.pop_back();
+        this->cavity.push_back(t);
+
+        for (int i = 0; i < 3; i++)
+        {
+          const int n = this->neighbours[3 * t + i];
+          if (this->removed[n] == this->insertion)
+          {
+            continue;
+          }
+          if (this->conflicts(n, p))
+          {
+            this->removed[n] = this->insertion;
+            this->stack.push_back(n);
+          }
+          else
+          {
+            int slot = 0;
+            while (this->neighbours[3 * n + slot] != t)
+            {
+              slot++;
+            }
+            this->border.push_back({this->corners[3 * t + (i + 1) % 3], this->corners[3 * t + (i + 2) % 3], n, slot});
+          }
+        }
+      }
+
+      // Fill the cavity with triangles joining its border to the point.
+      this->free_triangles.insert(this->free_triangles.end(), this->cavity.begin(), this->cavity.end());
+      this->starts.clear();
+      for (const BorderEdge &e : this->border)
+      {
+        const int t = this->newTriangle(e.from, e.to, v);
+        this->neighbours[3 * t + 2] = e.outside;
+        this->neighbours[3 * e.outside + e.slot] = t;
+        this->starts.push_back({e.from, t});
+        if (e.from != GHOST && e.to != GHOST)
+        {
+          this->last = t;
+        }
+      }
+
+      // The triangles around the point follow each other along the border of the cavity.
+      for (const std::pair<int, int> &s : this->starts)
+      {
+        const int t = s.second;
+        const int to = this->corners[3 * t + 1];
+        for (const std::pair<int, int> &next : this->starts)
+        {
+          if (next.first == to)
+          {
+            this->neighbours[3 * t] = next.second;
+            this->neighbours[3 * next.second + 1] = t;
+            break;
+          }
+        }
+      }
+      return true;
+    }
+
+    /**
+     * @brief Copy the triangles inside of the hull, dropping the ghost and the removed ones
+     *
+     * @param order The index of the input point each point of the builder was copied from.
+     */
+    void finish(const std::vector<uint32_t> &order, DelaunayTriangulation &triangulation) const
+    {
+      const int count = static_cast<int>(this->removed.size());
+      std::vector<int> index(count, -1);
+      std::vector<bool> is_free(count, false);
+      for (int t : this->free_triangles)
+      {
+        is_free[t] = true;
+      }
+
+      int kept = 0;
+      for (int t = 0; t < count; t++)
+      {
+        if (!is_free[t] && this->ghostCorner(t) < 0)
+        {
+          index[t] = kept++;
+        }
+      }
+
+      triangulation.triangles.resize(kept);
+      triangulation.neighbours.resize(3 * kept);
+      for (int t = 0; t < count; t++)
+      {
+        if (index[t] < 0)
+        {
+          continue;
+        }
+        const int *v = &this->corners[3 * t];
+        triangulation.triangles[index[t]] = {static_cast<int>(order[v[0]]), static_cast<int>(order[v[1]]), static_cast<int>(order[v[2]])};
+        for (int i = 0; i < 3; i++)
+        {
+          triangulation.neighbours[3 * index[t] + i] = index[this->neighbours[3 * t + i]];
+        }
+      }
+    }
+  };
+
+  /**
+   * @brief Compute the Delaunay triangulation of a set of points, by Bowyer-Watson insertion.
+   *
+   * The points are inserted in rounds of random points, each sorted along a Hilbert curve (see
+   * sort_brio), so each one is found by a short walk from the triangles of the previous one and
+   * removes few triangles, and every geometric test uses exact predicates, so collinear,
+   * cocircular and duplicated points are handled. Duplicates are left out of the triangulation.
+   *
+   * @param points The points.
+   * @param count The number of points.
+   * @param triangulation Filled with the triangles and their neighbours, empty if all the points
+   * are collinear.
+   */
+  void delaunay(const Point2 *points, size_t count, DelaunayTriangulation &triangulation)
+  {
+    triangulation.triangles.clear();
+    triangulation.neighbours.clear();
+
+    // The points are copied in the order of insertion, so they are read from memory in order too.
+    std::vector<uint32_t> order;
+    sort_brio(points, count, order);
+    std::vector<Point2> sorted(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      sorted[i] = points[order[i]];
+    }
+
+    // The first triangle is made of the first points that aren't collinear.
+    size_t second = 1;
+    while (second < count && sorted[second].x == sorted[0].x && sorted[second].y == sorted[0].y)
+    {
+      second++;
+    }
+    size_t third = second + 1;
+    while (third < count && orient2d(sorted[0], sorted[second], sorted[third]) == 0)
+    {
+      third++;
+    }
+    if (third >= count)
+    {
+      return;
+    }
+
+    DelaunayBuilder builder(sorted.data(), 0, static_cast<int>(second), static_cast<int>(third));
+    for (size_t i = 1; i < count; i++)
+    {
+      if (i != second && i != third)
+      {
+        builder.insert(static_cast<int>(i));
+      }
+    }
+    builder.finish(order, triangulation);
+  }
+
+  /**
+   * @brief Check if the circumcircle of a triangle is strictly between two vertical lines
+   *
+   */
+  static bool circle_inside_slab(const Point2 &a, const Point2 &b, const Point2 &c, double left, double right)
+  {
+    const double bx = b.x - a.x;
+    const double by = b.y - a.y;
+    const double cx = c.x - a.x;
+    const double cy = c.y - a.y;
+    const double d = 2.0 * (bx * cy - by * cx);
+    if (d == 0)
+    {
+      return false;
+    }
+
+    const double b2 = bx * bx + by * by;
+    const double c2 = cx * cx + cy * cy;
+    const double ux = (cy * b2 - by * c2) / d;
+    const double uy = (bx * c2 - cx * b2) / d;
+    const double radius = std::sqrt(ux * ux + uy * uy) * (1.0 + BLOCK_MARGIN);
+    return a.x + ux - radius > left && a.x + ux + radius < right;
+  }
+
+  static inline uint64_t edge_key(int from, int to)
+  {
+    return static_cast<uint64_t>(static_cast<uint32_t>(from)) << 32 | static_cast<uint32_t>(to);
+  }
+
+  /**
+   * @brief Compute the Delaunay triangulation of a set of points, in parallel blocks.
+   *
+   * The plane is cut in vertical slabs with the same number of points, which are triangulated
+   * concurrently. A triangle of a block whose circumcircle is inside of its slab is final: no
+   * point of the other blocks can be in it. The vertices of the other triangles (and of the hulls
+   * of the blocks) are triangulated again together; the triangles of that triangulation that are
+   * outside of the final ones fill the seams between the blocks, they are found by a flood fill
+   * from the edges on the border of the final triangles.
+   *
+   * @param points The points.
+   * @param count The number of points.
+   * @param triangulation Filled with the triangles and their neighbours, the same as delaunay.
+   * @param threads The number of blocks and threads, 0 for one per thread of the scheduler.
+   */
+  void delaunay_parallel(const Point2 *points, size_t count, DelaunayTriangulation &triangulation, int threads)
+  {
+    if (threads <= 0)
+    {
+      threads = parallel::Scheduler::instance().getThreads();
+    }
+    const int blocks = threads;
+    if (blocks == 1 || count < static_cast<size_t>(16 * blocks))
+    {
+      delaunay(points, count, triangulation);
+      return;
+    }
+
+    // The borders of the slabs, from the quantiles of a sample of the x coordinates.
+    std::vector<double> sample;
+    const size_t stride = std::max<size_t>(1, count / (256 * blocks));
+    for (size_t i = 0; i < count; i += stride)
+    {
+      sample.push_back(points[i].x);
+    }
+    std::sort(sample.begin(), sample.end());
+    std::vector<double> borders(blocks + 1);
+    borders[0] = -std::numeric_limits<double>::infinity();
+    borders[blocks] = std::numeric_limits<double>::infinity();
+    for (int b = 1; b < blocks; b++)
+    {
+      borders[b] = sample[sample.size() * b / blocks];
+    }
+
+    std::vector<std::vector<uint32_t>> members(blocks);
+    for (size_t i = 0; i < count; i++)
+    {
+      const int b = static_cast<int>(std::upper_bound(borders.begin() + 1, borders.end() - 1, points[i].x) - (borders.begin() + 1));
+      members[b].push_back(static_cast<uint32_t>(i));
+    }
+
+    // Triangulate the blocks, rank their final triangles and collect the points of the seams.
+    std::vector<DelaunayTriangulation> locals(blocks);
+    std::vector<std::vector<int>> final_index(blocks);
+    std::vector<std::vector<uint32_t>> seam_points(blocks);
+    std::vector<size_t> final_counts(blocks + 1, 0);
+
+    parallel::for_each_chunk(blocks, blocks, [&](int b, size_t, size_t)
+                             {
+                               const std::vector<uint32_t> &ids = members[b];
+                               std::vector<Point2> block(ids.size());
+                               for (size_t i = 0; i < ids.size(); i++)
+                               {
+                                 block[i] = points[ids[i]];
+                               }
+                               DelaunayTriangulation &local = locals[b];
+                               delaunay(block.data(), block.size(), local);
+
+                               std::vector<char> seam(ids.size(), local.triangles.empty());
+                               final_index[b].assign(local.triangles.size(), -1);
+                               int finals = 0;
+                               for (size_t t = 0; t < local.triangles.size(); t++)
+                               {
+                                 const int corners[3] = {local.triangles[t].a, local.triangles[t].b, local.triangles[t].c};
+                                 const bool final = circle_inside_slab(block[corners[0]], block[corners[1]], block[corners[2]], borders[b], borders[b + 1]);
+                                 if (final)
+                                 {
+                                   final_index[b][t] = finals++;
+                                 }
+                                 for (int i = 0; i < 3; i++)
+                                 {
+                                   if (!final || local.neighbours[3 * t + i] < 0)
+                                   {
+                                     seam[corners[(i + 1) % 3]] = 1;
+                                     seam[corners[(i + 2) % 3]] = 1;
+                                   }
+                                 }
+                               }
+                               final_counts[b + 1] = finals;
+
+                               for (size_t i = 0; i < ids.size(); i++)
+                               {
+                                 if (seam[i])
+                                 {
+                                   seam_points[b].push_back(ids[i]);
+                                 }
+                               } }, "delaunay_block");
+
+    for (int b = 0; b < blocks; b++)
+    {
+      final_counts[b + 1] += final_counts[b];
+    }
+    const size_t num_finals = final_counts[blocks];
+
+    // The edges on the border of the final triangles, counterclockwise around them.
+    std::unordered_map<uint64_t, size_t> final_border;
+    for (int b = 0; b < blocks; b++)
+    {
+      const DelaunayTriangulation &local = locals[b];
+      const std::vector<uint32_t> &ids = members[b];
+      for (size_t t = 0; t < local.triangles.size(); t++)
+      {
+        if (final_index[b][t] < 0)
+        {
+          continue;
+        }
+        const int corners[3] = {local.triangles[t].a, local.triangles[t].b, local.triangles[t].c};
+        for (int i = 0; i < 3; i++)
+        {
+          const int n = local.neighbours[3 * t + i];
+          if (n < 0 || final_index[b][n] < 0)
+          {
+            const size_t global = final_counts[b] + final_index[b][t];
+            final_border[edge_key(ids[corners[(i + 1) % 3]], ids[corners[(i + 2) % 3]])] = 3 * global + i;
+          }
+        }
+      }
+    }
+
+    // Triangulate the seams, with the global indices of the points.
+    std::vector<uint32_t> seam_ids;
+    for (int b = 0; b < blocks; b++)
+    {
+      seam_ids.insert(seam_ids.end(), seam_points[b].begin(), seam_points[b].end());
+    }
+    std::vector<Point2> seam(seam_ids.size());
+    for (size_t i = 0; i < seam_ids.size(); i++)
+    {
+      seam[i] = points[seam_ids[i]];
+    }
+    DelaunayTriangulation seams;
+    delaunay(seam.data(), seam.size(), seams);
+    for (Triangle &t : seams.triangles)
+    {
+      t = {static_cast<int>(seam_ids[t.a]), static_cast<int>(seam_ids[t.b]), static_cast<int>(seam_ids[t.c])};
+    }
+
+    std::unordered_map<uint64_t, size_t> seam_edges(3 * seams.triangles.size());
+    for (size_t t = 0; t < seams.triangles.size(); t++)
+    {
+      const int corners[3] = {seams.triangles[t].a, seams.triangles[t].b, seams.triangles[t].c};
+      for (int i = 0; i < 3; i++)
+      {
+        seam_edges[edge_key(corners[(i + 1) % 3], corners[(i + 2) % 3])] = 3 * t + i;
+      }
+    }
+
+    // Keep the seam triangles on the outer side of the border of the final ones, and the ones
+    // connected to them without crossing it.
+    std::vector<int> kept(seams.triangles.size(), num_finals == 0 ? 0 : -1);
+    std::vector<size_t> stack;
+    for (const std::pair<const uint64_t, size_t> &edge : final_border)
+    {
+      const int from = static_cast<int>(edge.first >> 32);
+      const int to = static_cast<int>(edge.first & 0xffffffffu);
+      if (seam_edges.count(edge_key(from, to)) == 0)
+      {
+        // Only with points the predicates can't separate, start again in a single block.
+        delaunay(points, count, triangulation);
+        return;
+      }
+      const size_t outside = seam_edges.find(edge_key(to, from)) != seam_edges.end() ? seam_edges[edge_key(to, from)] / 3 : SIZE_MAX;
+      if (outside != SIZE_MAX && kept[outside] < 0)
+      {
+        kept[outside] = 0;
+        stack.push_back(outside);
+      }
+    }
+    while (!stack.empty())
+    {
+      const size_t t = stack.back();
+      stack.pop_back();
+      const int corners[3] = {seams.triangles[t].a, seams.triangles[t].b, seams.triangles[t].c};
+      for (int i = 0; i < 3; i++)
+      {
+        const int n = seams.neighbours[3 * t + i];
+        if (n >= 0 && kept[n] < 0 && final_border.count(edge_key(corners[(i + 2) % 3], corners[(i + 1) % 3])) == 0)
+        {
+          kept[n] = 0;
+          stack.push_back(n);
+        }
+      }
+    }
+
+    size_t num_kept = 0;
+    for (int &k : kept)
+    {
+      k = k == 0 ? static_cast<int>(num_finals + num_kept++) : -1;
+    }
+
+    // The final triangles first, then the kept seam ones, linked together along the border.
+    triangulation.triangles.resize(num_finals + num_kept);
+    triangulation.neighbours.resize(3 * (num_finals + num_kept));
+
+    parallel::for_each_chunk(blocks, blocks, [&](int b, size_t, size_t)
+                             {
+                               const DelaunayTriangulation &local = locals[b];
+                               const std::vector<uint32_t> &ids = members[b];
+                               for (size_t t = 0; t < local.triangles.size(); t++)
+                               {
+                                 if (final_index[b][t] < 0)
+                                 {
+                                   continue;
+                                 }
+                                 const size_t global = final_counts[b] + final_index[b][t];
+                                 const Triangle &tri = local.triangles[t];
+                                 triangulation.triangles[global] = {static_cast<int>(ids[tri.a]), static_cast<int>(ids[tri.b]), static_cast<int>(ids[tri.c])};
+                                 for (int i = 0; i < 3; i++)
+                                 {
+                                   const int n = local.neighbours[3 * t + i];
+                                   triangulation.neighbours[3 * global + i] = n >= 0 && final_index[b][n] >= 0 ? static_cast<int>(final_counts[b] + final_index[b][n]) : -1;
+                                 }
+                               } }, "delaunay_merge");
+
+    for (size_t t = 0; t < seams.triangles.size(); t++)
+    {
+      if (kept[t] < 0)
+      {
+        continue;
+      }
+      triangulation.triangles[kept[t]] = seams.triangles[t];
+      for (int i = 0; i < 3; i++)
+      {
+        const int n = seams.neighbours[3 * t + i];
+        triangulation.neighbours[3 * kept[t] + i] = n >= 0 ? kept[n] : -1;
+      }
+    }
+
+    for (const std::pair<const uint64_t, size_t> &edge : final_border)
+    {
+      const int from = static_cast<int>(edge.first >> 32);
+      const int to = static_cast<int>(edge.first & 0xffffffffu);
+      auto outside = seam_edges.find(edge_key(to, from));
+      if (outside != seam_edges.end() && kept[outside->second / 3] >= 0)
+      {
+        const size_t t = kept[outside->second / 3];
+        triangulation.neighbours[edge.second] = static_cast<int>(t);
+        triangulation.neighbours[3 * t + outside->second % 3] = static_cast<int>(edge.second / 3);
+      }
+    }
+  }
+
+  /**
+   * @brief Build a mesh from the Delaunay triangulation of points, in the plane z = 0 (terrain
+   * heights are kept but don't change the triangulation).
+   *
+   * The half-edges are created per triangle and their twins are taken from the neighbours of the
+   * triangulation; the edges of the convex hull have no twin, as in Mesh::createMesh. Large point
+   * sets are triangulated in parallel blocks and their objects are created in parallel chunks.
+   *
+   * @param points The points, each one becomes a vertex of the mesh.
+   * @param id The id of the mesh.
+   * @param threads The number of threads, 0 for one per thread of the scheduler.
+   * @return Core::Mesh* The new mesh.
+   */
+  Core::Mesh *delaunay_mesh(const std::vector<Core::Vertex::Vertex> &points, std::string id, int threads)
+  {
+    std::vector<Point2> plane(points.size());
+    for (size_t i = 0; i < points.size(); i++)
+    {
+      plane[i] = {points[i].x, points[i].y};
+    }
+
+    if (threads <= 0)
+    {
+      threads = parallel::Scheduler::instance().getThreads();
+    }
+    const int chunks = points.size() < PARALLEL_DELAUNAY_MIN_POINTS ? 1 : threads;
+
+    DelaunayTriangulation triangulation;
+    delaunay_parallel(plane.data(), plane.size(), triangulation, chunks);
+    const size_t num_triangles = triangulation.triangles.size();
+
+    // The first half-edge leaving each vertex, set before the chunks so they don't race for it.
+    std::vector<int64_t> first_edge(points.size(), -1);
+    for (size_t t = num_triangles; t-- > 0;)
+    {
+      first_edge[triangulation.triangles[t].a] = 3 * t;
+      first_edge[triangulation.triangles[t].b] = 3 * t + 1;
+      first_edge[triangulation.triangles[t].c] = 3 * t + 2;
+    }
+
+    std::vector<Core::Vector *> vertexes(points.size());
+    parallel::for_each_chunk(points.size(), chunks, [&](int, size_t begin, size_t end)
+                             {
+                               for (size_t i = begin; i < end; i++)
+                               {
+                                 vertexes[i] = new Core::Vector(points[i].x, points[i].y, points[i].z, 1.0, nullptr, "v" + std::to_string(i));
+                               } }, "delaunay_mesh");
+
+    std::vector<Core::Face *> faces(num_triangles);
+    std::vector<Core::HalfEdge *> mesh(3 * num_triangles);
+    parallel::for_each_chunk(num_triangles, chunks, [&](int, size_t begin, size_t end)
+                             {
+                               for (size_t t = begin; t < end; t++)
+                               {
+                                 faces[t] = new Core::Face();
+                                 faces[t]->setId("f" + std::to_string(t));
+                                 for (int i = 0; i < 3; i++)
+                                 {
+                                   mesh[3 * t + i] = new Core::HalfEdge();
+                                   mesh[3 * t + i]->setId("he" + std::to_string(3 * t + i));
+                                 }
+                               } }, "delaunay_mesh");
+
+    parallel::for_each_chunk(num_triangles, chunks, [&](int, size_t begin, size_t end)
+                             {
+                               for (size_t t = begin; t < end; t++)
+                               {
+                                 const geometry::Triangle &tri = triangulation.triangles[t];
+                                 const int corners[3] = {tri.a, tri.b, tri.c};
+                                 std::vector<Core::HalfEdge *> edges(mesh.begin() + 3 * t, mesh.begin() + 3 * t + 3);
+
+                                 for (int i = 0; i < 3; i++)
+                                 {
+                                   // The half-edge i goes from the corner i to the next one, opposite to the corner after.
+                                   Core::HalfEdge *he = edges[i];
+                                   he->setOrigin(vertexes[corners[i]]);
+                                   if (first_edge[corners[i]] == static_cast<int64_t>(3 * t + i))
+                                   {
+                                     vertexes[corners[i]]->setHalfEdge(he);
+                                   }
+                                   he->setNext(edges[(i + 1) % 3]);
+                                   he->setPrev(edges[(i + 2) % 3]);
+                                   he->setFace(faces[t]);
+
+                                   const int n = triangulation.neighbours[3 * t + (i + 2) % 3];
+                                   if (n >= 0)
+                                   {
+                                     const geometry::Triangle &other = triangulation.triangles[n];
+                                     const int other_corners[3] = {other.a, other.b, other.c};
+                                     for (int j = 0; j < 3; j++)
+                                     {
+                                       if (other_corners[j] == corners[(i + 1) % 3])
+                                       {
+                                         he->setTwin(mesh[3 * n + j]);
+                                       }
+                                     }
+                                   }
+                                 }
+
+                                 faces[t]->setHalfEdge(edges[0]);
+                                 faces[t]->setEdges(edges);
+                               } }, "delaunay_mesh");
+
+    Core::Mesh *result = new Core::Mesh();
+    result->setVertexes(vertexes);
+    result->setMesh(mesh);
+    result->setFaces(faces);
+    result->setNumFaces(static_cast<int>(num_triangles));
+    result->setId(id);
+    return result;
+  }
+} // namespace geometry
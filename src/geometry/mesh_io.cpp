@@ -0,0 +1,132 @@
+#include <geometry/mesh_io.hpp>
+#include <geometry/delaunay.hpp>
+#include <core/face.hpp>
+#include <core/half_edge.hpp>
+#include <core/mesh.hpp>
+#include <core/vector.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+
+namespace geometry
+{
+  /**
+   * @brief Read a point cloud (a terrain scan) from a text file with one "x y z" point per line.
+   *
+   * The file is read at once and parsed with strtod, streams are too slow for millions of points.
+   * Lines that don't start with three numbers (headers, comments) are skipped, anything after the
+   * third number (intensities, colors) is ignored.
+   *
+   * @param path The path of the file.
+   * @return std::vector<Core::Vertex::Vertex> The points, empty if the file can't be read.
+   */
+  std::vector<Core::Vertex::Vertex> read_xyz(const std::string &path)
+  {
+    std::vector<Core::Vertex::Vertex> points;
+
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+      return points;
+    }
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    std::string text(size > 0 ? size : 0, '\0');
+    const size_t read = std::fread(text.data(), 1, text.size(), file);
+    std::fclose(file);
+    text.resize(read);
+
+    const char *cursor = text.c_str();
+    const char *end = cursor + text.size();
+    while (cursor < end)
+    {
+      const char *line_end = cursor;
+      while (line_end < end && *line_end != '\n')
+      {
+        line_end++;
+      }
+
+      double values[3];
+      int parsed = 0;
+      const char *number = cursor;
+      while (parsed < 3)
+      {
+        char *after;
+        values[parsed] = std::strtod(number, &after);
+        if (after == number || after > line_end)
+        {
+          break;
+        }
+        number = after;
+        parsed++;
+      }
+      if (parsed == 3)
+      {
+        points.push_back({values[0], values[1], values[2]});
+      }
+
+      cursor = line_end + 1;
+    }
+    return points;
+  }
+
+  /**
+   * @brief Write a mesh to a Wavefront OBJ file, its vertexes and the loops of its faces
+   *
+   * @param mesh The mesh.
+   * @param path The path of the file.
+   * @return true If the file was written.
+   * @return false If the file can't be opened.
+   */
+  bool write_obj(const Core::Mesh *mesh, const std::string &path)
+  {
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (file == nullptr)
+    {
+      return false;
+    }
+
+    const std::vector<Core::Vector *> vertexes = mesh->getVertexes();
+    std::unordered_map<const Core::Vector *, size_t> index(vertexes.size());
+    for (size_t i = 0; i < vertexes.size(); i++)
+    {
+      const Core::Vertex::Vertex v = vertexes[i]->getVertex();
+      std::fprintf(file, "v %.17g %.17g %.17g\n", v.x, v.y, v.z);
+      index[vertexes[i]] = i + 1;
+    }
+
+    for (Core::Face *face : mesh->getFaces())
+    {
+      std::fputc('f', file);
+      Core::HalfEdge *first = face->getHalfEdge();
+      Core::HalfEdge *he = first;
+      do
+      {
+        std::fprintf(file, " %zu", index[he->getOrigin()]);
+        he = he->getNext();
+      } while (he != first && he != nullptr);
+      std::fputc('\n', file);
+    }
+
+    return std::fclose(file) == 0;
+  }
+
+  /**
+   * @brief Read a point cloud and build the mesh of its Delaunay triangulation
+   *
+   * @param path The path of the "x y z" file.
+   * @param id The id of the mesh.
+   * @return Core::Mesh* The new mesh, nullptr if the file can't be read.
+   */
+  Core::Mesh *read_xyz_delaunay(const std::string &path, std::string id)
+  {
+    const std::vector<Core::Vertex::Vertex> points = read_xyz(path);
+    if (points.empty())
+    {
+      return nullptr;
+    }
+    return delaunay_mesh(points, id);
+  }
+} // namespace geometry
@@ -0,0 +1,221 @@
+#include <geometry/predicates.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace geometry
+{
+  // Half an ulp of 1, the relative error of a rounded operation
+  static const double EPSILON = 1.1102230246251565e-16;
+  // Bounds of the error of the floating-point determinants, relative to their permanents
+  static const double ORIENT_ERROR_BOUND = (3.0 + 16.0 * EPSILON) * EPSILON;
+  static const double INCIRCLE_ERROR_BOUND = (10.0 + 96.0 * EPSILON) * EPSILON;
+
+  // A sum of doubles that don't overlap, sorted by increasing magnitude, the exact value of a
+  // determinant is computed with them when the floating-point one is too close to 0.
+  typedef std::vector<double> Expansion;
+
+  /**
+   * @brief a + b = x + y exactly, with x the rounded sum
+   *
+   */
+  static inline void two_sum(double a, double b, double &x, double &y)
+  {
+    x = a + b;
+    const double b_virtual = x - a;
+    const double a_virtual = x - b_virtual;
+    y = (a - a_virtual) + (b - b_virtual);
+  }
+
+  /**
+   * @brief a * b = x + y exactly, with x the rounded product
+   *
+   */
+  static inline void two_product(double a, double b, double &x, double &y)
+  {
+    x = a * b;
+    y = std::fma(a, b, -x);
+  }
+
+  /**
+   * @brief The exact difference a - b, as an expansion
+   *
+   */
+  static Expansion difference(double a, double b)
+  {
+    double x, y;
+    two_sum(a, -b, x, y);
+    return y != 0.0 ? Expansion{y, x} : Expansion{x};
+  }
+
+  /**
+   * @brief The exact sum of two expansions, adding the components of f one by one
+   *
+   */
+  static Expansion sum(const Expansion &e, const Expansion &f)
+  {
+    Expansion result = e;
+    Expansion grown;
+    for (double b : f)
+    {
+      grown.clear();
+      double q = b;
+      for (double component : result)
+      {
+        double h;
+        two_sum(q, component, q, h);
+        if (h != 0.0)
+        {
+          grown.push_back(h);
+        }
+      }
+      if (q != 0.0 || grown.empty())
+      {
+        grown.push_back(q);
+      }
+      result.swap(grown);
+    }
+    return result;
+  }
+
+  /**
+   * @brief The exact product of an expansion by a double
+   *
+   */
+  static Expansion scale(const Expansion &e, double b)
+  {
+    Expansion result;
+    double q, h;
+    two_product(e[0], b, q, h);
+    if (h != 0.0)
+    {
+      result.push_back(h);
+    }
+
+    for (size_t i = 1; i < e.size(); i++)
+    {
+      double product, product_error, s;
+      two_product(e[i], b, product, product_error);
+      two_sum(q, product_error, s, h);
+      if (h != 0.0)
+      {
+        result.push_back(h);
+      }
+      two_sum(product, s, q, h);
+      if (h != 0.0)
+      {
+        result.push_back(h);
+      }
+    }
+
+    if (q != 0.0 || result.empty())
+    {
+      result.push_back(q);
+    }
+    return result;
+  }
+
+  /**
+   * @brief The exact product of two expansions
+   *
+   */
+  static Expansion product(const Expansion &e, const Expansion &f)
+  {
+    Expansion result = scale(e, f[0]);
+    for (size_t i = 1; i < f.size(); i++)
+    {
+      result = sum(result, scale(e, f[i]));
+    }
+    return result;
+  }
+
+  static Expansion negate(Expansion e)
+  {
+    for (double &component : e)
+    {
+      component = -component;
+    }
+    return e;
+  }
+
+  /**
+   * @brief The orientation of the triangle (a, b, c), exact in sign.
+   *
+   * The determinant is evaluated in floating-point first, and again with exact arithmetic only
+   * when it is smaller than its error bound (when the points are almost collinear).
+   *
+   * @return double Positive if the triangle turns counterclockwise, negative if it turns clockwise
+   * and 0 if the points are collinear. Only the sign is exact.
+   */
+  double orient2d(const Point2 &a, const Point2 &b, const Point2 &c)
+  {
+    const double left = (a.x - c.x) * (b.y - c.y);
+    const double right = (a.y - c.y) * (b.x - c.x);
+    const double det = left - right;
+    if (std::fabs(det) > ORIENT_ERROR_BOUND * (std::fabs(left) + std::fabs(right)))
+    {
+      return det;
+    }
+
+    const Expansion exact = sum(product(difference(a.x, c.x), difference(b.y, c.y)),
+                                negate(product(difference(a.y, c.y), difference(b.x, c.x))));
+    return exact.back();
+  }
+
+  /**
+   * @brief Where d is relative to the circle through a, b and c, exact in sign.
+   *
+   * The determinant is evaluated in floating-point first, and again with exact arithmetic only
+   * when it is smaller than its error bound (when the points are almost cocircular).
+   *
+   * @param a, b, c The points of the circle, counterclockwise.
+   * @param d The point tested.
+   * @return double Positive if d is inside the circle, negative if it is outside and 0 if it is
+   * on it. Only the sign is exact.
+   */
+  double incircle(const Point2 &a, const Point2 &b, const Point2 &c, const Point2 &d)
+  {
+    const double adx = a.x - d.x;
+    const double ady = a.y - d.y;
+    const double bdx = b.x - d.x;
+    const double bdy = b.y - d.y;
+    const double cdx = c.x - d.x;
+    const double cdy = c.y - d.y;
+
+    const double bdxcdy = bdx * cdy;
+    const double cdxbdy = cdx * bdy;
+    const double cdxady = cdx * ady;
+    const double adxcdy = adx * cdy;
+    const double adxbdy = adx * bdy;
+    const double bdxady = bdx * ady;
+    const double alift = adx * adx + ady * ady;
+    const double blift = bdx * bdx + bdy * bdy;
+    const double clift = cdx * cdx + cdy * cdy;
+
+    const double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    const double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * alift +
+                             (std::fabs(cdxady) + std::fabs(adxcdy)) * blift +
+                             (std::fabs(adxbdy) + std::fabs(bdxady)) * clift;
+    if (std::fabs(det) > INCIRCLE_ERROR_BOUND * permanent)
+    {
+      return det;
+    }
+
+    const Expansion eadx = difference(a.x, d.x);
+    const Expansion eady = difference(a.y, d.y);
+    const Expansion ebdx = difference(b.x, d.x);
+    const Expansion ebdy = difference(b.y, d.y);
+    const Expansion ecdx = difference(c.x, d.x);
+    const Expansion ecdy = difference(c.y, d.y);
+
+    const Expansion ealift = sum(product(eadx, eadx), product(eady, eady));
+    const Expansion eblift = sum(product(ebdx, ebdx), product(ebdy, ebdy));
+    const Expansion eclift = sum(product(ecdx, ecdx), product(ecdy, ecdy));
+    const Expansion bc = sum(product(ebdx, ecdy), negate(product(ecdx, ebdy)));
+    const Expansion ca = sum(product(ecdx, eady), negate(product(eadx, ecdy)));
+    const Expansion ab = sum(product(eadx, ebdy), negate(product(ebdx, eady)));
+
+    const Expansion exact = sum(sum(product(ealift, bc), product(eblift, ca)), product(eclift, ab));
+    return exact.back();
+  }
+} // namespace geometry
@@ -0,0 +1,208 @@
+#include <geometry/simplify.hpp>
+#include <core/face.hpp>
+#include <core/half_edge.hpp>
+#include <core/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+namespace geometry
+{
+  /**
+   * @brief The corners of the bounding box of some vertexes
+   *
+   */
+  static void bounds(const std::vector<Core::Vector *> &vertexes, Core::Vertex::Vertex &low, Core::Vertex::Vertex &high)
+  {
+    low = vertexes[0]->getVertex();
+    high = low;
+    for (Core::Vector *v : vertexes)
+    {
+      const Core::Vertex::Vertex p = v->getVertex();
+      low = {std::min(low.x, p.x), std::min(low.y, p.y), std::min(low.z, p.z)};
+      high = {std::max(high.x, p.x), std::max(high.y, p.y), std::max(high.z, p.z)};
+    }
+  }
+
+  // The vertexes of a mesh merged by cells: the cluster of each vertex, and the sum and the
+  // number of the vertexes of each cluster
+  typedef struct
+  {
+    std::unordered_map<Core::Vector *, int> cluster_of;
+    std::vector<Core::Vertex::Vertex> sums;
+    std::vector<int> counts;
+  } Clusters;
+
+  /**
+   * @brief Merge the vertexes of a mesh by the cubic cells of its bounding box they fall in
+   *
+   */
+  static void cluster_vertexes(const std::vector<Core::Vector *> &vertexes, const Core::Vertex::Vertex &low, const Core::Vertex::Vertex &high, double cell,
+                               Clusters &clusters)
+  {
+    // The cell coordinates take 21 bits each, so the cells of a vertex are packed in one key.
+    const double max_cells = static_cast<double>((1 << 21) - 1);
+    double side = std::max({cell, (high.x - low.x) / max_cells, (high.y - low.y) / max_cells, (high.z - low.z) / max_cells});
+    if (side <= 0)
+    {
+      // A cell of no size on a box of no size: the vertexes are all on one point, a single cell
+      // of any size holds them.
+      side = 1.0;
+    }
+    auto cell_of = [&](double p, double origin)
+    {
+      return static_cast<uint64_t>(std::floor((p - origin) / side));
+    };
+
+    std::unordered_map<uint64_t, int> cells;
+    clusters.cluster_of.clear();
+    clusters.sums.clear();
+    clusters.counts.clear();
+    clusters.cluster_of.reserve(vertexes.size());
+
+    for (Core::Vector *v : vertexes)
+    {
+      const Core::Vertex::Vertex p = v->getVertex();
+      const uint64_t key = cell_of(p.x, low.x) << 42 | cell_of(p.y, low.y) << 21 | cell_of(p.z, low.z);
+      auto [entry, added] = cells.try_emplace(key, static_cast<int>(clusters.sums.size()));
+      if (added)
+      {
+        clusters.sums.push_back({0, 0, 0});
+        clusters.counts.push_back(0);
+      }
+
+      const int c = entry->second;
+      Core::Vertex::Vertex &sum = clusters.sums[c];
+      sum = {sum.x + p.x, sum.y + p.y, sum.z + p.z};
+      clusters.counts[c]++;
+      clusters.cluster_of[v] = c;
+    }
+  }
+
+  /**
+   * @brief Build the mesh of the clusters of a mesh: a vertex at the mean of each cluster, and the
+   * faces that keep at least 3 of them
+   *
+   */
+  static Core::Mesh *merge_clusters(const Core::Mesh *mesh, const Clusters &clusters, std::string id)
+  {
+    std::vector<Core::Vector *> merged(clusters.sums.size());
+    for (size_t c = 0; c < clusters.sums.size(); c++)
+    {
+      const Core::Vertex::Vertex &sum = clusters.sums[c];
+      const double inv = 1.0 / clusters.counts[c];
+      merged[c] = new Core::Vector(sum.x * inv, sum.y * inv, sum.z * inv, 1.0, nullptr, id + "_v" + std::to_string(c));
+    }
+
+    // Walk the loop of each face through the clusters, dropping the edges merged into a point.
+    std::vector<std::vector<int>> faces;
+    std::vector<int> loop;
+    for (Core::Face *face : mesh->getFaces())
+    {
+      Core::HalfEdge *first = face->getHalfEdge();
+      Core::HalfEdge *he = first;
+      loop.clear();
+      do
+      {
+        const int c = clusters.cluster_of.at(he->getOrigin());
+        if (loop.empty() || loop.back() != c)
+        {
+          loop.push_back(c);
+        }
+        he = he->getNext();
+      } while (he != first && he != nullptr);
+
+      if (loop.size() > 1 && loop.back() == loop.front())
+      {
+        loop.pop_back();
+      }
+      if (loop.size() >= 3)
+      {
+        faces.push_back(loop);
+      }
+    }
+
+    return new Core::Mesh(merged, faces, id);
+  }
+
+  /**
+   * @brief Simplify a mesh by vertex clustering.
+   *
+   * The bounding box of the mesh is split in cubic cells and the vertexes of each cell are merged
+   * into their mean. The faces keep their loops through the merged vertexes, the ones left with
+   * less than 3 of them are dropped. No vertex moves farther than the diagonal of a cell, and the
+   * mesh is simplified in linear time, whatever its topology.
+   *
+   * @param mesh The mesh, it is not changed.
+   * @param cell The side of the cells.
+   * @param id The id of the simplified mesh.
+   * @return Core::Mesh* The simplified mesh, with vertexes of its own.
+   */
+  Core::Mesh *simplify_mesh(const Core::Mesh *mesh, double cell, std::string id)
+  {
+    const std::vector<Core::Vector *> &vertexes = mesh->getVertexes();
+    if (vertexes.empty())
+    {
+      return new Core::Mesh({}, {}, id);
+    }
+
+    Core::Vertex::Vertex low, high;
+    bounds(vertexes, low, high);
+    Clusters clusters;
+    cluster_vertexes(vertexes, low, high, cell, clusters);
+    return merge_clusters(mesh, clusters, id);
+  }
+
+  /**
+   * @brief Build the levels of detail of a mesh, each one simplified from the mesh itself on a grid
+   * twice as coarse as the level before. The levels that barely reduce the one before are skipped.
+   *
+   * @param mesh The mesh.
+   * @param levels The number of levels to try.
+   * @return std::vector<Core::MeshLod> The levels, from the finest to the coarsest, with the diagonal
+   * of their cells as their error.
+   */
+  std::vector<Core::MeshLod> build_lods(const Core::Mesh *mesh, int levels)
+  {
+    std::vector<Core::MeshLod> lods;
+    const std::vector<Core::Vector *> &vertexes = mesh->getVertexes();
+    if (vertexes.empty())
+    {
+      return lods;
+    }
+
+    Core::Vertex::Vertex low, high;
+    bounds(vertexes, low, high);
+    const double extent = std::max({high.x - low.x, high.y - low.y, high.z - low.z});
+    if (extent <= 0)
+    {
+      return lods;
+    }
+
+    Clusters clusters;
+    size_t previous = vertexes.size();
+    for (int level = 0; level < levels; level++)
+    {
+      const int cells = LOD_FINEST_CELLS >> level;
+      if (cells < 1)
+      {
+        break;
+      }
+
+      // The clusters are counted first, so the levels skipped never build a mesh.
+      const double cell = extent / cells;
+      cluster_vertexes(vertexes, low, high, cell, clusters);
+      if (clusters.sums.size() > LOD_MIN_REDUCTION * previous)
+      {
+        continue;
+      }
+
+      Core::Mesh *lod = merge_clusters(mesh, clusters, mesh->getId() + "_lod" + std::to_string(lods.size() + 1));
+      lods.push_back({lod, cell * std::sqrt(3.0)});
+      previous = clusters.sums.size();
+    }
+    return lods;
+  }
+} // namespace geometry
@@ -0,0 +1,751 @@
+#include <geometry/triangulation.hpp>
+#include <core/face.hpp>
+#include <core/half_edge.hpp>
+#include <core/mesh.hpp>
+#include <core/vector.hpp>
+#include <parallel/scheduler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+namespace geometry
+{
+  /**
+   * @brief Twice the signed area of a polygon, positive if its vertices turn counterclockwise.
+   *
+   */
+  static double signed_area(const Point2 *points, int count)
+  {
+    double area = 0.0;
+    for (int i = 0, j = count - 1; i < count; j = i++)
+    {
+      area += (points[j].x - points[i].x) * (points[j].y + points[i].y);
+    }
+    return area;
+  }
+
+  /**
+   * @brief Check if p is inside of the counterclockwise triangle (a, b, c) or on its border.
+   *
+   */
+  static inline bool in_triangle(const Point2 &a, const Point2 &b, const Point2 &c, const Point2 &p)
+  {
+    return orient(a, b, p) >= 0 && orient(b, c, p) >= 0 && orient(c, a, p) >= 0;
+  }
+
+  static inline bool same_point(const Point2 &a, const Point2 &b)
+  {
+    return a.x == b.x && a.y == b.y;
+  }
+
+  /**
+   * @brief Triangulate a simple polygon by clipping its ears, in O(n^2) for n vertices.
+   *
+   * A vertex is an ear if it is convex and no other vertex lies in the triangle it forms with its
+   * neighbours; clipping it leaves a simple polygon with one vertex less. Degenerate polygons may
+   * run out of ears, then a vertex is clipped anyway, so there are always count - 2 triangles.
+   *
+   * @param points The vertices of the polygon, in either orientation.
+   * @param count The number of vertices, at least 3.
+   * @param triangles Filled with count - 2 triangles, with the orientation of the polygon.
+   * @return true If every clipped vertex was an ear.
+   * @return false If the polygon is degenerate and some triangles may overlap.
+   */
+  bool ear_clipping(const Point2 *points, int count, Triangle *triangles)
+  {
+    const double sign = signed_area(points, count) < 0 ? -1.0 : 1.0;
+
+    std::vector<int> prev(count);
+    std::vector<int> next(count);
+    for (int i = 0; i < count; i++)
+    {
+      prev[i] = (i + count - 1) % count;
+      next[i] = (i + 1) % count;
+    }
+
+    bool valid = true;
+    int written = 0;
+    int remaining = count;
+    int misses = 0;
+    int v = 0;
+
+    while (remaining > 3)
+    {
+      const int p = prev[v];
+      const int n = next[v];
+
+      // The triangle counterclockwise, whatever the orientation of the polygon.
+      const Point2 &a = points[p];
+      const Point2 &b = points[v];
+      const Point2 &c = points[n];
+      bool ear = sign * orient(a, b, c) > 0;
+
+      for (int u = next[n]; ear && u != p; u = next[u])
+      {
+        const Point2 &q = points[u];
+        if (same_point(q, a) || same_point(q, b) || same_point(q, c))
+        {
+          continue;
+        }
+        ear = sign > 0 ? !in_triangle(a, b, c, q) : !in_triangle(c, b, a, q);
+      }
+
+      // A whole turn without an ear: the polygon is degenerate, clip the vertex anyway.
+      if (ear || misses > remaining)
+      {
+        valid = valid && ear;
+        triangles[written++] = {p, v, n};
+        next[p] = n;
+        prev[n] = p;
+        remaining--;
+        misses = 0;
+        v = n;
+      }
+      else
+      {
+        misses++;
+        v = n;
+      }
+    }
+
+    triangles[written] = {prev[v], v, next[v]};
+    return valid;
+  }
+
+  // The vertex kinds of the sweep of a monotone decomposition, going down the polygon
+  enum class SweepVertex
+  {
+    START,
+    END,
+    SPLIT,
+    MERGE,
+    REGULAR_LEFT,
+    REGULAR_RIGHT
+  };
+
+  /**
+   * @brief Triangulate a y-monotone piece of a polygon with the stack algorithm, in O(m log m).
+   *
+   */
+  static void triangulate_monotone(const std::vector<Point2> &points, const std::vector<int> &piece,
+                                   std::vector<Triangle> &triangles)
+  {
+    const int m = static_cast<int>(piece.size());
+    auto above = [&](int i, int j)
+    {
+      const Point2 &a = points[piece[i]];
+      const Point2 &b = points[piece[j]];
+      return a.y > b.y || (a.y == b.y && a.x < b.x);
+    };
+    auto emit = [&](int i, int j, int k)
+    {
+      Triangle t = {piece[i], piece[j], piece[k]};
+      if (orient(points[t.a], points[t.b], points[t.c]) < 0)
+      {
+        std::swap(t.b, t.c);
+      }
+      triangles.push_back(t);
+    };
+
+    if (m == 3)
+    {
+      emit(0, 1, 2);
+      return;
+    }
+
+    // The piece is counterclockwise, so going forward from the top vertex walks down its left chain.
+    int top = 0;
+    int bottom = 0;
+    for (int i = 1; i < m; i++)
+    {
+      top = above(i, top) ? i : top;
+      bottom = above(bottom, i) ? i : bottom;
+    }
+    std::vector<bool> left(m, false);
+    for (int i = top; i != bottom; i = (i + 1) % m)
+    {
+      left[i] = true;
+    }
+
+    std::vector<int> order(m);
+    for (int i = 0; i < m; i++)
+    {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), above);
+
+    std::vector<int> stack = {order[0], order[1]};
+    for (int j = 2; j < m - 1; j++)
+    {
+      const int u = order[j];
+
+      if (left[u] != left[stack.back()])
+      {
+        // The other chain: u sees every vertex on the stack.
+        for (size_t i = 0; i + 1 < stack.size(); i++)
+        {
+          emit(u, stack[i], stack[i + 1]);
+        }
+        stack = {order[j - 1], u};
+      }
+      else
+      {
+        // The same chain: cut the triangles that are inside, while the chain is convex.
+        int last = stack.back();
+        stack.pop_back();
+        while (!stack.empty())
+        {
+          const Point2 &a = points[piece[stack.back()]];
+          const Point2 &b = points[piece[last]];
+          const Point2 &c = points[piece[u]];
+          if ((left[u] ? orient(a, b, c) : orient(c, b, a)) <= 0)
+          {
+            break;
+          }
+          emit(u, last, stack.back());
+          last = stack.back();
+          stack.pop_back();
+        }
+        stack.push_back(last);
+        stack.push_back(u);
+      }
+    }
+
+    for (size_t i = 0; i + 1 < stack.size(); i++)
+    {
+      emit(order[m - 1], stack[i], stack[i + 1]);
+    }
+  }
+
+  /**
+   * @brief Triangulate a simple polygon by decomposing it into y-monotone pieces, in O(n log n).
+   *
+   * A sweep line goes down the polygon, keeping the edges that have the inside of the polygon to
+   * their right sorted by x, with the lowest vertex seen so far between each of them and the next
+   * one (its helper). Diagonals are added at the split and merge vertices, where the polygon is
+   * not monotone, which cuts it in monotone pieces that are triangulated with a stack.
+   *
+   * @param points The vertices of the polygon, in either orientation.
+   * @param count The number of vertices, at least 3.
+   * @param triangles Filled with count - 2 triangles, with the orientation of the polygon.
+   * @return true If the polygon was triangulated.
+   * @return false If the polygon is degenerate (not simple, or with repeated vertices); the
+   * triangles are left undefined.
+   */
+  bool monotone_triangulation(const Point2 *input, int count, Triangle *triangles)
+  {
+    // Work on a counterclockwise copy of the polygon.
+    const double area = signed_area(input, count);
+    const bool reversed = area < 0;
+    std::vector<Point2> points(count);
+    for (int i = 0; i < count; i++)
+    {
+      points[i] = input[reversed ? count - 1 - i : i];
+    }
+
+    auto above = [&](int i, int j)
+    {
+      return points[i].y > points[j].y || (points[i].y == points[j].y && points[i].x < points[j].x);
+    };
+    auto prev = [&](int i)
+    {
+      return (i + count - 1) % count;
+    };
+    auto next = [&](int i)
+    {
+      return (i + 1) % count;
+    };
+
+    double sweep_y = 0.0;
+
+    // The edges crossed by the sweep line sorted by x, the order doesn't change while they are in.
+    struct EdgeLess
+    {
+      using is_transparent = void;
+      const std::vector<Point2> *points;
+      const double *sweep_y;
+
+      // The x of the edge i, from the vertex i to the next one, on the horizontal line at y.
+      double x_at(int edge, double y) const
+      {
+        const Point2 &a = (*points)[edge];
+        const Point2 &b = (*points)[(edge + 1) % points->size()];
+        if (a.y == b.y)
+        {
+          return std::min(a.x, b.x);
+        }
+        return a.x + (y - a.y) / (b.y - a.y) * (b.x - a.x);
+      }
+
+      bool operator()(int e1, int e2) const
+      {
+        const double x1 = x_at(e1, *sweep_y);
+        const double x2 = x_at(e2, *sweep_y);
+        if (x1 != x2)
+        {
+          return x1 < x2;
+        }
+        // Edges from the same vertex are ordered below it.
+        const int n = static_cast<int>(points->size());
+        const double y = std::max(std::min((*points)[e1].y, (*points)[(e1 + 1) % n].y),
+                                  std::min((*points)[e2].y, (*points)[(e2 + 1) % n].y));
+        const double below1 = x_at(e1, y);
+        const double below2 = x_at(e2, y);
+        return below1 != below2 ? below1 < below2 : e1 < e2;
+      }
+      bool operator()(int e, double x) const
+      {
+        return x_at(e, *sweep_y) < x;
+      }
+      bool operator()(double x, int e) const
+      {
+        return x < x_at(e, *sweep_y);
+      }
+    };
+    std::set<int, EdgeLess> status(EdgeLess{&points, &sweep_y});
+    std::vector<int> helper(count, -1);
+    std::vector<SweepVertex> kinds(count);
+    std::vector<std::pair<int, int>> diagonals;
+
+    for (int i = 0; i < count; i++)
+    {
+      const bool prev_below = above(i, prev(i));
+      const bool next_below = above(i, next(i));
+      const bool convex = orient(points[prev(i)], points[i], points[next(i)]) > 0;
+
+      if (prev_below && next_below)
+      {
+        kinds[i] = convex ? SweepVertex::START : SweepVertex::SPLIT;
+      }
+      else if (!prev_below && !next_below)
+      {
+        kinds[i] = convex ? SweepVertex::END : SweepVertex::MERGE;
+      }
+      else
+      {
+        // Going down the polygon (previous vertex above) the inside is on the right.
+        kinds[i] = prev_below ? SweepVertex::REGULAR_LEFT : SweepVertex::REGULAR_RIGHT;
+      }
+    }
+
+    std::vector<int> order(count);
+    for (int i = 0; i < count; i++)
+    {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), above);
+
+    // The edge directly left of a vertex, -1 if there is none (the polygon is degenerate).
+    auto left_of = [&](int v)
+    {
+      auto it = status.lower_bound(points[v].x);
+      return it == status.begin() ? -1 : *std::prev(it);
+    };
+    auto connect_merge = [&](int v, int edge)
+    {
+      if (helper[edge] >= 0 && kinds[helper[edge]] == SweepVertex::MERGE)
+      {
+        diagonals.push_back({v, helper[edge]});
+      }
+    };
+
+    for (int v : order)
+    {
+      sweep_y = points[v].y;
+      const int e = v;
+      const int e_prev = prev(v);
+
+      switch (kinds[v])
+      {
+      case SweepVertex::START:
+        helper[e] = v;
+        status.insert(e);
+        break;
+      case SweepVertex::END:
+        connect_merge(v, e_prev);
+        status.erase(e_prev);
+        break;
+      case SweepVertex::SPLIT:
+      {
+        const int left = left_of(v);
+        if (left < 0)
+        {
+          return false;
+        }
+        diagonals.push_back({v, helper[left]});
+        helper[left] = v;
+        helper[e] = v;
+        status.insert(e);
+        break;
+      }
+      case SweepVertex::MERGE:
+      {
+        connect_merge(v, e_prev);
+        status.erase(e_prev);
+        const int left = left_of(v);
+        if (left < 0)
+        {
+          return false;
+        }
+        connect_merge(v, left);
+        helper[left] = v;
+        break;
+      }
+      case SweepVertex::REGULAR_RIGHT:
+        connect_merge(v, e_prev);
+        status.erase(e_prev);
+        helper[e] = v;
+        status.insert(e);
+        break;
+      case SweepVertex::REGULAR_LEFT:
+      {
+        const int left = left_of(v);
+        if (left < 0)
+        {
+          return false;
+        }
+        connect_merge(v, left);
+        helper[left] = v;
+        break;
+      }
+      }
+    }
+
+    // Walk the pieces: the neighbours of each vertex sorted counterclockwise, a piece continues
+    // from the edge (u, v) to the neighbour of v just clockwise from u.
+    std::vector<std::vector<int>> neighbours(count);
+    for (int i = 0; i < count; i++)
+    {
+      neighbours[i] = {prev(i), next(i)};
+    }
+    for (const std::pair<int, int> &d : diagonals)
+    {
+      if (d.first == d.second || d.first == prev(d.second) || d.first == next(d.second))
+      {
+        return false;
+      }
+      neighbours[d.first].push_back(d.second);
+      neighbours[d.second].push_back(d.first);
+    }
+    std::vector<std::vector<bool>> visited(count);
+    for (int i = 0; i < count; i++)
+    {
+      const Point2 &center = points[i];
+      std::sort(neighbours[i].begin(), neighbours[i].end(), [&](int a, int b)
+                { return std::atan2(points[a].y - center.y, points[a].x - center.x) <
+                         std::atan2(points[b].y - center.y, points[b].x - center.x); });
+      visited[i].assign(neighbours[i].size(), false);
+      // The edges going backwards along the border are outside.
+      const size_t back = std::find(neighbours[i].begin(), neighbours[i].end(), prev(i)) - neighbours[i].begin();
+      visited[i][back] = true;
+    }
+
+    std::vector<Triangle> output;
+    output.reserve(count - 2);
+    std::vector<int> piece;
+    for (int start = 0; start < count; start++)
+    {
+      for (size_t k = 0; k < neighbours[start].size(); k++)
+      {
+        if (visited[start][k])
+        {
+          continue;
+        }
+
+        piece.clear();
+        int u = start;
+        size_t edge = k;
+        while (!visited[u][edge])
+        {
+          visited[u][edge] = true;
+          piece.push_back(u);
+          const int v = neighbours[u][edge];
+          const std::vector<int> &around = neighbours[v];
+          const size_t from = std::find(around.begin(), around.end(), u) - around.begin();
+          edge = (from + around.size() - 1) % around.size();
+          u = v;
+        }
+
+        if (piece.size() < 3 || u != start || static_cast<int>(output.size() + piece.size() - 2) > count - 2)
+        {
+          return false;
+        }
+        triangulate_monotone(points, piece, output);
+      }
+    }
+
+    // A degenerate polygon can give pieces that overlap or aren't monotone, check the area.
+    double covered = 0.0;
+    for (const Triangle &t : output)
+    {
+      covered += std::fabs(orient(points[t.a], points[t.b], points[t.c]));
+    }
+    if (static_cast<int>(output.size()) != count - 2 || std::fabs(covered - std::fabs(area)) > 1e-9 * std::fabs(area))
+    {
+      return false;
+    }
+
+    // Back to the indices and the orientation of the input.
+    for (int i = 0; i < count - 2; i++)
+    {
+      Triangle t = output[i];
+      if (reversed)
+      {
+        t = {count - 1 - t.a, count - 1 - t.c, count - 1 - t.b};
+      }
+      triangles[i] = t;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Triangulate a simple polygon: directly for triangles and quads, by ear clipping up to
+   * EAR_CLIPPING_MAX_VERTICES vertices and by monotone decomposition above.
+   *
+   * @param points The vertices of the polygon, in either orientation.
+   * @param count The number of vertices, at least 3.
+   * @param triangles Filled with count - 2 triangles, with the orientation of the polygon.
+   */
+  void triangulate_polygon(const Point2 *points, int count, Triangle *triangles)
+  {
+    if (count == 3)
+    {
+      triangles[0] = {0, 1, 2};
+    }
+    else if (count == 4)
+    {
+      // Split along the diagonal through the reflex vertex, if there is one.
+      const double sign = signed_area(points, count) < 0 ? -1.0 : 1.0;
+      const bool reflex_1 = sign * orient(points[0], points[1], points[2]) < 0;
+      const bool reflex_3 = sign * orient(points[2], points[3], points[0]) < 0;
+      if (reflex_1 || reflex_3)
+      {
+        triangles[0] = {0, 1, 3};
+        triangles[1] = {1, 2, 3};
+      }
+      else
+      {
+        triangles[0] = {0, 1, 2};
+        triangles[1] = {0, 2, 3};
+      }
+    }
+    else if (count > EAR_CLIPPING_MAX_VERTICES && monotone_triangulation(points, count, triangles))
+    {
+      return;
+    }
+    else
+    {
+      ear_clipping(points, count, triangles);
+    }
+  }
+
+  /**
+   * @brief Project the half-edge loop of a face to the plane of its two coordinates that vary
+   * the most, dropping the dominant axis of its Newell normal.
+   *
+   * @param face The face, its loop starts at its half-edge.
+   * @param points Filled with one point per vertex of the loop.
+   */
+  void project_face(const Core::Face *face, std::vector<Point2> &points)
+  {
+    // The Newell normal, accumulated while walking the loop so it isn't copied.
+    Core::Vertex::Vertex n = {0, 0, 0};
+    Core::HalfEdge *first = face->getHalfEdge();
+    Core::HalfEdge *he = first;
+    do
+    {
+      Core::HalfEdge *next = he->getNext() != nullptr ? he->getNext() : first;
+      const Core::Vertex::Vertex a = he->getOrigin()->getVertex();
+      const Core::Vertex::Vertex b = next->getOrigin()->getVertex();
+      n.x += (a.y - b.y) * (a.z + b.z);
+      n.y += (a.z - b.z) * (a.x + b.x);
+      n.z += (a.x - b.x) * (a.y + b.y);
+      he = he->getNext();
+    } while (he != first && he != nullptr);
+
+    const double ax = std::fabs(n.x);
+    const double ay = std::fabs(n.y);
+    const double az = std::fabs(n.z);
+
+    points.clear();
+    he = first;
+    do
+    {
+      const Core::Vertex::Vertex v = he->getOrigin()->getVertex();
+      if (az >= ax && az >= ay)
+      {
+        points.push_back({v.x, v.y});
+      }
+      else if (ax >= ay)
+      {
+        points.push_back({v.y, v.z});
+      }
+      else
+      {
+        points.push_back({v.z, v.x});
+      }
+      he = he->getNext();
+    } while (he != first && he != nullptr);
+  }
+
+  /**
+   * @brief Triangulate every face of a mesh.
+   *
+   * The loops are counted first, so the triangles of each face have a fixed place in the output
+   * and the faces are then triangulated in parallel chunks without any synchronization.
+   *
+   * @param mesh The mesh, its faces are assumed simple (but may be concave).
+   * @param triangulation Filled with the triangles of each face, the corners are the positions in
+   * the loop of the face, starting at its half-edge.
+   * @param threads The number of threads, 0 for one per thread of the scheduler. Small meshes use one.
+   */
+  void triangulate_mesh(const Core::Mesh *mesh, MeshTriangulation &triangulation, int threads)
+  {
+    const std::vector<Core::Face *> faces = mesh->getFaces();
+
+    triangulation.topology_version = mesh->getTopologyVersion();
+    triangulation.offsets.assign(faces.size() + 1, 0);
+    for (size_t f = 0; f < faces.size(); f++)
+    {
+      int count = 0;
+      Core::HalfEdge *first = faces[f]->getHalfEdge();
+      Core::HalfEdge *he = first;
+      do
+      {
+        count++;
+        he = he->getNext();
+      } while (he != first && he != nullptr);
+
+      triangulation.offsets[f + 1] = triangulation.offsets[f] + std::max(count - 2, 0);
+    }
+    triangulation.triangles.resize(triangulation.offsets.back());
+
+    if (threads <= 0)
+    {
+      threads = parallel::Scheduler::instance().getThreads();
+    }
+    const int chunks = faces.size() < PARALLEL_TRIANGULATION_MIN_FACES ? 1 : threads;
+
+    parallel::for_each_chunk(faces.size(), chunks, [&](int, size_t begin, size_t end)
+                             {
+                               std::vector<Point2> points;
+                               for (size_t f = begin; f < end; f++)
+                               {
+                                 const uint32_t offset = triangulation.offsets[f];
+                                 if (triangulation.offsets[f + 1] == offset)
+                                 {
+                                   continue;
+                                 }
+                                 project_face(faces[f], points);
+                                 triangulate_polygon(points.data(), static_cast<int>(points.size()), triangulation.triangles.data() + offset);
+                               } }, "triangulate_mesh");
+  }
+
+  /**
+   * @brief Construct a new empty TriangulationCache object, using every thread of the scheduler
+   *
+   */
+  TriangulationCache::TriangulationCache()
+  {
+    this->setThreads(0);
+  }
+
+  /**
+   * @brief Construct a new empty TriangulationCache object
+   *
+   * @param threads The number of threads meshes are triangulated with, 0 for one per thread of the scheduler
+   */
+  TriangulationCache::TriangulationCache(int threads)
+  {
+    this->setThreads(threads);
+  }
+
+  /**
+   * @brief Copy constructor of TriangulationCache object
+   *
+   * @param c The TriangulationCache to be copied
+   */
+  TriangulationCache::TriangulationCache(const TriangulationCache &c)
+  {
+    *this = c;
+  }
+
+  TriangulationCache::~TriangulationCache()
+  {
+  }
+
+  /**
+   * @brief Get the number of threads meshes are triangulated with
+   *
+   * @return int The number of threads, 0 for one per thread of the scheduler
+   */
+  int TriangulationCache::getThreads() const
+  {
+    return this->threads;
+  }
+
+  /**
+   * @brief Set the number of threads meshes are triangulated with
+   *
+   * @param threads The number of threads, 0 for one per thread of the scheduler
+   */
+  void TriangulationCache::setThreads(int threads)
+  {
+    this->threads = threads;
+  }
+
+  /**
+   * @brief Get the triangulation of a mesh, computing it if the mesh is new or its topology changed
+   *
+   * @param mesh The mesh
+   * @return const MeshTriangulation& The triangles of each face, valid until the next call
+   */
+  const MeshTriangulation &TriangulationCache::get(const Core::Mesh *mesh)
+  {
+    auto it = this->meshes.find(mesh);
+    if (it == this->meshes.end())
+    {
+      it = this->meshes.emplace(mesh, MeshTriangulation{{}, {}, 0}).first;
+    }
+
+    if (it->second.offsets.empty() || it->second.topology_version != mesh->getTopologyVersion())
+    {
+      triangulate_mesh(mesh, it->second, this->threads);
+    }
+    return it->second;
+  }
+
+  /**
+   * @brief Forget the triangulation of a mesh, when it is removed from the scene
+   *
+   * @param mesh The mesh
+   */
+  void TriangulationCache::erase(const Core::Mesh *mesh)
+  {
+    this->meshes.erase(mesh);
+  }
+
+  /**
+   * @brief Forget the triangulations of all meshes
+   *
+   */
+  void TriangulationCache::clear()
+  {
+    this->meshes.clear();
+  }
+
+  /**
+   * @brief Assignment operator of TriangulationCache object
+   *
+   * @param c The TriangulationCache to be copied
+   * @return TriangulationCache& A reference to this TriangulationCache
+   */
+  TriangulationCache &TriangulationCache::operator=(const TriangulationCache &c)
+  {
+    this->meshes = c.meshes;
+    this->threads = c.threads;
+    return *this;
+  }
+} // namespace geometry
@@ -8,9 +8,15 @@
 #include <core/vector.hpp>
 #include <pipeline/pipeline.hpp>
 #include <math/math.hpp>
+#include <render/framebuffer.hpp>
+#include <render/render_worker.hpp>
+#include <render/renderer.hpp>
 
 #include <core/camera.hpp>
 
+#include <utility>
+#include <vector>
+
 namespace gui
 {
   class Canvas
@@ -18,6 +24,24 @@ namespace gui
   public:
     Core::Scene *scene;
     sf::RenderWindow *window;
+    // The settings the scene is rendered with, the worker renders it with a renderer of its own
+    render::Renderer *renderer;
+    // Renders the scene away from the UI thread, so the events are handled while it projects
+    render::RenderWorker *worker;
+    // The frames finished by the worker are uploaded to this texture
+    sf::Texture texture;
+    // The rendered scene, kept between frames and drawn under ImGui while nothing changes
+    sf::RenderTexture cache;
+    // Set when something the versions below don't track changed: the renderer settings, the
+    // vertexes of a mesh
+    bool dirty;
+    // The camera and the meshes the cached scene was rendered with, and their versions
+    const Core::Camera *cached_camera;
+    uint64_t cached_view_version;
+    uint64_t cached_projection_version;
+    uint64_t cached_screen_version;
+    uint64_t cached_transform_version;
+    std::vector<std::pair<Core::Mesh *, uint64_t>> cached_meshes;
 
     Canvas()
     {
@@ -57,85 +81,22 @@ namespace gui
 
       Core::Mesh *mesh = new Core::Mesh({v0, v1, v2, v3, v4, v5, v6, v7}, faces, "cube");
 
-      std::vector<std::vector<double>> sru2src = pipeline::santa_catarina::sru2src(
-          this->scene->getCamera()->getVRP(),
-          this->scene->getCamera()->getP());
-
-      for (auto &m : sru2src)
-      {
-        for (auto &n : m)
-        {
-          std::cout << n << "\t\t ";
-        }
-        std::cout << std::endl;
-      }
-
-      std::cout << "-------------" << std::endl;
-
-      std::vector<std::vector<double>> proj = pipeline::santa_catarina::projection(
-          this->scene->getCamera()->getVRP(),
-          this->scene->getCamera()->getP(),
-          this->scene->getCamera()->getD());
-
-      for (auto &m : proj)
-      {
-        for (auto &n : m)
-        {
-          std::cout << n << "\t\t ";
-        }
-        std::cout << std::endl;
-      }
-
-      std::vector<std::vector<double>> src2srd = pipeline::santa_catarina::src2srt(
-          this->scene->getCamera()->getWindow(),
-          this->scene->getCamera()->getViewPort(), true);
-
-      std::cout << "-------------" << std::endl;
-
-      for (auto &m : src2srd)
-      {
-        for (auto &n : m)
-        {
-          std::cout << n << "\t\t ";
-        }
-        std::cout << std::endl;
-      }
-
-      std::cout << "-------------" << std::endl;
-
-      std::vector<std::vector<double>> aux = Math::multiply_matrix(src2srd, proj);
-      std::vector<std::vector<double>> m = Math::multiply_matrix(aux, sru2src);
-
-      for (auto &m : m)
-      {
-        for (auto &n : m)
-        {
-          std::cout << n << "\t\t ";
-        }
-        std::cout << std::endl;
-      }
-
       this->scene->addObject(mesh);
 
-      for (auto &mesh : this->scene->getObjects())
-      {
-        for (auto &v : mesh->getVertexes())
-        {
-          std::cout << "Before: " << *v << std::endl;
-          Math::apply_matrix(v, m);
-          v->setX(v->getX() / v->getH());
-          v->setY(v->getY() / v->getH());
-          v->setH(v->getH() / v->getH());
-
-          std::cout << "After: " << *v << std::endl;
-        }
-      }
+      this->renderer = new render::Renderer();
+      this->worker = new render::RenderWorker();
+      this->dirty = true;
+      this->cached_camera = nullptr;
     }
 
     Canvas(Core::Scene *scene, sf::RenderWindow *window)
     {
       this->scene = scene;
       this->window = window;
+      this->renderer = new render::Renderer();
+      this->worker = new render::RenderWorker();
+      this->dirty = true;
+      this->cached_camera = nullptr;
     }
 
     Core::Scene *getScene()
@@ -148,9 +109,61 @@ namespace gui
       return this->window;
     }
 
+    render::Renderer *getRenderer()
+    {
+      return this->renderer;
+    }
+
+    render::RenderWorker *getWorker()
+    {
+      return this->worker;
+    }
+
     void setScene(Core::Scene *scene)
     {
       this->scene = scene;
+      this->dirty = true;
+    }
+
+    // Render the scene again on the next draw, after a change the canvas can't see
+    void invalidate()
+    {
+      this->dirty = true;
+    }
+
+    // Whether the worker is rendering a frame or has one the canvas didn't show yet
+    bool isRendering()
+    {
+      return this->worker->isBusy() || this->worker->hasFrame();
+    }
+
+    // Whether the cached scene is out of date: the camera moved, a mesh was added, removed, moved or
+    // changed its topology, or the canvas was invalidated
+    bool isDirty()
+    {
+      Core::Camera *camera = this->scene->getCamera();
+      if (this->dirty || camera != this->cached_camera ||
+          camera->getViewVersion() != this->cached_view_version ||
+          camera->getProjectionVersion() != this->cached_projection_version ||
+          camera->getScreenVersion() != this->cached_screen_version ||
+          this->scene->getTransformVersion() != this->cached_transform_version)
+      {
+        return true;
+      }
+
+      std::vector<Core::Mesh *> meshes = this->scene->getObjects();
+      if (meshes.size() != this->cached_meshes.size())
+      {
+        return true;
+      }
+      for (size_t i = 0; i < meshes.size(); i++)
+      {
+        if (meshes[i] != this->cached_meshes[i].first || meshes[i]->getTopologyVersion() != this->cached_meshes[i].second)
+        {
+          return true;
+        }
+      }
+      return false;
     }
 
     void setWindow(sf::RenderWindow *window)
@@ -160,25 +173,60 @@ namespace gui
 
     void draw()
     {
-      for (auto &mesh : this->scene->getObjects())
+      sf::Vector2u size = this->window->getSize();
+
+      // Keep the cache the same size as the window.
+      if (this->cache.getSize() != size)
+      {
+        this->cache.create(size.x, size.y);
+        this->cache.clear();
+        this->dirty = true;
+      }
+
+      // Only render the scene when it changed, the worker replaces the frames it didn't start.
+      if (this->isDirty())
+      {
+        Core::Camera *camera = this->scene->getCamera();
+        render::RenderRequest request = {*camera,
+                                         this->scene->getObjects(),
+                                         this->scene->getObjectTransforms(),
+                                         this->renderer->getPipeline(),
+                                         this->renderer->getShadingMode(),
+                                         this->renderer->getVisibilityMode(),
+                                         this->renderer->getOcclusionCulling(),
+                                         static_cast<int>(size.x),
+                                         static_cast<int>(size.y)};
+        this->worker->submit(request);
+
+        this->cached_camera = camera;
+        this->cached_view_version = camera->getViewVersion();
+        this->cached_projection_version = camera->getProjectionVersion();
+        this->cached_screen_version = camera->getScreenVersion();
+        this->cached_transform_version = this->scene->getTransformVersion();
+        this->cached_meshes.clear();
+        for (Core::Mesh *mesh : this->scene->getObjects())
+        {
+          this->cached_meshes.push_back({mesh, mesh->getTopologyVersion()});
+        }
+        this->dirty = false;
+      }
+
+      // Show the last finished frame, the previous one is drawn again until then.
+      const render::FrameBuffer *frame = this->worker->takeFrame();
+      if (frame != nullptr)
       {
-        for (auto &f : mesh->getFaces())
+        sf::Vector2u frame_size(frame->getWidth(), frame->getHeight());
+        if (this->texture.getSize() != frame_size)
         {
-          Core::HalfEdge *he = f->getHalfEdge();
-          while (true)
-          {
-            utils::draw_vertex(he->getOrigin()->getVertex(), *this->getWindow());
-            utils::draw_half_edge(*he, *this->getWindow());
-
-            he = he->getNext();
-
-            if (he == f->getHalfEdge())
-            {
-              break;
-            }
-          }
+          this->texture.create(frame_size.x, frame_size.y);
         }
+        this->texture.update(frame->getPixels());
+        this->cache.clear();
+        this->cache.draw(sf::Sprite(this->texture));
+        this->cache.display();
       }
+
+      this->window->draw(sf::Sprite(this->cache.getTexture()));
     };
   };
 } // namespace gui
\ No newline at end of file
@@ -4,10 +4,20 @@
 
 #include <core/vector.hpp>
 
+#include <algorithm>
+
 #include <utils/sfml-utils.hpp>
 
 #include "./gui/canvas.cpp"
 
+// How far the camera turns and pans for each pixel the mouse is dragged, and zooms for each step
+// of the wheel
+const double ORBIT_RADIANS_PER_PIXEL = 0.01;
+const double PAN_DISTANCE_PER_PIXEL = 0.002;
+const double ZOOM_PER_WHEEL_STEP = 0.1;
+// ImGui needs a few frames after an event to settle (hover, focus, popups) before the loop sleeps
+const int IMGUI_SETTLE_FRAMES = 3;
+
 int main()
 {
   // Create SFML window
@@ -31,6 +41,11 @@ int main()
 
   canvas->setWindow(&window);
 
+  // The step given to the camera by the mouse, reused for every event.
+  Core::Vector *camera_step = new Core::Vector();
+  int mouse_x = 0;
+  int mouse_y = 0;
+
   // // Triangle vertices
   // sf::VertexArray triangle(sf::Triangles, 3);
   // triangle[0].position = sf::Vector2f(400, 100);
@@ -40,22 +55,83 @@ int main()
   // triangle[1].color = sf::Color::Green;
   // triangle[2].color = sf::Color::Blue;
 
+  // Frames left before the loop waits for the next event, when the scene is not dirty either
+  int settle_frames = IMGUI_SETTLE_FRAMES;
+  sf::Clock frame_clock;
+
+  auto handle_event = [&](const sf::Event &event)
+  {
+    ImGui::SFML::ProcessEvent(event);
+    settle_frames = IMGUI_SETTLE_FRAMES;
+
+    if (event.type == sf::Event::Closed)
+    {
+      window.close();
+    }
+
+    // Orbit around P with the left button, pan with the right one and zoom with the wheel,
+    // unless the mouse is over an ImGui window.
+    Core::Scene *scene = canvas->getScene();
+    if (!ImGui::GetIO().WantCaptureMouse)
+    {
+      if (event.type == sf::Event::MouseMoved && sf::Mouse::isButtonPressed(sf::Mouse::Left))
+      {
+        camera_step->setX(-(event.mouseMove.y - mouse_y) * ORBIT_RADIANS_PER_PIXEL);
+        camera_step->setY(-(event.mouseMove.x - mouse_x) * ORBIT_RADIANS_PER_PIXEL);
+        camera_step->setZ(0);
+        scene->rotateCamera(camera_step);
+      }
+      else if (event.type == sf::Event::MouseMoved && sf::Mouse::isButtonPressed(sf::Mouse::Right))
+      {
+        // The scene follows the mouse at the distance of P.
+        const double scale = Math::length(scene->getCamera()->getVRP(), scene->getCamera()->getP()) * PAN_DISTANCE_PER_PIXEL;
+        camera_step->setX(-(event.mouseMove.x - mouse_x) * scale);
+        camera_step->setY((event.mouseMove.y - mouse_y) * scale);
+        camera_step->setZ(0);
+        scene->moveCamera(camera_step);
+      }
+      else if (event.type == sf::Event::MouseWheelScrolled)
+      {
+        camera_step->setX(0);
+        camera_step->setY(0);
+        camera_step->setZ(-event.mouseWheelScroll.delta * ZOOM_PER_WHEEL_STEP);
+        scene->zoomCamera(camera_step);
+      }
+    }
+    if (event.type == sf::Event::MouseMoved)
+    {
+      mouse_x = event.mouseMove.x;
+      mouse_y = event.mouseMove.y;
+    }
+  };
+
   // Main loop
   while (window.isOpen() && isOpen)
   {
     sf::Event event;
-    while (window.pollEvent(event))
-    {
-      ImGui::SFML::ProcessEvent(event);
 
-      if (event.type == sf::Event::Closed)
+    // When nothing changed, sleep until the next event instead of drawing the same frame again.
+    // While the worker renders, keep polling so its frame is shown as soon as it is finished.
+    if (settle_frames == 0 && !canvas->isDirty() && !canvas->isRendering())
+    {
+      if (!window.waitEvent(event))
       {
-        window.close();
+        break;
       }
+      handle_event(event);
+    }
+    while (window.pollEvent(event))
+    {
+      handle_event(event);
+    }
+    if (!window.isOpen())
+    {
+      break;
     }
+    settle_frames = std::max(0, settle_frames - 1);
 
-    // Start the ImGui frame
-    ImGui::SFML::Update(window, sf::seconds(1.0f / 60.0f));
+    // Start the ImGui frame, with the time since the last frame (the loop may have slept)
+    ImGui::SFML::Update(window, frame_clock.restart());
 
     // Display the fps in the screen
     ImGui::Text("FPS: %f", ImGui::GetIO().Framerate);
@@ -72,6 +148,11 @@ int main()
                 canvas->scene->getCamera()->getP().x,
                 canvas->scene->getCamera()->getP().y,
                 canvas->scene->getCamera()->getP().z);
+    // show the value of the up vector
+    ImGui::Text("Up: (%f, %f, %f)",
+                canvas->scene->getCamera()->getUp().x,
+                canvas->scene->getCamera()->getUp().y,
+                canvas->scene->getCamera()->getUp().z);
     // show the value of d
     ImGui::Text("D: %f", canvas->scene->getCamera()->getD());
     // show the value of view port
@@ -87,6 +168,39 @@ int main()
                 canvas->scene->getCamera()->getWindow()[2],
                 canvas->scene->getCamera()->getWindow()[3]);
 
+    // choose the shading model of the renderer
+    int shading_mode = static_cast<int>(canvas->getRenderer()->getShadingMode());
+    if (ImGui::Combo("Shading", &shading_mode, "Wireframe\0Flat\0Gouraud\0Phong\0"))
+    {
+      canvas->getRenderer()->setShadingMode(static_cast<render::ShadingMode>(shading_mode));
+      canvas->invalidate();
+    }
+
+    // choose the pipeline the scene is projected with
+    int pipeline_kind = static_cast<int>(canvas->getRenderer()->getPipeline());
+    if (ImGui::Combo("Pipeline", &pipeline_kind, "Santa Catarina\0Madeiras Pereira\0"))
+    {
+      canvas->getRenderer()->setPipeline(static_cast<pipeline::PipelineKind>(pipeline_kind));
+      canvas->invalidate();
+    }
+
+    // choose between the z-buffer and the painter's algorithm (hidden lines in wireframe mode)
+    int visibility_mode = static_cast<int>(canvas->getRenderer()->getVisibilityMode());
+    if (ImGui::Combo("Visibility", &visibility_mode, "Z-buffer\0Painter\0"))
+    {
+      canvas->getRenderer()->setVisibilityMode(static_cast<render::VisibilityMode>(visibility_mode));
+      canvas->invalidate();
+    }
+
+    // skip the meshes hidden behind the ones drawn in the last frame
+    bool occlusion_culling = canvas->getRenderer()->getOcclusionCulling();
+    if (ImGui::Checkbox("Occlusion culling", &occlusion_culling))
+    {
+      canvas->getRenderer()->setOcclusionCulling(occlusion_culling);
+      canvas->invalidate();
+    }
+    ImGui::Text("Culled meshes: %d", canvas->getWorker()->getCulledMeshes());
+
     // Rendering
     window.clear();
 
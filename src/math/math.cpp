@@ -181,6 +181,19 @@ namespace Math
     return result;
   }
 
+  /**
+   * @brief A function that normalizes a vertex using fast_rsqrt instead of a square root and a division.
+   *
+   * The result has a length within 0.001% of 1, which is enough for shading.
+   *
+   * @param v The vertex to normalize.
+   * @return Core::Vertex::Vertex The normalized vertex.
+   */
+  Core::Vertex::Vertex fast_normalize(Core::Vertex::Vertex v)
+  {
+    return dot(fast_rsqrt(static_cast<float>(dot(v, v))), v);
+  }
+
   /**
    * @brief A function that calculates the cross product of two vectors.
    *
@@ -217,6 +230,32 @@ namespace Math
     return result;
   }
 
+  /**
+   * @brief A function that calculates the normal of a polygon using Newell's method.
+   *
+   * Unlike the cross product of two edges, this works for polygons with any number of vertices and
+   * is not affected by collinear consecutive vertices. The result is not normalized.
+   *
+   * @param polygon The vertices of the polygon, in order.
+   * @return Core::Vertex::Vertex The (non normalized) normal of the polygon.
+   */
+  Core::Vertex::Vertex newell_normal(const std::vector<Core::Vertex::Vertex> &polygon)
+  {
+    Core::Vertex::Vertex normal = {0, 0, 0};
+
+    for (size_t i = 0; i < polygon.size(); i++)
+    {
+      const Core::Vertex::Vertex &current = polygon[i];
+      const Core::Vertex::Vertex &next = polygon[(i + 1) % polygon.size()];
+
+      normal.x += (current.y - next.y) * (current.z + next.z);
+      normal.y += (current.z - next.z) * (current.x + next.x);
+      normal.z += (current.x - next.x) * (current.y + next.y);
+    }
+
+    return normal;
+  }
+
   /**
    * @brief A function that multiplies two matrices.
    *
@@ -267,4 +306,96 @@ namespace Math
     v->setZ(result[2][0]);
     v->setH(result[3][0]);
   }
+
+  /**
+   * @brief A function that returns the 4x4 identity matrix.
+   *
+   * @return Matrix4 The identity matrix.
+   */
+  Matrix4 identity_matrix()
+  {
+    Matrix4 result = {};
+    for (int i = 0; i < 4; i++)
+    {
+      result[i][i] = 1;
+    }
+    return result;
+  }
+
+  /**
+   * @brief A function that converts a 4x4 std::vector matrix to a Matrix4.
+   *
+   * @param m The matrix, it must have at least 4 rows and 4 columns.
+   * @return Matrix4 The same matrix, with a fixed size.
+   */
+  Matrix4 to_matrix4(const std::vector<std::vector<double>> &m)
+  {
+    Matrix4 result;
+    for (int i = 0; i < 4; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        result[i][j] = m[i][j];
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief A function that converts a Matrix4 to a std::vector matrix.
+   *
+   * @param m The matrix.
+   * @return std::vector<std::vector<double>> The same matrix, as 4 rows of 4 columns.
+   */
+  std::vector<std::vector<double>> to_matrix(const Matrix4 &m)
+  {
+    std::vector<std::vector<double>> result(4, std::vector<double>(4));
+    for (int i = 0; i < 4; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        result[i][j] = m[i][j];
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief A function that multiplies two 4x4 matrices.
+   *
+   * @param m1 The first matrix.
+   * @param m2 The second matrix.
+   * @return Matrix4 The product m1 * m2.
+   */
+  Matrix4 multiply_matrix(const Matrix4 &m1, const Matrix4 &m2)
+  {
+    Matrix4 result;
+    for (int i = 0; i < 4; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        result[i][j] = m1[i][0] * m2[0][j] + m1[i][1] * m2[1][j] + m1[i][2] * m2[2][j] + m1[i][3] * m2[3][j];
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief A function that applies a 4x4 matrix to a vector.
+   *
+   * @param v The vector.
+   * @param m The matrix.
+   */
+  void apply_matrix(Core::Vector *v, const Matrix4 &m)
+  {
+    double x = v->getX();
+    double y = v->getY();
+    double z = v->getZ();
+    double h = v->getH();
+
+    v->setX(m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3] * h);
+    v->setY(m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3] * h);
+    v->setZ(m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3] * h);
+    v->setH(m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3] * h);
+  }
 } // namespace Math
\ No newline at end of file
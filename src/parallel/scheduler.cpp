@@ -0,0 +1,298 @@
+#include <parallel/scheduler.hpp>
+
+#include <algorithm>
+
+namespace parallel
+{
+  // The scheduler of the worker running on this thread and its index, -1 on the other threads
+  static thread_local const Scheduler *current_scheduler = nullptr;
+  static thread_local int current_worker = -1;
+
+  /**
+   * @brief Construct a new TaskGroup object on the shared scheduler
+   *
+   */
+  TaskGroup::TaskGroup() : TaskGroup(&Scheduler::instance())
+  {
+  }
+
+  /**
+   * @brief Construct a new TaskGroup object
+   *
+   * @param scheduler The scheduler its tasks are queued on
+   */
+  TaskGroup::TaskGroup(Scheduler *scheduler)
+  {
+    this->scheduler = scheduler;
+    this->pending = 0;
+  }
+
+  /**
+   * @brief Destroy the TaskGroup object, after its tasks are finished
+   *
+   */
+  TaskGroup::~TaskGroup()
+  {
+    this->wait();
+  }
+
+  /**
+   * @brief Fork a task, it may run on any thread of the scheduler
+   *
+   * @param task The function to be run.
+   * @param name The name of the task, for the profiling hook.
+   */
+  void TaskGroup::run(std::function<void()> task, const char *name)
+  {
+    this->pending.fetch_add(1, std::memory_order_relaxed);
+    this->scheduler->spawn(this, std::move(task), name);
+  }
+
+  /**
+   * @brief Join the tasks of the group, running queued tasks until they are finished
+   *
+   */
+  void TaskGroup::wait()
+  {
+    while (this->pending.load(std::memory_order_acquire) > 0)
+    {
+      if (!this->scheduler->runTask())
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  /**
+   * @brief Construct a new Scheduler object, with one thread per hardware thread
+   *
+   */
+  Scheduler::Scheduler() : Scheduler(0)
+  {
+  }
+
+  /**
+   * @brief Construct a new Scheduler object and start its workers
+   *
+   * @param threads The number of threads running tasks, counting the thread waiting for them, 0
+   * for one per hardware thread.
+   */
+  Scheduler::Scheduler(int threads)
+  {
+    if (threads <= 0)
+    {
+      threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    this->queued = 0;
+    this->stopping = false;
+    this->profiling = false;
+    for (int i = 0; i < threads; i++)
+    {
+      this->queues.push_back(std::make_unique<TaskQueue>());
+    }
+    for (int i = 0; i < threads - 1; i++)
+    {
+      this->workers.emplace_back(&Scheduler::work, this, i);
+    }
+  }
+
+  /**
+   * @brief Destroy the Scheduler object, after the queued tasks are finished
+   *
+   */
+  Scheduler::~Scheduler()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->sleep_mutex);
+      this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (std::thread &worker : this->workers)
+    {
+      worker.join();
+    }
+  }
+
+  /**
+   * @brief The scheduler shared by the editor, started on first use
+   *
+   */
+  Scheduler &Scheduler::instance()
+  {
+    static Scheduler scheduler;
+    return scheduler;
+  }
+
+  /**
+   * @brief Get the number of threads running tasks, the workers and a waiting thread
+   *
+   */
+  int Scheduler::getThreads() const
+  {
+    return static_cast<int>(this->workers.size()) + 1;
+  }
+
+  /**
+   * @brief Get the index of the worker running on the calling thread
+   *
+   * @return int The index, -1 if the thread is not one of the workers.
+   */
+  int Scheduler::getWorkerIndex() const
+  {
+    return current_scheduler == this ? current_worker : -1;
+  }
+
+  /**
+   * @brief Set the function called after each task with its name, thread and times.
+   *
+   * It is called on the thread that ran the task, so it must be thread safe, and must be set
+   * while no task is queued. An empty function turns the profiling off.
+   *
+   * @param hook The profiling hook.
+   */
+  void Scheduler::setProfileHook(ProfileHook hook)
+  {
+    this->profile_hook = std::move(hook);
+    this->profiling = static_cast<bool>(this->profile_hook);
+  }
+
+  /**
+   * @brief The queue the calling thread forks into: its own for a worker, the shared one otherwise
+   *
+   */
+  int Scheduler::ownQueue() const
+  {
+    const int worker = this->getWorkerIndex();
+    return worker >= 0 ? worker : static_cast<int>(this->workers.size());
+  }
+
+  /**
+   * @brief Queue a task of a group and wake a sleeping worker
+   *
+   * @param group The group waiting for the task.
+   * @param function The function to be run.
+   * @param name The name of the task, for the profiling hook.
+   */
+  void Scheduler::spawn(TaskGroup *group, std::function<void()> function, const char *name)
+  {
+    TaskQueue &queue = *this->queues[this->ownQueue()];
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks.push_back({std::move(function), group, name});
+    }
+    this->queued.fetch_add(1);
+
+    // Taking the lock orders the count before a worker checks it and goes to sleep.
+    {
+      std::lock_guard<std::mutex> lock(this->sleep_mutex);
+    }
+    this->wake.notify_one();
+  }
+
+  /**
+   * @brief Take a task: the newest one of the own queue, or else the oldest one of another queue
+   *
+   */
+  bool Scheduler::findTask(Task &task)
+  {
+    if (this->queued.load() == 0)
+    {
+      return false;
+    }
+
+    const int own = this->ownQueue();
+    const int count = static_cast<int>(this->queues.size());
+    for (int i = 0; i < count; i++)
+    {
+      TaskQueue &queue = *this->queues[(own + i) % count];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty())
+      {
+        continue;
+      }
+      if (i == 0)
+      {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      }
+      else
+      {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+      this->queued.fetch_sub(1);
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Run a task, tell the profiling hook about it and count it as done in its group
+   *
+   */
+  void Scheduler::execute(Task &task)
+  {
+    // The function is destroyed before the group is told, which may destroy what it captured.
+    {
+      std::function<void()> function = std::move(task.function);
+      if (this->profiling)
+      {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        function();
+        this->profile_hook({task.name, this->getWorkerIndex(), start, std::chrono::steady_clock::now()});
+      }
+      else
+      {
+        function();
+      }
+    }
+    task.group->pending.fetch_sub(1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Run one queued task on the calling thread, for the threads waiting for a group
+   *
+   * @return true If a task was run.
+   * @return false If no task was queued.
+   */
+  bool Scheduler::runTask()
+  {
+    Task task;
+    if (!this->findTask(task))
+    {
+      return false;
+    }
+    this->execute(task);
+    return true;
+  }
+
+  /**
+   * @brief The loop of a worker: run tasks, and sleep while there are none, until the scheduler is
+   * destroyed.
+   *
+   */
+  void Scheduler::work(int index)
+  {
+    current_scheduler = this;
+    current_worker = index;
+
+    Task task;
+    while (true)
+    {
+      if (this->findTask(task))
+      {
+        this->execute(task);
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(this->sleep_mutex);
+      this->wake.wait(lock, [this]
+                      { return this->stopping || this->queued.load() > 0; });
+      if (this->stopping && this->queued.load() == 0)
+      {
+        return;
+      }
+    }
+  }
+} // namespace parallel
@@ -0,0 +1,215 @@
+#include <pipeline/clipping.hpp>
+
+#include <algorithm>
+
+namespace pipeline
+{
+  /**
+   * @brief Signed distance (scaled by h) of a vertex to one of the planes of the clip volume.
+   *
+   * @return double A non negative value when the vertex is on the visible side of the plane.
+   */
+  static inline double plane_distance(const ClipVertex &v, const ClipVolume &volume, uint32_t plane)
+  {
+    switch (plane)
+    {
+    case CLIP_NEAR:
+      return v.h - volume.h_near;
+    case CLIP_LEFT:
+      return v.x - volume.x_min * v.h;
+    case CLIP_RIGHT:
+      return volume.x_max * v.h - v.x;
+    case CLIP_BOTTOM:
+      return v.y - volume.y_min * v.h;
+    case CLIP_TOP:
+      return volume.y_max * v.h - v.y;
+    case GUARD_LEFT:
+      return v.x - volume.guard_x_min * v.h;
+    case GUARD_RIGHT:
+      return volume.guard_x_max * v.h - v.x;
+    case GUARD_BOTTOM:
+      return v.y - volume.guard_y_min * v.h;
+    default:
+      return volume.guard_y_max * v.h - v.y;
+    }
+  }
+
+  /**
+   * @brief Linear interpolation of the position and the attributes of two vertices.
+   *
+   */
+  static inline void interpolate(const ClipVertex &a, const ClipVertex &b, double t, int num_attributes, ClipVertex &out)
+  {
+    out.x = a.x + (b.x - a.x) * t;
+    out.y = a.y + (b.y - a.y) * t;
+    out.z = a.z + (b.z - a.z) * t;
+    out.h = a.h + (b.h - a.h) * t;
+
+    const float tf = static_cast<float>(t);
+    for (int i = 0; i < num_attributes; i++)
+    {
+      out.attributes[i] = a.attributes[i] + (b.attributes[i] - a.attributes[i]) * tf;
+    }
+  }
+
+  /**
+   * @brief Build the clip volume of a camera.
+   *
+   * @param window The window of the camera (x_min, x_max, y_min, y_max), in the projection plane.
+   * @param h_near The smallest h that is visible, it must be positive.
+   * @return ClipVolume The clip volume.
+   */
+  ClipVolume clip_volume(std::vector<double> window, double h_near)
+  {
+    return {window[0], window[1], window[2], window[3], h_near, window[0], window[1], window[2], window[3]};
+  }
+
+  /**
+   * @brief Build the clip volume of a camera, with a guard band of GUARD_BAND_PIXELS around the viewport.
+   *
+   * @param window The window of the camera (x_min, x_max, y_min, y_max), in the projection plane.
+   * @param viewport The viewport of the camera (u_min, u_max, v_min, v_max), in pixels.
+   * @param h_near The smallest h that is visible, it must be positive.
+   * @return ClipVolume The clip volume.
+   */
+  ClipVolume clip_volume(std::vector<double> window, std::vector<double> viewport, double h_near)
+  {
+    // The guard band in window units, the window is scaled to the viewport by the screen stage.
+    double guard_x = GUARD_BAND_PIXELS * (window[1] - window[0]) / (viewport[1] - viewport[0]);
+    double guard_y = GUARD_BAND_PIXELS * (window[3] - window[2]) / (viewport[3] - viewport[2]);
+
+    return {window[0], window[1], window[2], window[3], h_near,
+            window[0] - guard_x, window[1] + guard_x, window[2] - guard_y, window[3] + guard_y};
+  }
+
+  /**
+   * @brief Compute the outcode of a vertex: one bit set for each plane it is outside of.
+   *
+   * A polygon whose vertices share a CLIP_ALL bit is entirely outside and can be rejected, and a
+   * polygon whose vertices have no GUARD_ALL bit doesn't need to be clipped.
+   *
+   * @param v The vertex, in homogeneous coordinates.
+   * @param volume The clip volume.
+   * @return uint32_t The outcode of the vertex.
+   */
+  uint32_t outcode(const ClipVertex &v, const ClipVolume &volume)
+  {
+    uint32_t code = 0;
+
+    code |= v.h < volume.h_near ? CLIP_NEAR : 0;
+    code |= v.x < volume.x_min * v.h ? CLIP_LEFT : 0;
+    code |= v.x > volume.x_max * v.h ? CLIP_RIGHT : 0;
+    code |= v.y < volume.y_min * v.h ? CLIP_BOTTOM : 0;
+    code |= v.y > volume.y_max * v.h ? CLIP_TOP : 0;
+
+    code |= v.x < volume.guard_x_min * v.h ? GUARD_LEFT : 0;
+    code |= v.x > volume.guard_x_max * v.h ? GUARD_RIGHT : 0;
+    code |= v.y < volume.guard_y_min * v.h ? GUARD_BOTTOM : 0;
+    code |= v.y > volume.guard_y_max * v.h ? GUARD_TOP : 0;
+
+    return code;
+  }
+
+  /**
+   * @brief Clip a convex polygon with the Sutherland-Hodgman algorithm.
+   *
+   * The polygon is clipped against one plane at a time, alternating between its two buffers.
+   * The near plane is always clipped first so the window planes only see vertices with h > 0.
+   * Vertexes that would overflow the buffers are dropped.
+   *
+   * @param polygon The polygon to be clipped, it is replaced by the clipped polygon.
+   * @param volume The clip volume.
+   * @param planes The planes to clip against, usually the union of the outcodes of the vertices
+   * masked by CLIP_ALL (exact clipping) or GUARD_ALL (guard band clipping).
+   * @param num_attributes The number of attributes to interpolate.
+   */
+  void clip_polygon(ClipPolygon &polygon, const ClipVolume &volume, uint32_t planes, int num_attributes)
+  {
+    for (uint32_t plane = CLIP_NEAR; plane <= GUARD_TOP && polygon.count > 0; plane <<= 1)
+    {
+      if ((planes & plane) == 0)
+      {
+        continue;
+      }
+
+      const ClipVertex *in = polygon.buffers[polygon.current];
+      ClipVertex *out = polygon.buffers[1 - polygon.current];
+      int count = 0;
+
+      const ClipVertex *previous = &in[polygon.count - 1];
+      double previous_distance = plane_distance(*previous, volume, plane);
+
+      for (int i = 0; i < polygon.count && count < CLIP_MAX_VERTICES; i++)
+      {
+        const ClipVertex *current = &in[i];
+        double current_distance = plane_distance(*current, volume, plane);
+
+        // The edge crosses the plane: emit the intersection.
+        if ((previous_distance >= 0) != (current_distance >= 0))
+        {
+          double t = previous_distance / (previous_distance - current_distance);
+          interpolate(*previous, *current, t, num_attributes, out[count++]);
+        }
+
+        if (current_distance >= 0 && count < CLIP_MAX_VERTICES)
+        {
+          out[count++] = *current;
+        }
+
+        previous = current;
+        previous_distance = current_distance;
+      }
+
+      polygon.current = 1 - polygon.current;
+      polygon.count = count;
+    }
+  }
+
+  /**
+   * @brief Clip a segment against the clip volume, for wireframe rendering.
+   *
+   * @param a The first vertex of the segment, replaced by the clipped one.
+   * @param b The last vertex of the segment, replaced by the clipped one.
+   * @param volume The clip volume.
+   * @param num_attributes The number of attributes to interpolate.
+   * @return true If part of the segment is visible.
+   * @return false If the segment is entirely outside.
+   */
+  bool clip_segment(ClipVertex &a, ClipVertex &b, const ClipVolume &volume, int num_attributes)
+  {
+    double t_enter = 0.0;
+    double t_exit = 1.0;
+
+    for (uint32_t plane = CLIP_NEAR; plane <= CLIP_TOP; plane <<= 1)
+    {
+      double da = plane_distance(a, volume, plane);
+      double db = plane_distance(b, volume, plane);
+
+      if (da < 0 && db < 0)
+      {
+        return false;
+      }
+
+      if (da < 0)
+      {
+        t_enter = std::max(t_enter, da / (da - db));
+      }
+      else if (db < 0)
+      {
+        t_exit = std::min(t_exit, da / (da - db));
+      }
+    }
+
+    if (t_enter > t_exit)
+    {
+      return false;
+    }
+
+    ClipVertex start = a;
+    ClipVertex end = b;
+    interpolate(start, end, t_enter, num_attributes, a);
+    interpolate(start, end, t_exit, num_attributes, b);
+
+    return true;
+  }
+} // namespace pipeline
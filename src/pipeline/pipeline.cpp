@@ -1,9 +1,124 @@
 #include <pipeline/pipeline.hpp>
+#include <core/camera.hpp>
 #include <math/math.hpp>
+#include <math/matrix.hpp>
+#include <cmath>
 #include <iomanip>
 
 namespace pipeline
 {
+  /**
+   * @brief Compose the projection stage and the view stage, a rigid motion, with the products of
+   * their kinds: the affine factors are multiplied in 3x4 and the perspective one only mixes the
+   * z row into the z and h rows.
+   *
+   * @param projection The projection stage.
+   * @param view The view stage.
+   * @return Math::Matrix4 The matrix projection * view.
+   */
+  Math::Matrix4 compose_projection_view(const ProjectionStage &projection, const Math::Matrix4 &view)
+  {
+    return Math::compose(projection.perspective, projection.affine, Math::to_affine(view));
+  }
+
+  /**
+   * @brief The projection stage as a single matrix.
+   *
+   * @param camera The camera of the scene.
+   * @return Math::Matrix4 The projection matrix.
+   */
+  Math::Matrix4 Pipeline::projection(const Core::Camera &camera) const
+  {
+    const ProjectionStage stage = this->projectionStage(camera);
+    return Math::multiply(stage.perspective, stage.affine);
+  }
+
+  /**
+   * @brief The matrix that takes a point from the SRU to the clip space.
+   *
+   * @param camera The camera of the scene.
+   * @return Math::Matrix4 The matrix projection * view.
+   */
+  Math::Matrix4 Pipeline::projectionView(const Core::Camera &camera) const
+  {
+    return compose_projection_view(this->projectionStage(camera), this->view(camera));
+  }
+
+  /**
+   * @brief Compose the stages of the pipeline into a single matrix.
+   *
+   * The screen stage is a scale and a translation, so it can be applied before the division by h:
+   * the screen coordinates of a point are the x and y of the result divided by its h. Its product
+   * only scales the rows of projection * view and adds their h row.
+   *
+   * @param camera The camera of the scene.
+   * @return Math::Matrix4 The matrix screen * projection * view.
+   */
+  Math::Matrix4 Pipeline::transform(const Core::Camera &camera) const
+  {
+    return Math::multiply(Math::to_scale_translate(this->screen(camera)), this->projectionView(camera));
+  }
+
+  /**
+   * @brief Get one of the pipelines. They have no state, so a single instance of each is shared.
+   *
+   * @param kind The pipeline.
+   * @return const Pipeline& The pipeline.
+   */
+  const Pipeline &get_pipeline(PipelineKind kind)
+  {
+    static const santa_catarina::SantaCatarinaPipeline santa_catarina_pipeline;
+    static const madeiras_pereira::MadeirasPereiraPipeline madeiras_pereira_pipeline;
+
+    if (kind == PipelineKind::MADEIRAS_PEREIRA)
+    {
+      return madeiras_pereira_pipeline;
+    }
+    return santa_catarina_pipeline;
+  }
+
+  /**
+   * @brief The axes of the camera system, built from the view direction and an up vector.
+   *
+   * v is the up vector projected onto the plane orthogonal to n. When the camera looks along the
+   * up vector (straight up or down) the projection vanishes, so the axis of the SRU closest to
+   * that plane is used instead, and the basis stays orthonormal. Cameras build it once when they
+   * change, not for every vertex.
+   *
+   * @param vrp A Core::Vertex:Vertex that represents the VRP (View Reference Point).
+   * @param fp A Core::Vertex:Vertex that represents the FP (Focal Point), the camera looks at it.
+   * @param up The view up vector, it doesn't have to be orthogonal to the view direction nor unit.
+   * @return ViewBasis The u, v and n axes.
+   */
+  ViewBasis view_basis(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp, Core::Vertex::Vertex up)
+  {
+    // Below this squared sine of the angle between up and n, v is too imprecise to be used.
+    const double MIN_UP_SINE_SQUARED = 1e-12;
+
+    ViewBasis basis;
+    Core::Vertex::Vertex n = {vrp.x - fp.x, vrp.y - fp.y, vrp.z - fp.z};
+    const double n_length = Math::v_module(n);
+    basis.n = n_length > 0 ? Core::Vertex::Vertex{n.x / n_length, n.y / n_length, n.z / n_length} : Core::Vertex::Vertex{0, 0, 1};
+    n = basis.n;
+
+    const double up_length = Math::v_module(up);
+    Core::Vertex::Vertex up_n = Math::dot(Math::dot(up, n), n);
+    Core::Vertex::Vertex v = {up.x - up_n.x, up.y - up_n.y, up.z - up_n.z};
+    if (up_length == 0 || Math::dot(v, v) <= MIN_UP_SINE_SQUARED * up_length * up_length)
+    {
+      // The axis of the SRU with the smallest component along n.
+      up = std::abs(n.x) <= std::abs(n.y) && std::abs(n.x) <= std::abs(n.z) ? Core::Vertex::Vertex{1, 0, 0}
+           : std::abs(n.y) <= std::abs(n.z)                                 ? Core::Vertex::Vertex{0, 1, 0}
+                                                                           : Core::Vertex::Vertex{0, 0, 1};
+      up_n = Math::dot(Math::dot(up, n), n);
+      v = {up.x - up_n.x, up.y - up_n.y, up.z - up_n.z};
+    }
+
+    basis.v = Math::normalize(v);
+    basis.u = Math::cross(basis.v, n);
+    return basis;
+  }
+
   namespace santa_catarina
   {
 
@@ -12,28 +127,16 @@ namespace pipeline
      *
      * @param vrp A Core::Vertex:Vertex that represents the VRP (View Reference Point) of the SRC.
      * @param fp A Core::Vertex:Vertex that represents the FP (Focal Point) of the SRC.
+     * @param up The view up vector.
      * @return std::vector<std::vector<double>> A 4x4 matrix that represents the transformation from SRU to SRC.
      */
-    std::vector<std::vector<double>> sru2src(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp)
+    std::vector<std::vector<double>> sru2src(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp, Core::Vertex::Vertex up)
     {
-      // Define the n vector.
-      Core::Vertex::Vertex n = {vrp.x - fp.x, vrp.y - fp.y, vrp.z - fp.z};
-      Core::Vertex::Vertex n_normalized = Math::normalize(n);
-
-      // Define the v vector.
-      // TODO: Choose the up vector, depending on the camera orientation.
-      Core::Vertex::Vertex up_vec = {0, 1, 0};
-
-      double y1 = Math::dot(up_vec, n_normalized);
-
-      Core::Vertex::Vertex _y1 = Math::dot(y1, n_normalized);
-
-      Core::Vertex::Vertex v = {up_vec.x - _y1.x, up_vec.y - _y1.y, up_vec.z - _y1.z};
-
-      Core::Vertex::Vertex v_normalized = Math::normalize(v);
-
-      // Define the u vector.
-      Core::Vertex::Vertex u = Math::cross(v_normalized, n_normalized);
+      // Define the u, v and n vectors.
+      const ViewBasis basis = view_basis(vrp, fp, up);
+      const Core::Vertex::Vertex &u = basis.u;
+      const Core::Vertex::Vertex &v_normalized = basis.v;
+      const Core::Vertex::Vertex &n_normalized = basis.n;
 
       // Make the transformation matrix.
       std::vector<std::vector<double>> matrix_proj;
@@ -131,5 +234,324 @@ namespace pipeline
 
       return matrix_s;
     }
+
+    /**
+     * @brief The whole santa_catarina pipeline (src2srt * projection * sru2src, with the y axis
+     * reflected) as a single matrix, written in closed form.
+     *
+     * The projection has z_prp = 0, so its z row is (0, 0, 1, 0) and its h row is (0, 0, -1/d, 0),
+     * and src2srt only scales and translates x and y. Every row of the product is then a
+     * combination of the rows u, v and n of sru2src, no 4x4 products are needed. The projection is
+     * built in the SRC, where the projection plane only depends on d, so the point given to it
+     * (the third parameter, kept for the callers) cancels out.
+     *
+     * @param vrp A Core::Vertex:Vertex that represents the VRP (View Reference Point) of the SRC.
+     * @param fp A Core::Vertex:Vertex that represents the FP (Focal Point) of the SRC.
+     * @param d The distance from the VRP to the projection plane.
+     * @param window A int[4] that represents the window of the SRT. (x_min, x_max, y_min, y_max)
+     * @param viewport A int[4] that represents the viewport of the SRT. (u_min, u_max, v_min, v_max)
+     * @param up The view up vector.
+     * @return std::vector<std::vector<double>> A 4x4 matrix that takes a point from the SRU to the
+     * SRT, before the division by h.
+     */
+    std::vector<std::vector<double>> algebraic_pipeline_sta_catarina(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp, Core::Vertex::Vertex, double d, int *window, int *viewport,
+                                                                     Core::Vertex::Vertex up)
+    {
+      // The rows of sru2src.
+      const ViewBasis basis = view_basis(vrp, fp, up);
+      const Core::Vertex::Vertex &u = basis.u;
+      const Core::Vertex::Vertex &v = basis.v;
+      const Core::Vertex::Vertex &n = basis.n;
+
+      double u_vrp = -Math::dot(u, vrp);
+      double v_vrp = -Math::dot(v, vrp);
+      double n_vrp = -Math::dot(n, vrp);
+
+      // The entries of src2srt with reflection.
+      double x_scale = static_cast<double>(viewport[1] - viewport[0]) / (window[1] - window[0]);
+      double y_scale = static_cast<double>(viewport[2] - viewport[3]) / (window[3] - window[2]);
+      double x_offset = viewport[0] - window[0] * x_scale;
+      double y_offset = viewport[3] - window[2] * y_scale;
+
+      // h = -(n . (P - VRP)) / d, the x and y rows add their offsets times h.
+      double h_scale = -1 / d;
+      std::vector<double> h = {n.x * h_scale, n.y * h_scale, n.z * h_scale, n_vrp * h_scale};
+
+      return {
+          {x_scale * u.x + x_offset * h[0], x_scale * u.y + x_offset * h[1], x_scale * u.z + x_offset * h[2], x_scale * u_vrp + x_offset * h[3]},
+          {y_scale * v.x + y_offset * h[0], y_scale * v.y + y_offset * h[1], y_scale * v.z + y_offset * h[2], y_scale * v_vrp + y_offset * h[3]},
+          {n.x, n.y, n.z, n_vrp},
+          h};
+    }
+
+    /**
+     * @brief Keep the rows of a composed pipeline that project_vertex needs.
+     *
+     * @param pipeline A 4x4 matrix that takes a point from the SRU to the SRT, before the division by h.
+     * @return ScreenProjection The x, y and h rows of the matrix.
+     */
+    ScreenProjection screen_projection(const std::vector<std::vector<double>> &pipeline)
+    {
+      ScreenProjection s;
+      for (int j = 0; j < 4; j++)
+      {
+        s.x[j] = pipeline[0][j];
+        s.y[j] = pipeline[1][j];
+        s.h[j] = pipeline[3][j];
+      }
+      return s;
+    }
+
+    /**
+     * @brief Get the name of the pipeline.
+     *
+     * @return const char* The name of the pipeline.
+     */
+    const char *SantaCatarinaPipeline::getName() const
+    {
+      return "Santa Catarina";
+    }
+
+    /**
+     * @brief The SRU to SRC stage, the camera keeps it up to date as it moves.
+     *
+     * @param camera The camera of the scene.
+     * @return Math::Matrix4 The sru2src matrix.
+     */
+    Math::Matrix4 SantaCatarinaPipeline::view(const Core::Camera &camera) const
+    {
+      return camera.getView();
+    }
+
+    /**
+     * @brief The perspective projection stage, it leaves h = -z / d.
+     *
+     * It is built in the SRC, where the camera looks down the z axis from the origin, so it only
+     * depends on d, whatever the orientation of the camera.
+     *
+     * @param camera The camera of the scene.
+     * @return ProjectionStage The projection matrix, with no affine factor.
+     */
+    ProjectionStage SantaCatarinaPipeline::projectionStage(const Core::Camera &camera) const
+    {
+      return {Math::to_perspective(Math::to_matrix4(santa_catarina::projection({0, 0, 0}, {0, 0, -1}, camera.getD()))),
+              Math::to_affine(Math::identity_matrix())};
+    }
+
+    /**
+     * @brief The SRC to SRT stage, with the y axis reflected.
+     *
+     * @param camera The camera of the scene.
+     * @return Math::Matrix4 The src2srt matrix.
+     */
+    Math::Matrix4 SantaCatarinaPipeline::screen(const Core::Camera &camera) const
+    {
+      return Math::to_matrix4(src2srt(camera.getWindow(), camera.getViewPort(), true));
+    }
+
+    /**
+     * @brief The projected points are in the units of the window of the camera.
+     *
+     * @param camera The camera of the scene.
+     * @return std::vector<double> The window of the camera.
+     */
+    std::vector<double> SantaCatarinaPipeline::window(const Core::Camera &camera) const
+    {
+      return camera.getWindow();
+    }
+
+    /**
+     * @brief The h of a point in front of the observer, it doesn't depend on the camera.
+     *
+     * @param distance The distance from the observer, along the view direction.
+     * @return double The h of the point, distance / d.
+     */
+    double SantaCatarinaPipeline::depthToH(const Core::Camera &camera, double distance) const
+    {
+      return distance / camera.getD();
+    }
   } // namespace santa_catarina
+
+  namespace madeiras_pereira
+  {
+    /**
+     * @brief The view orientation: translate the VRP to the origin and rotate the u, v, n axes of the
+     * camera onto x, y, z.
+     *
+     * @param vrp A Core::Vertex:Vertex that represents the VRP (View Reference Point).
+     * @param fp A Core::Vertex:Vertex that represents the FP (Focal Point), the camera looks at it.
+     * @param up The view up vector.
+     * @return Math::Matrix4 The matrix R * T(-VRP).
+     */
+    Math::Matrix4 view_orientation(Core::Vertex::Vertex vrp, Core::Vertex::Vertex fp, Core::Vertex::Vertex up)
+    {
+      // The axes of the camera, v is the view up vector projected onto the plane orthogonal to n.
+      const ViewBasis basis = view_basis(vrp, fp, up);
+      const Core::Vertex::Vertex &u = basis.u;
+      const Core::Vertex::Vertex &v = basis.v;
+      const Core::Vertex::Vertex &n = basis.n;
+
+      Math::Matrix4 rotation = {{
+          {u.x, u.y, u.z, 0},
+          {v.x, v.y, v.z, 0},
+          {n.x, n.y, n.z, 0},
+          {0, 0, 0, 1},
+      }};
+
+      Math::Matrix4 translation = Math::identity_matrix();
+      translation[0][3] = -vrp.x;
+      translation[1][3] = -vrp.y;
+      translation[2][3] = -vrp.z;
+
+      return Math::multiply_matrix(rotation, translation);
+    }
+
+    /**
+     * @brief The normalization of the view volume into the canonical perspective volume, bounded by
+     * the planes x = z, x = -z, y = z, y = -z and z = -1.
+     *
+     * The shear moves the center of the window onto the z axis, then the scale makes the sides of the
+     * volume 45 degrees and puts the back plane at z = -1.
+     *
+     * @param window The window (x_min, x_max, y_min, y_max), on the projection plane.
+     * @param d The distance from the VRP to the projection plane.
+     * @param back The distance from the VRP to the back plane.
+     * @return Math::Matrix4 The matrix S * SH.
+     */
+    Math::Matrix4 normalization(std::vector<double> window, double d, double back)
+    {
+      double x_min = window[0];
+      double x_max = window[1];
+      double y_min = window[2];
+      double y_max = window[3];
+
+      // | 1, 0, (x_min + x_max) / 2d, 0 |
+      // | 0, 1, (y_min + y_max) / 2d, 0 |
+      // | 0, 0, 1, 0 |
+      // | 0, 0, 0, 1 |
+      Math::Matrix4 shear = Math::identity_matrix();
+      shear[0][2] = (x_min + x_max) / (2 * d);
+      shear[1][2] = (y_min + y_max) / (2 * d);
+
+      Math::Matrix4 scale = Math::identity_matrix();
+      scale[0][0] = 2 * d / ((x_max - x_min) * back);
+      scale[1][1] = 2 * d / ((y_max - y_min) * back);
+      scale[2][2] = 1 / back;
+
+      return Math::multiply_matrix(scale, shear);
+    }
+
+    /**
+     * @brief Turn the canonical perspective volume into the canonical parallel volume, bounded by
+     * x = -1, x = 1, y = -1, y = 1, z = -1 and z = 0. It leaves h = -z.
+     *
+     * @param z_min The z of the front plane in the canonical perspective volume, -front / back.
+     * @return Math::Matrix4 The matrix M_per.
+     */
+    Math::Matrix4 perspective_to_parallel(double z_min)
+    {
+      // | 1, 0, 0, 0 |
+      // | 0, 1, 0, 0 |
+      // | 0, 0, 1 / (1 + z_min), -z_min / (1 + z_min) |
+      // | 0, 0, -1, 0 |
+      Math::Matrix4 matrix_per = Math::identity_matrix();
+      matrix_per[2][2] = 1 / (1 + z_min);
+      matrix_per[2][3] = -z_min / (1 + z_min);
+      matrix_per[3][2] = -1;
+      matrix_per[3][3] = 0;
+
+      return matrix_per;
+    }
+
+    /**
+     * @brief Map the canonical volume, x and y in [-1, 1], to the viewport, with the y axis reflected.
+     *
+     * @param viewport The viewport (u_min, u_max, v_min, v_max).
+     * @return Math::Matrix4 The viewport matrix.
+     */
+    Math::Matrix4 viewport_transform(std::vector<double> viewport)
+    {
+      double u_min = viewport[0];
+      double u_max = viewport[1];
+      double v_min = viewport[2];
+      double v_max = viewport[3];
+
+      double half_width = (u_max - u_min) / 2;
+      double half_height = (v_max - v_min) / 2;
+
+      Math::Matrix4 matrix_v = Math::identity_matrix();
+      matrix_v[0][0] = half_width;
+      matrix_v[0][3] = u_min + half_width;
+      matrix_v[1][1] = -half_height;
+      matrix_v[1][3] = v_max - half_height;
+
+      return matrix_v;
+    }
+
+    /**
+     * @brief Get the name of the pipeline.
+     *
+     * @return const char* The name of the pipeline.
+     */
+    const char *MadeirasPereiraPipeline::getName() const
+    {
+      return "Madeiras Pereira";
+    }
+
+    /**
+     * @brief The view orientation stage. It is the same matrix as sru2src, so the one the camera
+     * keeps up to date is used.
+     *
+     * @param camera The camera of the scene.
+     * @return Math::Matrix4 The view orientation matrix.
+     */
+    Math::Matrix4 MadeirasPereiraPipeline::view(const Core::Camera &camera) const
+    {
+      return camera.getView();
+    }
+
+    /**
+     * @brief The normalization and the perspective to parallel stages, it leaves h = -z / back.
+     *
+     * @param camera The camera of the scene.
+     * @return ProjectionStage M_per, which only mixes the z and h rows, and the normalization S * SH.
+     */
+    ProjectionStage MadeirasPereiraPipeline::projectionStage(const Core::Camera &camera) const
+    {
+      return {Math::to_perspective(perspective_to_parallel(-FRONT_PLANE / BACK_PLANE)),
+              Math::to_affine(normalization(camera.getWindow(), camera.getD(), BACK_PLANE))};
+    }
+
+    /**
+     * @brief The viewport stage.
+     *
+     * @param camera The camera of the scene.
+     * @return Math::Matrix4 The viewport matrix.
+     */
+    Math::Matrix4 MadeirasPereiraPipeline::screen(const Core::Camera &camera) const
+    {
+      return viewport_transform(camera.getViewPort());
+    }
+
+    /**
+     * @brief The projected points are in the canonical volume, whatever the window of the camera.
+     *
+     * @return std::vector<double> The window (-1, 1, -1, 1).
+     */
+    std::vector<double> MadeirasPereiraPipeline::window(const Core::Camera &) const
+    {
+      return {-1, 1, -1, 1};
+    }
+
+    /**
+     * @brief The h of a point in front of the observer, it doesn't depend on the camera.
+     *
+     * @param distance The distance from the observer, along the view direction.
+     * @return double The h of the point, distance / back.
+     */
+    double MadeirasPereiraPipeline::depthToH(const Core::Camera &, double distance) const
+    {
+      return distance / BACK_PLANE;
+    }
+  } // namespace madeiras_pereira
 } // namespace pipeline
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include <pipeline/projection.hpp>
+#include <core/camera.hpp>
+#include <core/mesh.hpp>
+#include <core/scene.hpp>
+#include <core/vector.hpp>
+#include <parallel/scheduler.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace pipeline
+{
+  // A chunk of the vertexes of a scene: the distinct mesh and the first vertex, it ends
+  // PROJECTION_CHUNK_VERTEXES later or at the end of the mesh
+  typedef struct
+  {
+    size_t mesh;
+    size_t begin;
+  } MeshChunk;
+
+  /**
+   * @brief Project a range of points into the buffers at the same range
+   *
+   * @param transform The composed transform, projection * view.
+   * @param screen The screen stage.
+   * @param x, y, z The points of the range, in the SRU.
+   * @param begin The index of the first point in the buffers.
+   * @param n The number of points.
+   * @param projected The buffers, already sized.
+   */
+  static void project_range(const Math::DenseMatrix<float> &transform, const Math::ScaleTranslateMatrix<float> &screen, const float *x, const float *y, const float *z,
+                            size_t begin, size_t n, ProjectedVertexes &projected)
+  {
+    Math::apply_points(transform, x, y, z, n, projected.clip_x.data() + begin, projected.clip_y.data() + begin,
+                       projected.clip_z.data() + begin, projected.clip_h.data() + begin);
+    Math::divide_points(screen, projected.clip_x.data() + begin, projected.clip_y.data() + begin, projected.clip_h.data() + begin, n,
+                        projected.screen_x.data() + begin, projected.screen_y.data() + begin, projected.inv_h.data() + begin);
+  }
+
+  /**
+   * @brief Size the buffers of a projection for n vertexes, keeping their memory when they shrink
+   *
+   */
+  void resize_projection(ProjectedVertexes &projected, size_t n)
+  {
+    projected.clip_x.resize(n);
+    projected.clip_y.resize(n);
+    projected.clip_z.resize(n);
+    projected.clip_h.resize(n);
+    projected.screen_x.resize(n);
+    projected.screen_y.resize(n);
+    projected.inv_h.resize(n);
+  }
+
+  /**
+   * @brief Project a batch of points, in chunks run by the threads of the scheduler.
+   *
+   * The matrices are composed in double and the points are projected in float, with twice the
+   * vector width; the error stays below half a subpixel. The points are expected near the origin,
+   * far ones are given relative to a point folded into the transform (see project_meshes).
+   *
+   * @param transform The composed transform, projection * view.
+   * @param screen The screen stage.
+   * @param x, y, z The coordinates of the n points, in the SRU.
+   * @param n The number of points.
+   * @param projected Filled with the projected points.
+   */
+  void project_points(const Math::Matrix4 &transform, const Math::ScaleTranslateMatrix<double> &screen, const float *x, const float *y, const float *z, size_t n,
+                      ProjectedVertexes &projected)
+  {
+    resize_projection(projected, n);
+    const Math::DenseMatrix<float> t = Math::matrix_cast<float>(transform);
+    const Math::ScaleTranslateMatrix<float> s = Math::matrix_cast<float>(screen);
+
+    const size_t chunks = (n + PROJECTION_CHUNK_VERTEXES - 1) / PROJECTION_CHUNK_VERTEXES;
+    parallel::parallel_for(0, chunks, 1, [&](size_t first, size_t last)
+                           {
+                             for (size_t c = first; c < last; c++)
+                             {
+                               const size_t begin = c * PROJECTION_CHUNK_VERTEXES;
+                               const size_t count = std::min(n - begin, PROJECTION_CHUNK_VERTEXES);
+                               project_range(t, s, x + begin, y + begin, z + begin, begin, count, projected);
+                             } },
+                           "project_points");
+  }
+
+  /**
+   * @brief Project the vertexes of many meshes, each one with its own transform.
+   *
+   * The vertexes of all meshes are split in chunks of PROJECTION_CHUNK_VERTEXES, which the threads
+   * of the scheduler steal from each other, so a few large meshes and many small ones are shared
+   * alike. Each chunk gathers its vertexes into arrays of its own and writes whole cache lines of
+   * the buffers of its mesh, so the threads never write to the same line.
+   *
+   * A mesh given several times is an instanced one: its chunks are gathered once and projected
+   * with the transform of each instance while they are in the L1 cache.
+   *
+   * The vertexes of a chunk are gathered in float relative to its first one, whose position is
+   * folded into the transforms in double, so they keep their precision far from the origin.
+   *
+   * The renderer doesn't go through it yet: it projects only the meshes left after culling, one
+   * at a time, with the level of detail and the shading of each one, so the projected vertexes of
+   * a whole scene would mostly be thrown away.
+   *
+   * @param meshes The meshes, the same one may be given several times.
+   * @param transforms The composed transform of each mesh, projection * view * model.
+   * @param screen The screen stage.
+   * @param projected Filled with the projected vertexes of each mesh, its buffers are reused.
+   */
+  void project_meshes(const std::vector<Core::Mesh *> &meshes, const std::vector<Math::Matrix4> &transforms, const Math::ScaleTranslateMatrix<double> &screen,
+                      std::vector<ProjectedVertexes> &projected)
+  {
+    const Math::ScaleTranslateMatrix<float> s = Math::matrix_cast<float>(screen);
+
+    // The instances of each distinct mesh, in the order they first appear.
+    std::unordered_map<Core::Mesh *, size_t> distinct;
+    std::vector<std::vector<size_t>> instances;
+    for (size_t m = 0; m < meshes.size(); m++)
+    {
+      auto [entry, added] = distinct.try_emplace(meshes[m], instances.size());
+      if (added)
+      {
+        instances.emplace_back();
+      }
+      instances[entry->second].push_back(m);
+    }
+
+    projected.resize(meshes.size());
+    for (size_t m = 0; m < meshes.size(); m++)
+    {
+      resize_projection(projected[m], meshes[m]->getVertexes().size());
+    }
+
+    std::vector<MeshChunk> chunks;
+    for (size_t d = 0; d < instances.size(); d++)
+    {
+      const size_t n = meshes[instances[d][0]]->getVertexes().size();
+      for (size_t begin = 0; begin < n; begin += PROJECTION_CHUNK_VERTEXES)
+      {
+        chunks.push_back({d, begin});
+      }
+    }
+
+    parallel::parallel_for(0, chunks.size(), 1, [&](size_t first, size_t last)
+                           {
+                             float x[PROJECTION_CHUNK_VERTEXES];
+                             float y[PROJECTION_CHUNK_VERTEXES];
+                             float z[PROJECTION_CHUNK_VERTEXES];
+                             for (size_t c = first; c < last; c++)
+                             {
+                               const std::vector<size_t> &mesh_instances = instances[chunks[c].mesh];
+                               const std::vector<Core::Vector *> &vertexes = meshes[mesh_instances[0]]->getVertexes();
+                               const size_t begin = chunks[c].begin;
+                               const size_t count = std::min(vertexes.size() - begin, PROJECTION_CHUNK_VERTEXES);
+                               const Core::Vertex::Vertex origin = vertexes[begin]->getVertex();
+                               for (size_t i = 0; i < count; i++)
+                               {
+                                 const Core::Vertex::Vertex p = vertexes[begin + i]->getVertex();
+                                 x[i] = static_cast<float>(p.x - origin.x);
+                                 y[i] = static_cast<float>(p.y - origin.y);
+                                 z[i] = static_cast<float>(p.z - origin.z);
+                               }
+                               const Math::ScaleTranslateMatrix<double> shift = {{1, 1, 1}, {origin.x, origin.y, origin.z}};
+                               for (size_t m : mesh_instances)
+                               {
+                                 const Math::DenseMatrix<float> t = Math::matrix_cast<float>(Math::multiply(transforms[m], shift));
+                                 project_range(t, s, x, y, z, begin, count, projected[m]);
+                               }
+                             } },
+                           "project_meshes");
+  }
+
+  /**
+   * @brief Project the meshes of a scene with its camera, each one placed by its model matrix
+   *
+   * @param scene The scene.
+   * @param kind The pipeline the camera stages are built with.
+   * @param projected Filled with the projected vertexes of each mesh of the scene, in its order.
+   */
+  void project_scene(const Core::Scene *scene, PipelineKind kind, std::vector<ProjectedVertexes> &projected)
+  {
+    const Pipeline &pipeline = get_pipeline(kind);
+    const Core::Camera &camera = *scene->getCamera();
+    const Math::Matrix4 projection_view = pipeline.projectionView(camera);
+
+    // The model matrix is folded into the transform of each mesh, so moving a mesh costs nothing here.
+    std::vector<Math::Matrix4> transforms = scene->getObjectTransforms();
+    for (Math::Matrix4 &transform : transforms)
+    {
+      transform = Math::multiply_matrix(projection_view, transform);
+    }
+    project_meshes(scene->getObjects(), transforms, Math::to_scale_translate(pipeline.screen(camera)), projected);
+  }
+} // namespace pipeline
@@ -0,0 +1,194 @@
+#include <render/depth_pyramid.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace render
+{
+  /**
+   * @brief Construct a new empty DepthPyramid object, it occludes nothing until it is built
+   *
+   */
+  DepthPyramid::DepthPyramid()
+  {
+  }
+
+  /**
+   * @brief Copy constructor of DepthPyramid object
+   *
+   * @param p The DepthPyramid to be copied
+   */
+  DepthPyramid::DepthPyramid(const DepthPyramid &p)
+  {
+    *this = p;
+  }
+
+  DepthPyramid::~DepthPyramid()
+  {
+  }
+
+  /**
+   * @brief Get the number of levels of the pyramid
+   *
+   * @return int The number of levels, 0 if it was never built
+   */
+  int DepthPyramid::getNumLevels() const
+  {
+    return static_cast<int>(this->levels.size());
+  }
+
+  /**
+   * @brief Get the width of a level
+   *
+   * @param level The level, 0 is the full resolution
+   * @return int The width in texels
+   */
+  int DepthPyramid::getWidth(int level) const
+  {
+    return this->widths[level];
+  }
+
+  /**
+   * @brief Get the height of a level
+   *
+   * @param level The level, 0 is the full resolution
+   * @return int The height in texels
+   */
+  int DepthPyramid::getHeight(int level) const
+  {
+    return this->heights[level];
+  }
+
+  /**
+   * @brief Get the farthest depth of the pixels covered by a texel
+   *
+   * @param level The level, 0 is the full resolution
+   * @param x The column of the texel
+   * @param y The row of the texel
+   * @return float The least 1/w of the pixels under the texel
+   */
+  float DepthPyramid::getDepth(int level, int x, int y) const
+  {
+    return this->levels[level][y * this->widths[level] + x];
+  }
+
+  /**
+   * @brief Assignment operator of DepthPyramid object
+   *
+   * @param p The DepthPyramid to be copied
+   * @return DepthPyramid& A reference to this DepthPyramid
+   */
+  DepthPyramid &DepthPyramid::operator=(const DepthPyramid &p)
+  {
+    this->levels = p.levels;
+    this->widths = p.widths;
+    this->heights = p.heights;
+    return *this;
+  }
+
+  /**
+   * @brief Build the pyramid from the depth buffer of a frame buffer
+   *
+   * Odd sizes are rounded up, so the texels on the last row or column of a level only reduce the
+   * texels that exist below them.
+   *
+   * @param fb The frame buffer, after its occluders were drawn
+   */
+  void DepthPyramid::build(const FrameBuffer &fb)
+  {
+    int width = fb.getWidth();
+    int height = fb.getHeight();
+
+    this->levels.resize(1);
+    this->widths.assign(1, width);
+    this->heights.assign(1, height);
+    this->levels[0].assign(fb.getDepth(), fb.getDepth() + static_cast<size_t>(width) * height);
+
+    while (width > 1 || height > 1)
+    {
+      const int child_width = width;
+      const int child_height = height;
+      width = (width + 1) / 2;
+      height = (height + 1) / 2;
+
+      const std::vector<float> &child = this->levels.back();
+      std::vector<float> level(static_cast<size_t>(width) * height);
+
+      for (int y = 0; y < height; y++)
+      {
+        const int y0 = 2 * y;
+        const int y1 = std::min(y0 + 1, child_height - 1);
+
+        for (int x = 0; x < width; x++)
+        {
+          const int x0 = 2 * x;
+          const int x1 = std::min(x0 + 1, child_width - 1);
+
+          level[y * width + x] = std::min({child[y0 * child_width + x0], child[y0 * child_width + x1],
+                                           child[y1 * child_width + x0], child[y1 * child_width + x1]});
+        }
+      }
+
+      this->levels.push_back(std::move(level));
+      this->widths.push_back(width);
+      this->heights.push_back(height);
+    }
+  }
+
+  /**
+   * @brief Check if a box is hidden behind what was drawn, from its screen rectangle and depth
+   *
+   * The coarsest level where the rectangle covers at most 2x2 texels is read, so the test costs 4
+   * reads whatever the size of the box.
+   *
+   * @param x_min The left of the screen rectangle of the box
+   * @param y_min The top of the screen rectangle of the box
+   * @param x_max The right of the screen rectangle of the box
+   * @param y_max The bottom of the screen rectangle of the box
+   * @param max_inv_w The 1/w of the nearest point of the box
+   * @return true If every pixel under the rectangle already holds something nearer than the box
+   * @return false If the box may be visible
+   */
+  bool DepthPyramid::isOccluded(float x_min, float y_min, float x_max, float y_max, float max_inv_w) const
+  {
+    if (this->levels.empty())
+    {
+      return false;
+    }
+
+    // The pixels touched by the rectangle, grown by one pixel to stay conservative. The rectangle is
+    // clamped before it is converted, it may reach far outside of the frame buffer, with a margin so
+    // the growth does not pull a rectangle outside of the frame buffer back into it.
+    const float width = static_cast<float>(this->widths[0]);
+    const float height = static_cast<float>(this->heights[0]);
+    const int px_min = static_cast<int>(std::floor(std::clamp(x_min, -2.0f, width + 1.0f))) - 1;
+    const int py_min = static_cast<int>(std::floor(std::clamp(y_min, -2.0f, height + 1.0f))) - 1;
+    const int px_max = static_cast<int>(std::ceil(std::clamp(x_max, -2.0f, width + 1.0f))) + 1;
+    const int py_max = static_cast<int>(std::ceil(std::clamp(y_max, -2.0f, height + 1.0f))) + 1;
+
+    // Nothing of the box is inside of the frame buffer, so nothing of it can be drawn.
+    if (px_max < 0 || py_max < 0 || px_min >= this->widths[0] || py_min >= this->heights[0])
+    {
+      return true;
+    }
+
+    const int x0 = std::max(px_min, 0);
+    const int y0 = std::max(py_min, 0);
+    const int x1 = std::min(px_max, this->widths[0] - 1);
+    const int y1 = std::min(py_max, this->heights[0] - 1);
+
+    int level = 0;
+    while (level + 1 < this->getNumLevels() &&
+           ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+    {
+      level++;
+    }
+
+    float farthest = this->getDepth(level, x0 >> level, y0 >> level);
+    farthest = std::min(farthest, this->getDepth(level, x1 >> level, y0 >> level));
+    farthest = std::min(farthest, this->getDepth(level, x0 >> level, y1 >> level));
+    farthest = std::min(farthest, this->getDepth(level, x1 >> level, y1 >> level));
+
+    return max_inv_w < farthest;
+  }
+} // namespace render
@@ -0,0 +1,148 @@
+#include <render/depth_sort.hpp>
+#include <parallel/scheduler.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace render
+{
+  // Bits sorted by each pass, 3 passes cover the 32 bits of a key
+  static const int RADIX_BITS = 11;
+  static const int RADIX_SIZE = 1 << RADIX_BITS;
+  static const int RADIX_PASSES = (32 + RADIX_BITS - 1) / RADIX_BITS;
+
+  /**
+   * @brief Map a float to an unsigned integer with the same order.
+   *
+   * Positive floats already compare like their bits once the sign bit is set, negative floats
+   * compare in reverse, so all of their bits are flipped.
+   *
+   * @param key The float to be mapped, not a NaN.
+   * @return uint32_t An integer that compares like the float.
+   */
+  uint32_t sortable_key(float key)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  }
+
+  /**
+   * @brief Sort indices by their float keys in ascending order, keeping the order of equal keys.
+   *
+   * The key and its index are packed in a 64 bit word, the key in the high half, and the words
+   * are sorted with a least significant digit radix sort over 11 bit digits of the key, in 3
+   * passes. The input is split in chunks: each thread counts the digits of its chunk, the counts
+   * of a pass are turned into the first destination of every (digit, chunk) pair, and each thread
+   * scatters its chunk to its own ranges, so the passes stay stable without any synchronization
+   * but the joins. The digits of all passes are counted while the words are packed, which saves
+   * the counting reads of the later passes when there is a single chunk. Passes where all keys
+   * share the same digit are skipped.
+   *
+   * Not reentrant on a thread, the word buffers are shared by the calls of each thread, so it must
+   * not be called from a task of the scheduler: a thread waiting for its chunks may run that task.
+   *
+   * @param keys The keys, NaNs are not allowed.
+   * @param count The number of keys.
+   * @param order Filled with the indices of the keys, from the least key to the greatest.
+   * @param threads The number of threads, 0 for one per thread of the scheduler. Small inputs use
+   * one.
+   */
+  void radix_sort(const float *keys, size_t count, uint32_t *order, int threads)
+  {
+    if (threads <= 0)
+    {
+      threads = parallel::Scheduler::instance().getThreads();
+    }
+    const int chunks = count < PARALLEL_SORT_MIN_KEYS ? 1 : threads;
+
+    // The word buffers are kept between calls, the painter's algorithm sorts every frame and the
+    // page faults of fresh buffers cost as much as a pass. The workers would see their own
+    // thread_local buffers, so they use these pointers.
+    static thread_local std::vector<uint64_t> words_buffer;
+    static thread_local std::vector<uint64_t> scratch_buffer;
+    words_buffer.resize(count);
+    scratch_buffer.resize(count);
+    uint64_t *words = words_buffer.data();
+    uint64_t *scratch = scratch_buffer.data();
+    // One histogram per (pass, chunk), the pass is the outer index.
+    std::vector<size_t> histograms(static_cast<size_t>(RADIX_PASSES) * chunks * RADIX_SIZE, 0);
+    auto histogram = [&](int pass, int chunk)
+    {
+      return histograms.data() + (static_cast<size_t>(pass) * chunks + chunk) * RADIX_SIZE;
+    };
+
+    parallel::for_each_chunk(count, chunks, [&](int chunk, size_t begin, size_t end)
+                             {
+                               size_t *counts[RADIX_PASSES];
+                               for (int pass = 0; pass < RADIX_PASSES; pass++)
+                               {
+                                 counts[pass] = histogram(pass, chunk);
+                               }
+
+                               for (size_t i = begin; i < end; i++)
+                               {
+                                 const uint32_t key = sortable_key(keys[i]);
+                                 words[i] = (static_cast<uint64_t>(key) << 32) | static_cast<uint32_t>(i);
+                                 for (int pass = 0; pass < RADIX_PASSES; pass++)
+                                 {
+                                   counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+                                 }
+                               } }, "radix_sort");
+
+    for (int pass = 0; pass < RADIX_PASSES; pass++)
+    {
+      const int shift = 32 + pass * RADIX_BITS;
+
+      // The chunks hold other words once a pass has moved them, so their digits are counted again.
+      if (pass > 0 && chunks > 1)
+      {
+        parallel::for_each_chunk(count, chunks, [&](int chunk, size_t begin, size_t end)
+                                 {
+                                   size_t *counts = histogram(pass, chunk);
+                                   std::fill(counts, counts + RADIX_SIZE, 0);
+                                   for (size_t i = begin; i < end; i++)
+                                   {
+                                     counts[(words[i] >> shift) & (RADIX_SIZE - 1)]++;
+                                   } }, "radix_sort");
+      }
+
+      // Exclusive prefix sum in digit-major order, so chunk c of a digit lands after chunk c - 1.
+      // The pass is skipped if every key has the same digit.
+      size_t offset = 0;
+      bool single_digit = false;
+      for (int digit = 0; digit < RADIX_SIZE; digit++)
+      {
+        const size_t digit_begin = offset;
+        for (int chunk = 0; chunk < chunks; chunk++)
+        {
+          size_t &slot = histogram(pass, chunk)[digit];
+          const size_t digit_count = slot;
+          slot = offset;
+          offset += digit_count;
+        }
+        single_digit = single_digit || (offset - digit_begin == count);
+      }
+      if (single_digit)
+      {
+        continue;
+      }
+
+      parallel::for_each_chunk(count, chunks, [&](int chunk, size_t begin, size_t end)
+                               {
+                                 size_t *next = histogram(pass, chunk);
+                                 for (size_t i = begin; i < end; i++)
+                                 {
+                                   scratch[next[(words[i] >> shift) & (RADIX_SIZE - 1)]++] = words[i];
+                                 } }, "radix_sort");
+
+      std::swap(words, scratch);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+      order[i] = static_cast<uint32_t>(words[i]);
+    }
+  }
+} // namespace render
@@ -0,0 +1,278 @@
+#include <render/framebuffer.hpp>
+
+#include <algorithm>
+
+namespace render
+{
+  /**
+   * @brief Construct a new empty FrameBuffer object
+   *
+   */
+  FrameBuffer::FrameBuffer()
+  {
+    this->depth_test = true;
+    this->resize(0, 0);
+  }
+
+  /**
+   * @brief Construct a new FrameBuffer object
+   *
+   * @param width The width of the buffer in pixels
+   * @param height The height of the buffer in pixels
+   */
+  FrameBuffer::FrameBuffer(int width, int height)
+  {
+    this->depth_test = true;
+    this->resize(width, height);
+  }
+
+  /**
+   * @brief Copy constructor of FrameBuffer object
+   *
+   * @param fb The FrameBuffer to be copied
+   */
+  FrameBuffer::FrameBuffer(const FrameBuffer &fb)
+  {
+    this->width = fb.width;
+    this->height = fb.height;
+    this->color = fb.color;
+    this->depth = fb.depth;
+    this->depth_test = fb.depth_test;
+    this->setScissor(fb.scissor[0], fb.scissor[1], fb.scissor[2], fb.scissor[3]);
+  }
+
+  FrameBuffer::~FrameBuffer()
+  {
+  }
+
+  /**
+   * @brief Get the width of the buffer
+   *
+   * @return int The width in pixels
+   */
+  int FrameBuffer::getWidth() const
+  {
+    return this->width;
+  }
+
+  /**
+   * @brief Get the height of the buffer
+   *
+   * @return int The height in pixels
+   */
+  int FrameBuffer::getHeight() const
+  {
+    return this->height;
+  }
+
+  /**
+   * @brief Get the color buffer, stored row by row
+   *
+   * @return uint32_t* A pointer to the first pixel
+   */
+  uint32_t *FrameBuffer::getColor()
+  {
+    return this->color.data();
+  }
+
+  /**
+   * @brief Get the color buffer, stored row by row
+   *
+   * @return const uint32_t* A pointer to the first pixel
+   */
+  const uint32_t *FrameBuffer::getColor() const
+  {
+    return this->color.data();
+  }
+
+  /**
+   * @brief Get the depth buffer, stored row by row
+   *
+   * @return float* A pointer to the depth of the first pixel
+   */
+  float *FrameBuffer::getDepth()
+  {
+    return this->depth.data();
+  }
+
+  /**
+   * @brief Get the depth buffer, stored row by row
+   *
+   * @return const float* A pointer to the depth of the first pixel
+   */
+  const float *FrameBuffer::getDepth() const
+  {
+    return this->depth.data();
+  }
+
+  /**
+   * @brief Get the color buffer as a byte array, ready to be uploaded to a texture
+   *
+   * @return const uint8_t* A pointer to the red component of the first pixel
+   */
+  const uint8_t *FrameBuffer::getPixels() const
+  {
+    return reinterpret_cast<const uint8_t *>(this->color.data());
+  }
+
+  /**
+   * @brief Get the left border of the scissor rectangle
+   *
+   * @return int The first column that can be drawn
+   */
+  int FrameBuffer::getScissorXMin() const
+  {
+    return this->scissor[0];
+  }
+
+  /**
+   * @brief Get the right border of the scissor rectangle
+   *
+   * @return int One past the last column that can be drawn
+   */
+  int FrameBuffer::getScissorXMax() const
+  {
+    return this->scissor[2];
+  }
+
+  /**
+   * @brief Get the top border of the scissor rectangle
+   *
+   * @return int The first row that can be drawn
+   */
+  int FrameBuffer::getScissorYMin() const
+  {
+    return this->scissor[1];
+  }
+
+  /**
+   * @brief Get the bottom border of the scissor rectangle
+   *
+   * @return int One past the last row that can be drawn
+   */
+  int FrameBuffer::getScissorYMax() const
+  {
+    return this->scissor[3];
+  }
+
+  /**
+   * @brief Get whether the rasterizer keeps only the closest fragment of each pixel
+   *
+   * @return bool true if fragments are tested against the depth buffer
+   */
+  bool FrameBuffer::getDepthTest() const
+  {
+    return this->depth_test;
+  }
+
+  /**
+   * @brief Get the color of a pixel
+   *
+   * @param x The column of the pixel
+   * @param y The row of the pixel
+   * @return uint32_t The packed color of the pixel
+   */
+  uint32_t FrameBuffer::getPixel(int x, int y) const
+  {
+    return this->color[y * this->width + x];
+  }
+
+  /**
+   * @brief Set the color of a pixel, ignoring the depth buffer
+   *
+   * @param x The column of the pixel
+   * @param y The row of the pixel
+   * @param color The packed color of the pixel
+   */
+  void FrameBuffer::setPixel(int x, int y, uint32_t color)
+  {
+    this->color[y * this->width + x] = color;
+  }
+
+  /**
+   * @brief Restrict the rasterizer to a rectangle, usually the viewport. It is clamped to the buffer.
+   *
+   * @param x_min The first column that can be drawn
+   * @param y_min The first row that can be drawn
+   * @param x_max One past the last column that can be drawn
+   * @param y_max One past the last row that can be drawn
+   */
+  void FrameBuffer::setScissor(int x_min, int y_min, int x_max, int y_max)
+  {
+    this->scissor[0] = std::clamp(x_min, 0, this->width);
+    this->scissor[1] = std::clamp(y_min, 0, this->height);
+    this->scissor[2] = std::clamp(x_max, this->scissor[0], this->width);
+    this->scissor[3] = std::clamp(y_max, this->scissor[1], this->height);
+  }
+
+  /**
+   * @brief Enable or disable the depth test. Without it every fragment is drawn, in the order the
+   * triangles are filled, but the depth buffer is still written.
+   *
+   * @param depth_test true to keep only the closest fragment of each pixel
+   */
+  void FrameBuffer::setDepthTest(bool depth_test)
+  {
+    this->depth_test = depth_test;
+  }
+
+  /**
+   * @brief Assignment operator of FrameBuffer object
+   *
+   * @param fb The FrameBuffer to be copied
+   * @return FrameBuffer& A reference to this FrameBuffer
+   */
+  FrameBuffer &FrameBuffer::operator=(const FrameBuffer &fb)
+  {
+    this->width = fb.width;
+    this->height = fb.height;
+    this->color = fb.color;
+    this->depth = fb.depth;
+    this->depth_test = fb.depth_test;
+    this->setScissor(fb.scissor[0], fb.scissor[1], fb.scissor[2], fb.scissor[3]);
+    return *this;
+  }
+
+  /**
+   * @brief Resize the buffer, the contents and the scissor rectangle are reset
+   *
+   * @param width The new width in pixels
+   * @param height The new height in pixels
+   */
+  void FrameBuffer::resize(int width, int height)
+  {
+    this->width = std::max(width, 0);
+    this->height = std::max(height, 0);
+    this->color.assign(this->width * this->height, 0);
+    this->depth.assign(this->width * this->height, 0.0f);
+    this->setScissor(0, 0, this->width, this->height);
+  }
+
+  /**
+   * @brief Fill the color buffer with a color and reset the depth buffer
+   *
+   * @param color The packed clear color
+   */
+  void FrameBuffer::clear(uint32_t color)
+  {
+    std::fill(this->color.begin(), this->color.end(), color);
+    std::fill(this->depth.begin(), this->depth.end(), 0.0f);
+  }
+
+  /**
+   * @brief Pack a color with components in [0, 1] into a RGBA8 pixel
+   *
+   * @param r The red component
+   * @param g The green component
+   * @param b The blue component
+   * @return uint32_t The packed opaque color
+   */
+  uint32_t pack_color(float r, float g, float b)
+  {
+    uint32_t ri = static_cast<uint32_t>(std::clamp(r, 0.0f, 1.0f) * 255.0f + 0.5f);
+    uint32_t gi = static_cast<uint32_t>(std::clamp(g, 0.0f, 1.0f) * 255.0f + 0.5f);
+    uint32_t bi = static_cast<uint32_t>(std::clamp(b, 0.0f, 1.0f) * 255.0f + 0.5f);
+
+    return ri | (gi << 8) | (bi << 16) | (0xFFu << 24);
+  }
+} // namespace render
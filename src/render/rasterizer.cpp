@@ -0,0 +1,677 @@
+#include <render/rasterizer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace render
+{
+  // Number of fractional bits of the fixed point colors and lines stepped by the rasterizer (16.16).
+  static const int FIXED_SHIFT = 16;
+  static const float FIXED_ONE = static_cast<float>(1 << FIXED_SHIFT);
+  // Greatest screen coordinate that can be stepped in 16.16 without overflowing.
+  static const float MAX_COORDINATE = 16384.0f;
+
+  static inline int32_t to_fixed(float value)
+  {
+    return static_cast<int32_t>(std::lround(value * FIXED_ONE));
+  }
+
+  static inline uint32_t fixed_to_channel(int32_t value)
+  {
+    return static_cast<uint32_t>(std::clamp(value >> FIXED_SHIFT, 0, 255));
+  }
+
+  /**
+   * @brief Screen space gradients of an attribute, from the plane through the 3 vertices.
+   *
+   */
+  static inline void gradient(float ax, float ay, float bx, float by, float cx, float cy, float inv_area,
+                              float fa, float fb, float fc, float &dfdx, float &dfdy)
+  {
+    dfdx = ((fb - fa) * (cy - ay) - (fc - fa) * (by - ay)) * inv_area;
+    dfdy = ((fc - fa) * (bx - ax) - (fb - fa) * (cx - ax)) * inv_area;
+  }
+
+  // Number of fractional bits of the snapped vertex positions (28.4).
+  static const int SUBPIXEL_SHIFT = 4;
+  static const int32_t SUBPIXEL_ONE = 1 << SUBPIXEL_SHIFT;
+  static const int32_t SUBPIXEL_HALF = SUBPIXEL_ONE / 2;
+
+  static inline int32_t to_subpixel(float value)
+  {
+    return static_cast<int32_t>(std::lround(value * SUBPIXEL_ONE));
+  }
+
+  static inline int64_t floor_div(int64_t n, int64_t d)
+  {
+    int64_t q = n / d;
+    return (n % d != 0 && ((n < 0) != (d < 0))) ? q - 1 : q;
+  }
+
+  static inline int64_t ceil_div(int64_t n, int64_t d)
+  {
+    return -floor_div(-n, d);
+  }
+
+  // An edge function E(x, y) = dx * (y - y0) - dy * (x - x0) in 28.4, positive inside the triangle.
+  typedef struct
+  {
+    int64_t x0;
+    int64_t y0;
+    int64_t dx;
+    int64_t dy;
+    // 0 for top and left edges, which own the pixel centers lying exactly on them, 1 otherwise
+    int64_t bias;
+  } Edge;
+
+  static inline Edge make_edge(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+  {
+    Edge e = {x0, y0, x1 - x0, y1 - y0, 0};
+
+    // Inside is to the right of a left edge (dy < 0) and below a top edge (dy == 0, dx > 0).
+    const bool top_left = e.dy < 0 || (e.dy == 0 && e.dx > 0);
+    e.bias = top_left ? 0 : 1;
+    return e;
+  }
+
+  /**
+   * @brief Walk the scanlines covered by a triangle, calling span(y, x_begin, x_end) for each one.
+   *
+   * The vertices are snapped to 28.4 fixed point and coverage is decided by the three edge functions
+   * in integer arithmetic, so there are no rounding differences between the faces that share an
+   * edge: every pixel center is owned by exactly one of them, the top-left rule breaking the ties.
+   * For each scanline the edge functions are solved for the first and the last pixel center inside,
+   * so the spans are computed without testing every pixel, and are already clipped to the scissor
+   * rectangle.
+   *
+   */
+  template <typename Span>
+  static void scan_triangle(const FrameBuffer &fb, float ax, float ay, float bx, float by, float cx, float cy, Span span)
+  {
+    int32_t x0 = to_subpixel(ax), y0 = to_subpixel(ay);
+    int32_t x1 = to_subpixel(bx), y1 = to_subpixel(by);
+    int32_t x2 = to_subpixel(cx), y2 = to_subpixel(cy);
+
+    // Orient the triangle so the edge functions are positive inside, degenerate ones are dropped.
+    const int64_t area = static_cast<int64_t>(x1 - x0) * (y2 - y0) - static_cast<int64_t>(x2 - x0) * (y1 - y0);
+    if (area == 0)
+    {
+      return;
+    }
+    if (area < 0)
+    {
+      std::swap(x1, x2);
+      std::swap(y1, y2);
+    }
+
+    const Edge edges[3] = {make_edge(x0, y0, x1, y1), make_edge(x1, y1, x2, y2), make_edge(x2, y2, x0, y0)};
+
+    const int x_min = fb.getScissorXMin();
+    const int x_max = fb.getScissorXMax();
+
+    // Rows whose centers (y + 0.5) can be inside of the triangle.
+    const int32_t top = std::min({y0, y1, y2});
+    const int32_t bottom = std::max({y0, y1, y2});
+    const int y_start = static_cast<int>(std::max<int64_t>(ceil_div(top - SUBPIXEL_HALF, SUBPIXEL_ONE), fb.getScissorYMin()));
+    const int y_end = static_cast<int>(std::min<int64_t>(floor_div(bottom - SUBPIXEL_HALF, SUBPIXEL_ONE) + 1, fb.getScissorYMax()));
+
+    for (int y = y_start; y < y_end; y++)
+    {
+      const int64_t center_y = static_cast<int64_t>(y) * SUBPIXEL_ONE + SUBPIXEL_HALF;
+      int64_t x_begin = x_min;
+      int64_t x_end = x_max;
+
+      // With the center x = 16 * px + 8, each edge is a * px + k >= 0, a bound on px.
+      for (const Edge &e : edges)
+      {
+        const int64_t a = -e.dy * SUBPIXEL_ONE;
+        const int64_t k = e.dx * (center_y - e.y0) - e.dy * (SUBPIXEL_HALF - e.x0) - e.bias;
+
+        if (a > 0)
+        {
+          x_begin = std::max(x_begin, ceil_div(-k, a));
+        }
+        else if (a < 0)
+        {
+          x_end = std::min(x_end, floor_div(k, -a) + 1);
+        }
+        else if (k < 0)
+        {
+          x_end = x_begin;
+        }
+      }
+
+      if (x_begin < x_end)
+      {
+        span(y, static_cast<int>(x_begin), static_cast<int>(x_end));
+      }
+    }
+  }
+
+  /**
+   * @brief Check that a triangle has an area and can be stepped in fixed point.
+   *
+   */
+  static inline bool rasterizable(float ax, float ay, float bx, float by, float cx, float cy, float &area)
+  {
+    area = (bx - ax) * (cy - ay) - (cx - ax) * (by - ay);
+
+    // The pipeline clips the faces to the guard band, this only guards against huge viewports.
+    return std::fabs(area) >= 1e-6f &&
+           std::max({std::fabs(ax), std::fabs(bx), std::fabs(cx), std::fabs(ay), std::fabs(by), std::fabs(cy)}) <= MAX_COORDINATE;
+  }
+
+  /**
+   * @brief Fill a triangle with Gouraud interpolation of the vertex colors.
+   *
+   * The color channels are stepped across each span in 16.16 fixed point using the constant
+   * gradients of the triangle, so the inner loop only does integer additions (plus one float
+   * addition for the depth). A depth test keeps the fragment with the greatest 1/w, unless it is
+   * disabled in the frame buffer. Flat shading is the special case where the three vertices carry
+   * the same color.
+   *
+   * @param fb The target frame buffer, fragments outside of its scissor rectangle are discarded.
+   * @param a The first vertex of the triangle.
+   * @param b The second vertex of the triangle.
+   * @param c The third vertex of the triangle.
+   */
+  void fill_triangle(FrameBuffer &fb, const RasterVertex &a, const RasterVertex &b, const RasterVertex &c)
+  {
+    float area;
+    if (!rasterizable(a.x, a.y, b.x, b.y, c.x, c.y, area))
+    {
+      return;
+    }
+
+    const float inv_area = 1.0f / area;
+    float drdx, drdy, dgdx, dgdy, dbdx, dbdy, dwdx, dwdy;
+    gradient(a.x, a.y, b.x, b.y, c.x, c.y, inv_area, a.color.r * 255.0f, b.color.r * 255.0f, c.color.r * 255.0f, drdx, drdy);
+    gradient(a.x, a.y, b.x, b.y, c.x, c.y, inv_area, a.color.g * 255.0f, b.color.g * 255.0f, c.color.g * 255.0f, dgdx, dgdy);
+    gradient(a.x, a.y, b.x, b.y, c.x, c.y, inv_area, a.color.b * 255.0f, b.color.b * 255.0f, c.color.b * 255.0f, dbdx, dbdy);
+    gradient(a.x, a.y, b.x, b.y, c.x, c.y, inv_area, a.inv_w, b.inv_w, c.inv_w, dwdx, dwdy);
+
+    const int32_t drdx_fixed = to_fixed(drdx);
+    const int32_t dgdx_fixed = to_fixed(dgdx);
+    const int32_t dbdx_fixed = to_fixed(dbdx);
+
+    const int width = fb.getWidth();
+    uint32_t *color = fb.getColor();
+    float *depth = fb.getDepth();
+    const bool depth_test = fb.getDepthTest();
+
+    auto span = [&](int y, int x_begin, int x_end)
+    {
+      // Attributes at the center of the first pixel of the span.
+      const float dx = (x_begin + 0.5f) - a.x;
+      const float dy = (y + 0.5f) - a.y;
+      int32_t r = to_fixed(a.color.r * 255.0f + drdx * dx + drdy * dy);
+      int32_t g = to_fixed(a.color.g * 255.0f + dgdx * dx + dgdy * dy);
+      int32_t bl = to_fixed(a.color.b * 255.0f + dbdx * dx + dbdy * dy);
+      float w = a.inv_w + dwdx * dx + dwdy * dy;
+
+      uint32_t *color_row = color + y * width;
+      float *depth_row = depth + y * width;
+
+      for (int x = x_begin; x < x_end; x++)
+      {
+        if (!depth_test || w > depth_row[x])
+        {
+          depth_row[x] = w;
+          color_row[x] = fixed_to_channel(r) | (fixed_to_channel(g) << 8) | (fixed_to_channel(bl) << 16) | (0xFFu << 24);
+        }
+
+        r += drdx_fixed;
+        g += dgdx_fixed;
+        bl += dbdx_fixed;
+        w += dwdx;
+      }
+    };
+
+    scan_triangle(fb, a.x, a.y, b.x, b.y, c.x, c.y, span);
+  }
+
+  // Attributes stepped along the edges and spans of a polygon: red, green, blue (0-255) and 1/w.
+  static const int POLYGON_ATTRIBUTES = 4;
+  // Polygons with up to this many edges are filled without allocating.
+  static const int POLYGON_LOCAL_EDGES = 16;
+
+  // An edge of the active edge table, from its top to its bottom vertex.
+  typedef struct
+  {
+    // The first row whose center is on or below the top of the edge
+    int row_begin;
+    // The first row whose center is below the edge
+    int row_end;
+    // +1 for the edges going down the loop, -1 for the ones going up
+    int winding;
+    // The first pixel whose center is right of (or on) the edge in the current row is
+    // ceil(n / d) = q, with n = q * d - r; n grows by d * q_step + r_step per row.
+    int64_t q;
+    int64_t r;
+    int64_t d;
+    int64_t q_step;
+    int64_t r_step;
+    // The edge and its attributes at the center of the current row, stepped in floating point
+    float x;
+    float dxdy;
+    float attributes[POLYGON_ATTRIBUTES];
+    float dady[POLYGON_ATTRIBUTES];
+  } ScanEdge;
+
+  /**
+   * @brief Fill a polygon with any number of vertices with Gouraud interpolation of the colors.
+   *
+   * The polygon is scanned with an active edge table: the edges are sorted by their first row,
+   * enter the table on it and leave it after their last one, and the table is kept sorted by x.
+   * Each edge steps incrementally from row to row both its crossing, exactly, as a quotient and
+   * remainder in 28.4 fixed point, and its interpolated attributes. Spans are filled between the
+   * crossings where the winding number is not zero, so concave polygons are filled as well.
+   *
+   * Pixel centers on a left edge or a horizontal top edge are inside, like the top-left rule of
+   * fill_triangle, so a triangle covers the same pixels with both functions and the polygons that
+   * share an edge never overlap nor leave cracks. The attributes are interpolated along the edges
+   * and then across each span, which is exact for triangles and flat colors.
+   *
+   * @param fb The target frame buffer, fragments outside of its scissor rectangle are discarded.
+   * @param vertices The vertices the polygon refers to.
+   * @param loop The indices of the vertices of the polygon in order, such as a half-edge loop, or
+   * nullptr if they are the first count vertices.
+   * @param count The number of vertices of the polygon.
+   */
+  void fill_polygon(FrameBuffer &fb, const RasterVertex *vertices, const int *loop, int count)
+  {
+    if (count < 3)
+    {
+      return;
+    }
+
+    ScanEdge local_edges[POLYGON_LOCAL_EDGES];
+    ScanEdge *local_order[POLYGON_LOCAL_EDGES];
+    std::vector<ScanEdge> heap_edges;
+    std::vector<ScanEdge *> heap_order;
+    ScanEdge *edges = local_edges;
+    // Pointers to the edges: the active edge table followed by the edges that didn't start yet.
+    ScanEdge **order = local_order;
+    if (count > POLYGON_LOCAL_EDGES)
+    {
+      heap_edges.resize(count);
+      heap_order.resize(count);
+      edges = heap_edges.data();
+      order = heap_order.data();
+    }
+
+    const int y_min = fb.getScissorYMin();
+    const int y_max = fb.getScissorYMax();
+    int num_edges = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+      const RasterVertex *a = &vertices[loop != nullptr ? loop[i] : i];
+      const RasterVertex *b = &vertices[loop != nullptr ? loop[(i + 1) % count] : (i + 1) % count];
+
+      // The pipeline clips the faces to the guard band, this only guards against huge viewports.
+      if (std::max(std::fabs(a->x), std::fabs(a->y)) > MAX_COORDINATE)
+      {
+        return;
+      }
+
+      int32_t x0 = to_subpixel(a->x), y0 = to_subpixel(a->y);
+      int32_t x1 = to_subpixel(b->x), y1 = to_subpixel(b->y);
+      int winding = 1;
+      if (y0 == y1)
+      {
+        continue;
+      }
+      if (y0 > y1)
+      {
+        std::swap(a, b);
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+        winding = -1;
+      }
+
+      // The rows whose centers are in [y0, y1), restricted to the scissor rectangle.
+      const int first = static_cast<int>(std::max<int64_t>(ceil_div(y0 - SUBPIXEL_HALF, SUBPIXEL_ONE), y_min));
+      const int end = static_cast<int>(std::min<int64_t>(ceil_div(y1 - SUBPIXEL_HALF, SUBPIXEL_ONE), y_max));
+      if (first >= end)
+      {
+        continue;
+      }
+
+      ScanEdge &e = edges[num_edges];
+      e.row_begin = first;
+      e.row_end = end;
+      e.winding = winding;
+
+      // The crossing of the first row, ceil((x - 8) / 16) at y = 16 * first + 8.
+      const int64_t dx = x1 - x0;
+      const int64_t dy = y1 - y0;
+      const int64_t center_y = static_cast<int64_t>(first) * SUBPIXEL_ONE + SUBPIXEL_HALF;
+      const int64_t n = (x0 - SUBPIXEL_HALF) * dy + (center_y - y0) * dx;
+      e.d = dy * SUBPIXEL_ONE;
+      e.q = ceil_div(n, e.d);
+      e.r = e.q * e.d - n;
+      e.q_step = floor_div(dx * SUBPIXEL_ONE, e.d);
+      e.r_step = dx * SUBPIXEL_ONE - e.q_step * e.d;
+
+      const float fy0 = static_cast<float>(y0) / SUBPIXEL_ONE;
+      const float fy1 = static_cast<float>(y1) / SUBPIXEL_ONE;
+      const float t = (first + 0.5f) - fy0;
+      const float inv_dy = 1.0f / (fy1 - fy0);
+      const float va[POLYGON_ATTRIBUTES] = {a->color.r * 255.0f, a->color.g * 255.0f, a->color.b * 255.0f, a->inv_w};
+      const float vb[POLYGON_ATTRIBUTES] = {b->color.r * 255.0f, b->color.g * 255.0f, b->color.b * 255.0f, b->inv_w};
+
+      e.dxdy = (static_cast<float>(dx) / SUBPIXEL_ONE) * inv_dy;
+      e.x = static_cast<float>(x0) / SUBPIXEL_ONE + e.dxdy * t;
+      for (int k = 0; k < POLYGON_ATTRIBUTES; k++)
+      {
+        e.dady[k] = (vb[k] - va[k]) * inv_dy;
+        e.attributes[k] = va[k] + e.dady[k] * t;
+      }
+
+      order[num_edges] = &e;
+      num_edges++;
+    }
+
+    if (num_edges < 2)
+    {
+      return;
+    }
+
+    // The edge table: the edges sorted by their first row.
+    std::sort(order, order + num_edges, [](const ScanEdge *a, const ScanEdge *b)
+              { return a->row_begin < b->row_begin; });
+
+    const int x_min = fb.getScissorXMin();
+    const int x_max = fb.getScissorXMax();
+    const int width = fb.getWidth();
+    uint32_t *color = fb.getColor();
+    float *depth = fb.getDepth();
+    const bool depth_test = fb.getDepthTest();
+
+    // order[0, active) is the active edge table, order[active, num_edges) the edges still to start.
+    int active = 0;
+    int y = order[0]->row_begin;
+
+    while (num_edges > 0)
+    {
+      // The edges starting on this row enter the table, which is then sorted by crossing with an
+      // insertion sort, as it is almost always sorted already.
+      while (active < num_edges && order[active]->row_begin == y)
+      {
+        active++;
+      }
+      for (int i = 1; i < active; i++)
+      {
+        ScanEdge *e = order[i];
+        int j = i;
+        while (j > 0 && (order[j - 1]->q > e->q || (order[j - 1]->q == e->q && order[j - 1]->x > e->x)))
+        {
+          order[j] = order[j - 1];
+          j--;
+        }
+        order[j] = e;
+      }
+
+      uint32_t *color_row = color + y * width;
+      float *depth_row = depth + y * width;
+      int winding = 0;
+
+      for (int i = 0; i + 1 < active; i++)
+      {
+        winding += order[i]->winding;
+        if (winding == 0)
+        {
+          continue;
+        }
+
+        const ScanEdge &left = *order[i];
+        const ScanEdge &right = *order[i + 1];
+        const int x_begin = static_cast<int>(std::max<int64_t>(left.q, x_min));
+        const int x_end = static_cast<int>(std::min<int64_t>(right.q, x_max));
+        if (x_begin >= x_end)
+        {
+          continue;
+        }
+
+        // The attributes are interpolated from the left crossing to the right one.
+        const float inv_length = right.x > left.x ? 1.0f / (right.x - left.x) : 0.0f;
+        const float dx = (x_begin + 0.5f) - left.x;
+        float dadx[POLYGON_ATTRIBUTES];
+        float start[POLYGON_ATTRIBUTES];
+        for (int k = 0; k < POLYGON_ATTRIBUTES; k++)
+        {
+          dadx[k] = (right.attributes[k] - left.attributes[k]) * inv_length;
+          start[k] = left.attributes[k] + dadx[k] * dx;
+        }
+
+        int32_t r = to_fixed(start[0]);
+        int32_t g = to_fixed(start[1]);
+        int32_t bl = to_fixed(start[2]);
+        float w = start[3];
+        const int32_t drdx_fixed = to_fixed(dadx[0]);
+        const int32_t dgdx_fixed = to_fixed(dadx[1]);
+        const int32_t dbdx_fixed = to_fixed(dadx[2]);
+
+        for (int x = x_begin; x < x_end; x++)
+        {
+          if (!depth_test || w > depth_row[x])
+          {
+            depth_row[x] = w;
+            color_row[x] = fixed_to_channel(r) | (fixed_to_channel(g) << 8) | (fixed_to_channel(bl) << 16) | (0xFFu << 24);
+          }
+
+          r += drdx_fixed;
+          g += dgdx_fixed;
+          bl += dbdx_fixed;
+          w += dadx[3];
+        }
+      }
+
+      // Step the active edges to the next row and drop the ones that end on it.
+      y++;
+      int kept = 0;
+      for (int i = 0; i < active; i++)
+      {
+        ScanEdge *e = order[i];
+        if (e->row_end <= y)
+        {
+          continue;
+        }
+
+        e->q += e->q_step;
+        e->r -= e->r_step;
+        if (e->r < 0)
+        {
+          e->r += e->d;
+          e->q++;
+        }
+        e->x += e->dxdy;
+        for (int k = 0; k < POLYGON_ATTRIBUTES; k++)
+        {
+          e->attributes[k] += e->dady[k];
+        }
+        order[kept++] = e;
+      }
+
+      // Close the gap left by the dropped edges, and skip the rows where no edge is active.
+      std::copy(order + active, order + num_edges, order + kept);
+      num_edges -= active - kept;
+      active = kept;
+      if (active == 0 && active < num_edges)
+      {
+        y = order[active]->row_begin;
+      }
+    }
+  }
+
+  /**
+   * @brief Fill a triangle with Phong shading: the normal is interpolated and lit at every pixel.
+   *
+   * The world position and normal are interpolated perspective correctly (as attribute/w). The
+   * fragments that pass the depth test are gathered in groups of FRAGMENT_LANES and shaded
+   * together by shade_fragments.
+   *
+   * @param fb The target frame buffer, fragments outside of its scissor rectangle are discarded.
+   * @param a The first vertex of the triangle.
+   * @param b The second vertex of the triangle.
+   * @param c The third vertex of the triangle.
+   * @param eye The position of the observer (the VRP).
+   * @param material The reflection coefficients of the surface.
+   * @param lights The point lights of the scene.
+   */
+  void fill_triangle_phong(FrameBuffer &fb, const PhongVertex &a, const PhongVertex &b, const PhongVertex &c,
+                           const Core::Vertex::Vertex &eye, const Material &material, const std::vector<Light> &lights)
+  {
+    float area;
+    if (!rasterizable(a.x, a.y, b.x, b.y, c.x, c.y, area))
+    {
+      return;
+    }
+
+    // The interpolated attributes: 1/w followed by the world position and the normal over w.
+    const int NUM_ATTRIBUTES = 7;
+    const float va[NUM_ATTRIBUTES] = {a.inv_w, a.px * a.inv_w, a.py * a.inv_w, a.pz * a.inv_w, a.nx * a.inv_w, a.ny * a.inv_w, a.nz * a.inv_w};
+    const float vb[NUM_ATTRIBUTES] = {b.inv_w, b.px * b.inv_w, b.py * b.inv_w, b.pz * b.inv_w, b.nx * b.inv_w, b.ny * b.inv_w, b.nz * b.inv_w};
+    const float vc[NUM_ATTRIBUTES] = {c.inv_w, c.px * c.inv_w, c.py * c.inv_w, c.pz * c.inv_w, c.nx * c.inv_w, c.ny * c.inv_w, c.nz * c.inv_w};
+    float dfdx[NUM_ATTRIBUTES];
+    float dfdy[NUM_ATTRIBUTES];
+
+    const float inv_area = 1.0f / area;
+    for (int i = 0; i < NUM_ATTRIBUTES; i++)
+    {
+      gradient(a.x, a.y, b.x, b.y, c.x, c.y, inv_area, va[i], vb[i], vc[i], dfdx[i], dfdy[i]);
+    }
+
+    const int width = fb.getWidth();
+    uint32_t *color = fb.getColor();
+    float *depth = fb.getDepth();
+    const bool depth_test = fb.getDepthTest();
+
+    FragmentBatch batch = {};
+    int lanes = 0;
+    uint32_t *targets[FRAGMENT_LANES];
+    uint32_t shaded[FRAGMENT_LANES];
+
+    auto flush = [&]()
+    {
+      shade_fragments(batch, eye, material, lights, shaded);
+      for (int i = 0; i < lanes; i++)
+      {
+        *targets[i] = shaded[i];
+      }
+      lanes = 0;
+    };
+
+    auto span = [&](int y, int x_begin, int x_end)
+    {
+      const float dx = (x_begin + 0.5f) - a.x;
+      const float dy = (y + 0.5f) - a.y;
+      float f[NUM_ATTRIBUTES];
+      for (int i = 0; i < NUM_ATTRIBUTES; i++)
+      {
+        f[i] = va[i] + dfdx[i] * dx + dfdy[i] * dy;
+      }
+
+      uint32_t *color_row = color + y * width;
+      float *depth_row = depth + y * width;
+
+      for (int x = x_begin; x < x_end; x++)
+      {
+        if (!depth_test || f[0] > depth_row[x])
+        {
+          depth_row[x] = f[0];
+
+          // The normal doesn't need the division by 1/w, it is normalized when shaded.
+          const float w = 1.0f / f[0];
+          batch.px[lanes] = f[1] * w;
+          batch.py[lanes] = f[2] * w;
+          batch.pz[lanes] = f[3] * w;
+          batch.nx[lanes] = f[4];
+          batch.ny[lanes] = f[5];
+          batch.nz[lanes] = f[6];
+          targets[lanes] = color_row + x;
+
+          if (++lanes == FRAGMENT_LANES)
+          {
+            flush();
+          }
+        }
+
+        for (int i = 0; i < NUM_ATTRIBUTES; i++)
+        {
+          f[i] += dfdx[i];
+        }
+      }
+    };
+
+    scan_triangle(fb, a.x, a.y, b.x, b.y, c.x, c.y, span);
+
+    if (lanes > 0)
+    {
+      flush();
+    }
+  }
+
+  /**
+   * @brief Draw a line with the DDA algorithm, with the color of its first vertex.
+   *
+   * Lines are drawn on top of everything, the depth buffer is neither tested nor written.
+   *
+   * @param fb The target frame buffer, pixels outside of its scissor rectangle are discarded.
+   * @param a The first vertex of the line.
+   * @param b The last vertex of the line.
+   */
+  void draw_line(FrameBuffer &fb, const RasterVertex &a, const RasterVertex &b)
+  {
+    const float dx = b.x - a.x;
+    const float dy = b.y - a.y;
+    const int steps = static_cast<int>(std::ceil(std::max(std::fabs(dx), std::fabs(dy))));
+    const uint32_t color = pack_color(a.color.r, a.color.g, a.color.b);
+
+    if (steps == 0)
+    {
+      return;
+    }
+
+    const int x_min = fb.getScissorXMin();
+    const int x_max = fb.getScissorXMax();
+    const int y_min = fb.getScissorYMin();
+    const int y_max = fb.getScissorYMax();
+
+    // Lines that don't touch the scissor rectangle at all are skipped before walking them.
+    if (std::max(a.x, b.x) < x_min || std::min(a.x, b.x) >= x_max ||
+        std::max(a.y, b.y) < y_min || std::min(a.y, b.y) >= y_max)
+    {
+      return;
+    }
+
+    // The pipeline clips the edges to the window, this only guards against huge viewports.
+    if (std::max({std::fabs(a.x), std::fabs(b.x), std::fabs(a.y), std::fabs(b.y)}) > MAX_COORDINATE)
+    {
+      return;
+    }
+
+    const int32_t x_step = to_fixed(dx / steps);
+    const int32_t y_step = to_fixed(dy / steps);
+    int32_t x = to_fixed(a.x);
+    int32_t y = to_fixed(a.y);
+
+    for (int i = 0; i <= steps; i++)
+    {
+      const int px = x >> FIXED_SHIFT;
+      const int py = y >> FIXED_SHIFT;
+
+      if (px >= x_min && px < x_max && py >= y_min && py < y_max)
+      {
+        fb.setPixel(px, py, color);
+      }
+
+      x += x_step;
+      y += y_step;
+    }
+  }
+} // namespace render
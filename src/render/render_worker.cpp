@@ -0,0 +1,152 @@
+#include <render/render_worker.hpp>
+#include <core/scene.hpp>
+
+namespace render
+{
+  // Set in the waiting frame until the UI thread takes it, the frame buffers are aligned so the
+  // lowest bit of their address is free
+  static const uintptr_t FRESH_FRAME = 1;
+
+  /**
+   * @brief Construct a new RenderWorker object and start its thread
+   *
+   */
+  RenderWorker::RenderWorker()
+  {
+    this->scene = new Core::Scene({}, &this->camera);
+    this->back = new FrameBuffer();
+    this->front = new FrameBuffer();
+    this->ready = reinterpret_cast<uintptr_t>(new FrameBuffer());
+    this->busy = false;
+    this->culled_meshes = 0;
+    this->has_pending = false;
+    this->stopping = false;
+    this->thread = std::thread(&RenderWorker::run, this);
+  }
+
+  /**
+   * @brief Destroy the RenderWorker object, after the frame being rendered is finished
+   *
+   */
+  RenderWorker::~RenderWorker()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->stopping = true;
+    }
+    this->wake.notify_one();
+    this->thread.join();
+
+    // The scene is a Core object, it is never deleted.
+    delete this->back;
+    delete this->front;
+    delete reinterpret_cast<FrameBuffer *>(this->ready.load() & ~FRESH_FRAME);
+  }
+
+  /**
+   * @brief Whether a submitted frame is not finished yet
+   *
+   */
+  bool RenderWorker::isBusy() const
+  {
+    return this->busy;
+  }
+
+  /**
+   * @brief Whether a finished frame is waiting for the UI thread
+   *
+   */
+  bool RenderWorker::hasFrame() const
+  {
+    return (this->ready.load() & FRESH_FRAME) != 0;
+  }
+
+  /**
+   * @brief Get the number of meshes rejected by occlusion culling in the last finished frame
+   *
+   */
+  int RenderWorker::getCulledMeshes() const
+  {
+    return this->culled_meshes;
+  }
+
+  /**
+   * @brief Ask for a frame, replacing the one submitted before if the worker didn't start it yet
+   *
+   * @param request The camera, meshes and settings of the frame, copied.
+   */
+  void RenderWorker::submit(const RenderRequest &request)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->pending = request;
+      this->has_pending = true;
+      this->busy = true;
+    }
+    this->wake.notify_one();
+  }
+
+  /**
+   * @brief Take the last finished frame, in exchange for the one taken before.
+   *
+   * @return const FrameBuffer* The frame, valid until the next call, or nullptr if no frame was
+   * finished since the last call.
+   */
+  const FrameBuffer *RenderWorker::takeFrame()
+  {
+    if (!this->hasFrame())
+    {
+      return nullptr;
+    }
+
+    // Only this thread clears the flag, so the exchange gets a fresh frame, maybe a newer one.
+    const uintptr_t frame = this->ready.exchange(reinterpret_cast<uintptr_t>(this->front));
+    this->front = reinterpret_cast<FrameBuffer *>(frame & ~FRESH_FRAME);
+    return this->front;
+  }
+
+  /**
+   * @brief The loop of the worker thread: render the pending request into the back buffer and
+   * publish it, until the worker is destroyed.
+   *
+   */
+  void RenderWorker::run()
+  {
+    RenderRequest request;
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->wake.wait(lock, [this]
+                        { return this->has_pending || this->stopping; });
+        if (this->stopping)
+        {
+          return;
+        }
+        request = this->pending;
+        this->has_pending = false;
+      }
+
+      this->camera = request.camera;
+      this->scene->setObjects(request.meshes, request.transforms);
+      this->renderer.setPipeline(request.pipeline_kind);
+      this->renderer.setShadingMode(request.shading_mode);
+      this->renderer.setVisibilityMode(request.visibility_mode);
+      this->renderer.setOcclusionCulling(request.occlusion_culling);
+      if (this->back->getWidth() != request.width || this->back->getHeight() != request.height)
+      {
+        this->back->resize(request.width, request.height);
+      }
+      this->renderer.setFrameBuffer(this->back);
+      this->renderer.render(this->scene);
+      this->culled_meshes = this->renderer.getCulledMeshes();
+
+      // Publish the frame, and draw the next one into the frame the UI thread didn't take.
+      const uintptr_t frame = this->ready.exchange(reinterpret_cast<uintptr_t>(this->back) | FRESH_FRAME);
+      this->back = reinterpret_cast<FrameBuffer *>(frame & ~FRESH_FRAME);
+
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->busy = this->has_pending;
+    }
+  }
+} // namespace render
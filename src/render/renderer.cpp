@@ -0,0 +1,1257 @@
+#include <render/renderer.hpp>
+#include <core/camera.hpp>
+#include <core/face.hpp>
+#include <core/half_edge.hpp>
+#include <core/mesh.hpp>
+#include <core/scene.hpp>
+#include <core/vector.hpp>
+#include <math/math.hpp>
+#include <math/matrix.hpp>
+#include <pipeline/pipeline.hpp>
+#include <pipeline/clipping.hpp>
+#include <render/depth_sort.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace render
+{
+  /**
+   * @brief Construct a new Renderer object without a target, with a white light and a gray material
+   *
+   */
+  Renderer::Renderer()
+  {
+    this->setFrameBuffer(nullptr);
+    this->setPipeline(pipeline::PipelineKind::SANTA_CATARINA);
+    this->setShadingMode(ShadingMode::GOURAUD);
+    this->setVisibilityMode(VisibilityMode::Z_BUFFER);
+    this->setMaterial({{0.4f, 0.4f, 0.4f}, {0.7f, 0.7f, 0.7f}, {0.5f, 0.5f, 0.5f}, 2.15f});
+    this->setLights({});
+    this->addLight({{70.0, 20.0, 35.0}, {0.47f, 0.47f, 0.47f}, {0.8f, 0.8f, 0.8f}, {0.8f, 0.8f, 0.8f}});
+    this->setBackground({0.0f, 0.0f, 0.0f});
+    this->setWireframeColor({1.0f, 1.0f, 1.0f});
+    this->occlusion_culling = true;
+    this->culled_meshes = 0;
+    this->simplified_meshes = 0;
+    this->projected_meshes = 0;
+    this->stages.camera = nullptr;
+  }
+
+  /**
+   * @brief Construct a new Renderer object
+   *
+   * @param framebuffer The FrameBuffer the scene will be drawn into
+   */
+  Renderer::Renderer(FrameBuffer *framebuffer) : Renderer()
+  {
+    this->setFrameBuffer(framebuffer);
+  }
+
+  /**
+   * @brief Copy constructor of Renderer object, the frame buffer is shared
+   *
+   * @param r The Renderer to be copied
+   */
+  Renderer::Renderer(const Renderer &r)
+  {
+    *this = r;
+  }
+
+  Renderer::~Renderer()
+  {
+  }
+
+  /**
+   * @brief Get the FrameBuffer the scene is drawn into
+   *
+   * @return FrameBuffer* The target FrameBuffer
+   */
+  FrameBuffer *Renderer::getFrameBuffer() const
+  {
+    return this->framebuffer;
+  }
+
+  /**
+   * @brief Get the pipeline the meshes are projected with
+   *
+   * @return pipeline::PipelineKind The pipeline
+   */
+  pipeline::PipelineKind Renderer::getPipeline() const
+  {
+    return this->pipeline_kind;
+  }
+
+  /**
+   * @brief Get the shading model used to fill the faces
+   *
+   * @return ShadingMode The shading model
+   */
+  ShadingMode Renderer::getShadingMode() const
+  {
+    return this->shading_mode;
+  }
+
+  /**
+   * @brief Get how the visible surfaces are determined
+   *
+   * @return VisibilityMode The visibility mode
+   */
+  VisibilityMode Renderer::getVisibilityMode() const
+  {
+    return this->visibility_mode;
+  }
+
+  /**
+   * @brief Get the material applied to every mesh
+   *
+   * @return Material The material
+   */
+  Material Renderer::getMaterial() const
+  {
+    return this->material;
+  }
+
+  /**
+   * @brief Get the point lights of the scene
+   *
+   * @return std::vector<Light> The lights
+   */
+  std::vector<Light> Renderer::getLights() const
+  {
+    return this->lights;
+  }
+
+  /**
+   * @brief Get the color the frame buffer is cleared with
+   *
+   * @return Color The background color
+   */
+  Color Renderer::getBackground() const
+  {
+    return this->background;
+  }
+
+  /**
+   * @brief Get the color of the edges in wireframe mode
+   *
+   * @return Color The wireframe color
+   */
+  Color Renderer::getWireframeColor() const
+  {
+    return this->wireframe_color;
+  }
+
+  /**
+   * @brief Get whether the meshes hidden behind others are skipped
+   *
+   * @return bool true if occlusion culling is enabled
+   */
+  bool Renderer::getOcclusionCulling() const
+  {
+    return this->occlusion_culling;
+  }
+
+  /**
+   * @brief Get the number of meshes rejected by occlusion culling in the last frame
+   *
+   * @return int The number of culled meshes
+   */
+  int Renderer::getCulledMeshes() const
+  {
+    return this->culled_meshes;
+  }
+
+  /**
+   * @brief Get the number of meshes drawn with one of their levels of detail in the last frame
+   *
+   * @return int The number of simplified meshes
+   */
+  int Renderer::getSimplifiedMeshes() const
+  {
+    return this->simplified_meshes;
+  }
+
+  /**
+   * @brief Get the number of objects whose vertexes were projected in the last frame, the other
+   * objects drawn reused the projection of a previous frame
+   *
+   * @return int The number of projected objects
+   */
+  int Renderer::getProjectedMeshes() const
+  {
+    return this->projected_meshes;
+  }
+
+  /**
+   * @brief Set the FrameBuffer the scene is drawn into
+   *
+   * @param framebuffer The target FrameBuffer
+   */
+  void Renderer::setFrameBuffer(FrameBuffer *framebuffer)
+  {
+    this->framebuffer = framebuffer;
+  }
+
+  /**
+   * @brief Set the pipeline the meshes are projected with
+   *
+   * @param pipeline_kind The pipeline
+   */
+  void Renderer::setPipeline(pipeline::PipelineKind pipeline_kind)
+  {
+    this->pipeline_kind = pipeline_kind;
+  }
+
+  /**
+   * @brief Set the shading model used to fill the faces
+   *
+   * @param shading_mode The shading model
+   */
+  void Renderer::setShadingMode(ShadingMode shading_mode)
+  {
+    this->shading_mode = shading_mode;
+  }
+
+  /**
+   * @brief Set how the visible surfaces are determined
+   *
+   * @param visibility_mode The visibility mode
+   */
+  void Renderer::setVisibilityMode(VisibilityMode visibility_mode)
+  {
+    this->visibility_mode = visibility_mode;
+  }
+
+  /**
+   * @brief Set the material applied to every mesh
+   *
+   * @param material The material
+   */
+  void Renderer::setMaterial(Material material)
+  {
+    this->material = material;
+  }
+
+  /**
+   * @brief Set the point lights of the scene
+   *
+   * @param lights The lights
+   */
+  void Renderer::setLights(std::vector<Light> lights)
+  {
+    this->lights = lights;
+  }
+
+  /**
+   * @brief Set the color the frame buffer is cleared with
+   *
+   * @param background The background color
+   */
+  void Renderer::setBackground(Color background)
+  {
+    this->background = background;
+  }
+
+  /**
+   * @brief Set the color of the edges in wireframe mode
+   *
+   * @param wireframe_color The wireframe color
+   */
+  void Renderer::setWireframeColor(Color wireframe_color)
+  {
+    this->wireframe_color = wireframe_color;
+  }
+
+  /**
+   * @brief Enable or disable occlusion culling, disabling it forgets the visible meshes
+   *
+   * The visible meshes of the previous frame are kept while the setting doesn't change, so it can
+   * be set again on every frame.
+   *
+   * @param occlusion_culling true to skip the meshes hidden behind others
+   */
+  void Renderer::setOcclusionCulling(bool occlusion_culling)
+  {
+    if (occlusion_culling != this->occlusion_culling)
+    {
+      this->occlusion_culling = occlusion_culling;
+      this->visible_meshes.clear();
+    }
+  }
+
+  /**
+   * @brief Assignment operator of Renderer object, the frame buffer is shared
+   *
+   * @param r The Renderer to be copied
+   * @return Renderer& A reference to this Renderer
+   */
+  Renderer &Renderer::operator=(const Renderer &r)
+  {
+    this->framebuffer = r.framebuffer;
+    this->pipeline_kind = r.pipeline_kind;
+    this->shading_mode = r.shading_mode;
+    this->visibility_mode = r.visibility_mode;
+    this->material = r.material;
+    this->lights = r.lights;
+    this->background = r.background;
+    this->wireframe_color = r.wireframe_color;
+    this->occlusion_culling = r.occlusion_culling;
+    this->pyramid = r.pyramid;
+    this->triangulations = r.triangulations;
+    this->visible_meshes = r.visible_meshes;
+    this->object_lods = r.object_lods;
+    this->culled_meshes = r.culled_meshes;
+    this->simplified_meshes = r.simplified_meshes;
+    this->projected_meshes = r.projected_meshes;
+    this->stages = r.stages;
+    this->geometries = r.geometries;
+    this->object_projections = r.object_projections;
+    return *this;
+  }
+
+  /**
+   * @brief Add a point light to the scene
+   *
+   * @param light The light to be added
+   */
+  void Renderer::addLight(Light light)
+  {
+    this->lights.push_back(light);
+  }
+
+  /**
+   * @brief Check if a model matrix leaves the vertexes where they are modeled
+   *
+   */
+  static bool is_identity(const Math::Matrix4 &m)
+  {
+    return m == Math::identity_matrix();
+  }
+
+  /**
+   * @brief The matrix that moves the normals of a mesh with its model matrix.
+   *
+   * It is the matrix of the cofactors of the 3x3 part of the model, its inverse transpose up to the
+   * determinant, so the normals stay perpendicular to the faces under any scale. The sign of the
+   * determinant is kept out, so mirrored meshes keep their normals on the same side.
+   *
+   * @param m The model matrix.
+   * @return Math::Matrix4 The 3x3 normal matrix, in the upper left corner.
+   */
+  static Math::Matrix4 normal_matrix(const Math::Matrix4 &m)
+  {
+    Math::Matrix4 c = {};
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+        c[i][j] = m[i1][j1] * m[i2][j2] - m[i1][j2] * m[i2][j1];
+      }
+    }
+
+    const double det = m[0][0] * c[0][0] + m[0][1] * c[0][1] + m[0][2] * c[0][2];
+    if (det < 0)
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        for (int j = 0; j < 3; j++)
+        {
+          c[i][j] = -c[i][j];
+        }
+      }
+    }
+    return c;
+  }
+
+  /**
+   * @brief Move a normal with a normal matrix
+   *
+   */
+  static inline Core::Vertex::Vertex transform_normal(const Math::Matrix4 &c, double x, double y, double z)
+  {
+    return {c[0][0] * x + c[0][1] * y + c[0][2] * z,
+            c[1][0] * x + c[1][1] * y + c[1][2] * z,
+            c[2][0] * x + c[2][1] * y + c[2][2] * z};
+  }
+
+  /**
+   * @brief Draw the scene into the frame buffer, from the point of view of its camera
+   *
+   * @param scene The scene to be drawn
+   */
+  void Renderer::render(Core::Scene *scene)
+  {
+    if (this->framebuffer == nullptr)
+    {
+      return;
+    }
+
+    this->framebuffer->clear(pack_color(this->background.r, this->background.g, this->background.b));
+
+    Core::Camera *camera = scene->getCamera();
+    this->updateStages(*camera);
+    const Math::Matrix4 &view = this->stages.projection_view;
+    const Math::ScaleTranslateMatrix<double> &screen = this->stages.screen;
+    const pipeline::ClipVolume &volume = this->stages.volume;
+
+    // Faces inside the guard band are not clipped to the window, the scissor test cuts them.
+    std::vector<double> viewport = camera->getViewPort();
+    this->framebuffer->setScissor(static_cast<int>(std::floor(viewport[0])), static_cast<int>(std::floor(viewport[2])),
+                                  static_cast<int>(std::ceil(viewport[1])), static_cast<int>(std::ceil(viewport[3])));
+
+    std::vector<Core::Mesh *> meshes = scene->getObjects();
+    this->culled_meshes = 0;
+
+    // The model matrix of each mesh is folded into the transform of its vertexes.
+    const std::vector<Math::Matrix4> models = scene->getObjectTransforms();
+    std::vector<Math::Matrix4> mesh_views(meshes.size());
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+      mesh_views[i] = is_identity(models[i]) ? view : Math::multiply_matrix(view, models[i]);
+    }
+    // Small meshes are drawn with one of their levels of detail, the instances of a mesh may not
+    // share the same one.
+    this->object_lods.resize(meshes.size(), {nullptr, 0});
+    this->simplified_meshes = 0;
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+      meshes[i] = this->selectLod(i, meshes[i], mesh_views[i], screen, volume);
+      this->simplified_meshes += this->object_lods[i].level != 0;
+    }
+
+    // The geometry of the meshes that left the scene is dropped, the others keep theirs.
+    std::unordered_set<Core::Mesh *> frame_meshes(meshes.begin(), meshes.end());
+    std::erase_if(this->geometries, [&](const auto &entry)
+                  { return frame_meshes.count(entry.first) == 0; });
+    this->object_projections.resize(meshes.size());
+    this->projected_meshes = 0;
+
+    // The meshes are lit and projected relative to the observer, so the lights are moved with them
+    // and the eye is folded into the projection in double.
+    const Core::Vertex::Vertex eye = camera->getVRP();
+    const Math::Matrix4 eye_view = Math::multiply(view, Math::ScaleTranslateMatrix<double>{{1, 1, 1}, {eye.x, eye.y, eye.z}});
+    this->eye_lights = this->lights;
+    for (Light &light : this->eye_lights)
+    {
+      light.position = {light.position.x - eye.x, light.position.y - eye.y, light.position.z - eye.z};
+    }
+
+    auto draw = [&](size_t i)
+    {
+      this->renderMesh(i, meshes[i], eye_view, models[i], screen, volume, eye);
+    };
+
+    // The painter's algorithm doesn't test the depth buffer, so there is nothing to cull against.
+    if (this->visibility_mode == VisibilityMode::PAINTER)
+    {
+      this->painter_polygons.clear();
+      this->painter_keys.clear();
+      this->painter_raster.clear();
+      this->painter_phong.clear();
+
+      for (size_t i = 0; i < meshes.size(); i++)
+      {
+        draw(i);
+      }
+      this->drawPainterPolygons();
+      return;
+    }
+
+    // Lines don't write the depth buffer, so there is nothing to cull against.
+    if (!this->occlusion_culling || this->shading_mode == ShadingMode::WIREFRAME)
+    {
+      for (size_t i = 0; i < meshes.size(); i++)
+      {
+        draw(i);
+      }
+      return;
+    }
+
+    // Draw the meshes that were visible in the last frame, they are the likely occluders.
+    std::vector<bool> drawn(meshes.size(), false);
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+      if (i < this->visible_meshes.size() && this->visible_meshes[i] == meshes[i])
+      {
+        draw(i);
+        drawn[i] = true;
+      }
+    }
+
+    // Test every mesh against what was drawn in this frame, so the result is exact even if the
+    // camera moved, and draw the ones that may be visible and weren't drawn yet.
+    this->pyramid.build(*this->framebuffer);
+    this->visible_meshes.assign(meshes.size(), nullptr);
+
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+      if (this->isMeshOccluded(meshes[i], mesh_views[i], screen, volume))
+      {
+        this->culled_meshes += !drawn[i];
+        continue;
+      }
+
+      this->visible_meshes[i] = meshes[i];
+      if (!drawn[i])
+      {
+        draw(i);
+      }
+    }
+  }
+
+  /**
+   * @brief Bring the stages of the pipeline up to date with the camera, rebuilding only the ones
+   * it changed since the last frame
+   *
+   * Moving or turning the camera only rebuilds the view stage and the product, zooming only the
+   * projection stage, the product and the clip volume, and resizing the view port only the screen
+   * stage and the clip volume.
+   *
+   * @param camera The camera the frame is drawn from
+   */
+  void Renderer::updateStages(const Core::Camera &camera)
+  {
+    const pipeline::Pipeline &pipeline = pipeline::get_pipeline(this->pipeline_kind);
+    const bool all = this->stages.camera != &camera || this->stages.pipeline_kind != this->pipeline_kind;
+    const bool view = all || this->stages.view_version != camera.getViewVersion();
+    const bool projection = all || this->stages.projection_version != camera.getProjectionVersion();
+    const bool screen = all || this->stages.screen_version != camera.getScreenVersion();
+
+    if (view)
+    {
+      this->stages.view = pipeline.view(camera);
+    }
+    if (projection)
+    {
+      this->stages.projection = pipeline.projectionStage(camera);
+    }
+    if (view || projection)
+    {
+      this->stages.projection_view = pipeline::compose_projection_view(this->stages.projection, this->stages.view);
+    }
+    if (screen)
+    {
+      this->stages.screen = Math::to_scale_translate(pipeline.screen(camera));
+    }
+    if (projection || screen)
+    {
+      // The clip volume depends on the window, d (the near plane) and the guard band around the view port.
+      this->stages.volume = pipeline::clip_volume(pipeline.window(camera), camera.getViewPort(), pipeline.depthToH(camera, NEAR_PLANE));
+    }
+
+    this->stages.camera = &camera;
+    this->stages.pipeline_kind = this->pipeline_kind;
+    this->stages.view_version = camera.getViewVersion();
+    this->stages.projection_version = camera.getProjectionVersion();
+    this->stages.screen_version = camera.getScreenVersion();
+  }
+
+  /**
+   * @brief The corners of the bounding box of a mesh, where it is modeled
+   *
+   * @return false If the mesh has no vertexes.
+   */
+  static bool mesh_bounds(const Core::Mesh *mesh, Core::Vertex::Vertex &low, Core::Vertex::Vertex &high)
+  {
+    const std::vector<Core::Vector *> &vertexes = mesh->getVertexes();
+    if (vertexes.empty())
+    {
+      return false;
+    }
+
+    low = vertexes[0]->getVertex();
+    high = low;
+    for (Core::Vector *v : vertexes)
+    {
+      Core::Vertex::Vertex p = v->getVertex();
+      low = {std::min(low.x, p.x), std::min(low.y, p.y), std::min(low.z, p.z)};
+      high = {std::max(high.x, p.x), std::max(high.y, p.y), std::max(high.z, p.z)};
+    }
+    return true;
+  }
+
+  /**
+   * @brief Project a box to the screen rectangle around its 8 corners
+   *
+   * @param view The composed model to projection matrix (projection * view * model)
+   * @param screen The screen stage, a scale and a translation
+   * @param volume The clip volume of the camera
+   * @param low, high The corners of the box
+   * @param rect Filled with x_min, y_min, x_max and y_max
+   * @param max_inv_h Filled with the nearest 1/w of the corners
+   * @return false If the box crosses the near plane, the rectangle is then unbounded.
+   */
+  static bool screen_rect(const Math::Matrix4 &view, const Math::ScaleTranslateMatrix<double> &screen, const pipeline::ClipVolume &volume,
+                          const Core::Vertex::Vertex &low, const Core::Vertex::Vertex &high, double rect[4], double &max_inv_h)
+  {
+    rect[0] = rect[1] = INFINITY;
+    rect[2] = rect[3] = -INFINITY;
+    max_inv_h = 0;
+    for (int corner = 0; corner < 8; corner++)
+    {
+      Math::Point4<double> p = Math::apply_point(view, corner & 1 ? high.x : low.x, corner & 2 ? high.y : low.y, corner & 4 ? high.z : low.z);
+      if (p.h < volume.h_near)
+      {
+        return false;
+      }
+
+      const double inv_h = 1.0 / p.h;
+      const double x = screen.s[0] * (p.x * inv_h) + screen.t[0];
+      const double y = screen.s[1] * (p.y * inv_h) + screen.t[1];
+      rect[0] = std::min(rect[0], x);
+      rect[1] = std::min(rect[1], y);
+      rect[2] = std::max(rect[2], x);
+      rect[3] = std::max(rect[3], y);
+      max_inv_h = std::max(max_inv_h, inv_h);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Check if the bounding box of a mesh is hidden behind what is in the depth pyramid
+   *
+   * @param mesh The mesh to be tested
+   * @param view The composed model to projection matrix (projection * view * model)
+   * @param screen The screen stage, a scale and a translation
+   * @param volume The clip volume of the camera
+   * @return true If the mesh can't be visible
+   * @return false If the mesh may be visible, or its box crosses the near plane
+   */
+  bool Renderer::isMeshOccluded(Core::Mesh *mesh, const Math::Matrix4 &view, const Math::ScaleTranslateMatrix<double> &screen,
+                                const pipeline::ClipVolume &volume) const
+  {
+    Core::Vertex::Vertex low, high;
+    if (!mesh_bounds(mesh, low, high))
+    {
+      return true;
+    }
+
+    double rect[4], max_inv_h;
+    if (!screen_rect(view, screen, volume, low, high, rect, max_inv_h))
+    {
+      return false;
+    }
+
+    return this->pyramid.isOccluded(static_cast<float>(rect[0]), static_cast<float>(rect[1]),
+                                    static_cast<float>(rect[2]), static_cast<float>(rect[3]), static_cast<float>(max_inv_h));
+  }
+
+  /**
+   * @brief Choose the level of detail of a mesh, from the size on the screen of the details each
+   * level lost.
+   *
+   * Without a previous level, the coarsest level whose error is below LOD_MAX_ERROR pixels is
+   * chosen. The previous level is kept while its error stays below LOD_MAX_ERROR by the margin
+   * LOD_HYSTERESIS, and the next level's stays above it by the same margin, so a mesh at the
+   * distance of a threshold doesn't switch levels on every frame.
+   *
+   * @param lods The levels of the mesh, from the finest to the coarsest.
+   * @param pixels_per_unit The size on the screen of a unit of the mesh.
+   * @param previous The level chosen in the last frame, -1 if there is none.
+   * @return int The level, 0 for the mesh itself.
+   */
+  static int select_lod(const std::vector<Core::MeshLod> &lods, double pixels_per_unit, int previous)
+  {
+    const int levels = static_cast<int>(lods.size()) + 1;
+    auto error = [&](int level)
+    {
+      return level == 0 ? 0.0 : lods[level - 1].error * pixels_per_unit;
+    };
+
+    if (previous >= 0 && previous < levels && error(previous) <= LOD_MAX_ERROR * (1 + LOD_HYSTERESIS) &&
+        (previous + 1 == levels || error(previous + 1) > LOD_MAX_ERROR * (1 - LOD_HYSTERESIS)))
+    {
+      return previous;
+    }
+
+    int level = 0;
+    while (level + 1 < levels && error(level + 1) <= LOD_MAX_ERROR)
+    {
+      level++;
+    }
+    return level;
+  }
+
+  /**
+   * @brief Choose the mesh an object is drawn with in this frame: the mesh itself or one of its
+   * levels of detail, depending on its size on the screen
+   *
+   * @param object The index of the object in the scene, to find the level of the last frame
+   * @param mesh The mesh of the object
+   * @param view The composed model to projection matrix (projection * view * model)
+   * @param screen The screen stage, a scale and a translation
+   * @param volume The clip volume of the camera
+   * @return Core::Mesh* The mesh to be drawn
+   */
+  Core::Mesh *Renderer::selectLod(size_t object, Core::Mesh *mesh, const Math::Matrix4 &view, const Math::ScaleTranslateMatrix<double> &screen,
+                                  const pipeline::ClipVolume &volume)
+  {
+    ObjectLod &last = this->object_lods[object];
+    const std::vector<Core::MeshLod> &lods = mesh->getLods();
+    const int previous = last.mesh == mesh ? last.level : -1;
+    last = {mesh, 0};
+
+    // The coarsest level has few vertexes and the box of the mesh, up to its error, so the mesh is
+    // measured with it. Meshes crossing the near plane are near enough to be drawn in full.
+    Core::Vertex::Vertex low, high;
+    double rect[4], max_inv_h;
+    if (lods.empty() || !mesh_bounds(lods.back().mesh, low, high) || !screen_rect(view, screen, volume, low, high, rect, max_inv_h))
+    {
+      return mesh;
+    }
+
+    const double extent = std::max({high.x - low.x, high.y - low.y, high.z - low.z});
+    if (extent <= 0)
+    {
+      return mesh;
+    }
+
+    last.level = select_lod(lods, std::max(rect[2] - rect[0], rect[3] - rect[1]) / extent, previous);
+    return last.level == 0 ? mesh : lods[last.level - 1].mesh;
+  }
+
+  /**
+   * @brief Divide a clipped vertex by h and map it to the screen with the screen stage.
+   *
+   */
+  static inline void to_screen(const pipeline::ClipVertex &v, const Math::ScaleTranslateMatrix<double> &screen, float &x, float &y, float &inv_w)
+  {
+    double inv_h = 1.0 / v.h;
+
+    x = static_cast<float>(screen.s[0] * (v.x * inv_h) + screen.t[0]);
+    y = static_cast<float>(screen.s[1] * (v.y * inv_h) + screen.t[1]);
+    inv_w = static_cast<float>(inv_h);
+  }
+
+  /**
+   * @brief Gather the vertexes of a mesh where it is modeled, relative to the first one, and walk
+   * the half-edge loop of each face, computing the face normals and accumulating them (weighted by
+   * the face area) into the vertex normals.
+   *
+   * @param mesh The mesh.
+   * @param modeled Filled with its geometry.
+   */
+  static void build_geometry(Core::Mesh *mesh, MeshGeometry &modeled)
+  {
+    const std::vector<Core::Vector *> &vertexes = mesh->getVertexes();
+    const size_t num_vertexes = vertexes.size();
+
+    std::unordered_map<Core::Vector *, int> index;
+    index.reserve(num_vertexes);
+
+    modeled.origin = num_vertexes > 0 ? vertexes[0]->getVertex() : Core::Vertex::Vertex{0, 0, 0};
+    VertexBatch &batch = modeled.batch;
+    batch.px.resize(num_vertexes);
+    batch.py.resize(num_vertexes);
+    batch.pz.resize(num_vertexes);
+    batch.nx.assign(num_vertexes, 0.0f);
+    batch.ny.assign(num_vertexes, 0.0f);
+    batch.nz.assign(num_vertexes, 0.0f);
+
+    for (size_t i = 0; i < num_vertexes; i++)
+    {
+      Core::Vertex::Vertex p = vertexes[i]->getVertex();
+      index[vertexes[i]] = static_cast<int>(i);
+
+      batch.px[i] = static_cast<float>(p.x - modeled.origin.x);
+      batch.py[i] = static_cast<float>(p.y - modeled.origin.y);
+      batch.pz[i] = static_cast<float>(p.z - modeled.origin.z);
+    }
+
+    std::vector<Core::Face *> faces = mesh->getFaces();
+    modeled.loops.assign(faces.size(), {});
+    modeled.normals.resize(faces.size());
+    std::vector<Core::Vertex::Vertex> polygon;
+
+    for (size_t f = 0; f < faces.size(); f++)
+    {
+      Core::HalfEdge *first = faces[f]->getHalfEdge();
+      Core::HalfEdge *he = first;
+      polygon.clear();
+
+      do
+      {
+        modeled.loops[f].push_back(index[he->getOrigin()]);
+        polygon.push_back(he->getOrigin()->getVertex());
+        he = he->getNext();
+      } while (he != first && he != nullptr);
+
+      modeled.normals[f] = Math::newell_normal(polygon);
+
+      for (int i : modeled.loops[f])
+      {
+        batch.nx[i] += static_cast<float>(modeled.normals[f].x);
+        batch.ny[i] += static_cast<float>(modeled.normals[f].y);
+        batch.nz[i] += static_cast<float>(modeled.normals[f].z);
+      }
+    }
+  }
+
+  /**
+   * @brief Check if two screen stages are the same
+   *
+   */
+  static bool same_screen(const Math::ScaleTranslateMatrix<double> &a, const Math::ScaleTranslateMatrix<double> &b)
+  {
+    return std::equal(a.s, a.s + 3, b.s) && std::equal(a.t, a.t + 3, b.t);
+  }
+
+  /**
+   * @brief Project, clip, light and rasterize a single mesh
+   *
+   * Only what changed since the object was last drawn is computed again: its geometry when the
+   * topology of its mesh changes, its placed vertexes when it or the eye moves, and its projected
+   * vertexes when any stage of the camera changes. Code that moves the vertexes of a mesh in place
+   * gives it a new topology version, as for its triangulations.
+   *
+   * @param object The index of the object in the scene
+   * @param mesh The mesh to be drawn
+   * @param view The matrix that projects the points relative to the observer (projection * view,
+   * with the eye folded in)
+   * @param model The model matrix of the mesh
+   * @param screen The screen stage, a scale and a translation
+   * @param volume The clip volume of the camera
+   * @param eye The position of the observer (the VRP)
+   */
+  void Renderer::renderMesh(size_t object, Core::Mesh *mesh, const Math::Matrix4 &view, const Math::Matrix4 &model, const Math::ScaleTranslateMatrix<double> &screen,
+                            const pipeline::ClipVolume &volume, const Core::Vertex::Vertex &eye)
+  {
+    // The instances of a mesh share its geometry, built by the first one drawn.
+    // A new entry has version 0, which no mesh has.
+    MeshGeometry &geometry = this->geometries[mesh];
+    if (geometry.topology_version != mesh->getTopologyVersion())
+    {
+      build_geometry(mesh, geometry);
+      geometry.topology_version = mesh->getTopologyVersion();
+    }
+    const MeshGeometry *modeled = &geometry;
+
+    const size_t num_vertexes = modeled->batch.px.size();
+    const std::vector<std::vector<int>> &loops = modeled->loops;
+
+    ObjectProjection &cached = this->object_projections[object];
+    const bool placed = cached.mesh == mesh && cached.topology_version == mesh->getTopologyVersion() && cached.model == model &&
+                        cached.eye == eye;
+    const bool projected = placed && cached.view == view && same_screen(cached.screen, screen);
+    cached.mesh = mesh;
+    cached.topology_version = mesh->getTopologyVersion();
+    cached.model = model;
+    cached.eye = eye;
+    cached.view = view;
+    cached.screen = screen;
+
+    // The vertexes are lit and projected relative to the observer, in the axes of the SRU. They are
+    // placed and the eye is subtracted in double, so they keep their precision in float however far
+    // from the origin of the SRU they are. The modeled geometry is never written, each instance
+    // moves it into buffers of its own.
+    const VertexBatch &source = modeled->batch;
+    VertexBatch &batch = cached.world;
+    const bool identity = is_identity(model);
+    if (!placed)
+    {
+      batch.px.resize(num_vertexes);
+      batch.py.resize(num_vertexes);
+      batch.pz.resize(num_vertexes);
+
+      const Math::Point4<double> offset = Math::apply_point(model, modeled->origin.x, modeled->origin.y, modeled->origin.z);
+      const double dx = offset.x - eye.x, dy = offset.y - eye.y, dz = offset.z - eye.z;
+      for (size_t i = 0; i < num_vertexes; i++)
+      {
+        const double x = source.px[i], y = source.py[i], z = source.pz[i];
+        batch.px[i] = static_cast<float>(dx + model[0][0] * x + model[0][1] * y + model[0][2] * z);
+        batch.py[i] = static_cast<float>(dy + model[1][0] * x + model[1][1] * y + model[1][2] * z);
+        batch.pz[i] = static_cast<float>(dz + model[2][0] * x + model[2][1] * y + model[2][2] * z);
+      }
+
+      if (identity)
+      {
+        batch.nx = source.nx;
+        batch.ny = source.ny;
+        batch.nz = source.nz;
+      }
+      else
+      {
+        batch.nx.resize(num_vertexes);
+        batch.ny.resize(num_vertexes);
+        batch.nz.resize(num_vertexes);
+
+        const Math::Matrix4 normal_model = normal_matrix(model);
+        for (size_t i = 0; i < num_vertexes; i++)
+        {
+          const Core::Vertex::Vertex n = transform_normal(normal_model, source.nx[i], source.ny[i], source.nz[i]);
+          batch.nx[i] = static_cast<float>(n.x);
+          batch.ny[i] = static_cast<float>(n.y);
+          batch.nz[i] = static_cast<float>(n.z);
+        }
+
+        cached.world_normals.resize(modeled->normals.size());
+        for (size_t f = 0; f < modeled->normals.size(); f++)
+        {
+          const Core::Vertex::Vertex &n = modeled->normals[f];
+          cached.world_normals[f] = transform_normal(normal_model, n.x, n.y, n.z);
+        }
+      }
+    }
+    const std::vector<Core::Vertex::Vertex> &normals = identity ? modeled->normals : cached.world_normals;
+    const Core::Vertex::Vertex observer = {0, 0, 0};
+
+    // Project every vertex once, the faces only index into the projected buffers. Large meshes are
+    // projected in parallel chunks.
+    if (!projected)
+    {
+      pipeline::project_points(view, screen, batch.px.data(), batch.py.data(), batch.pz.data(), num_vertexes, cached.projection);
+      this->projected_meshes++;
+    }
+    const pipeline::ProjectedVertexes &batch_projection = cached.projection;
+    std::vector<uint32_t> &codes = this->codes;
+    std::vector<RasterVertex> &raster = this->raster;
+    codes.resize(num_vertexes);
+    raster.resize(num_vertexes);
+
+    // Load the position of a vertex before the division by h, read from the projected buffers.
+    auto load_position = [&](int i, pipeline::ClipVertex &v)
+    {
+      v.x = batch_projection.clip_x[i];
+      v.y = batch_projection.clip_y[i];
+      v.z = batch_projection.clip_z[i];
+      v.h = batch_projection.clip_h[i];
+    };
+
+    // Only the vertexes inside the guard band keep their screen coordinates, the others are clipped.
+    pipeline::ClipVertex position;
+    for (size_t i = 0; i < num_vertexes; i++)
+    {
+      load_position(static_cast<int>(i), position);
+      codes[i] = pipeline::outcode(position, volume);
+      raster[i] = {batch_projection.screen_x[i], batch_projection.screen_y[i], batch_projection.inv_h[i], this->wireframe_color};
+    }
+
+    if (this->shading_mode == ShadingMode::GOURAUD)
+    {
+      ColorBatch &colors = this->colors;
+      shade_vertices(batch, observer, this->material, this->eye_lights, colors);
+
+      for (size_t i = 0; i < num_vertexes; i++)
+      {
+        raster[i].color = {colors.r[i], colors.g[i], colors.b[i]};
+      }
+    }
+
+    std::vector<PhongVertex> &phong = this->phong;
+    const bool phong_shading = this->shading_mode == ShadingMode::PHONG;
+    if (phong_shading)
+    {
+      phong.resize(num_vertexes);
+
+      // Normalize the vertex normals so they are weighted evenly when interpolated.
+      for (size_t i = 0; i < num_vertexes; i++)
+      {
+        Core::Vertex::Vertex n = Math::fast_normalize({batch.nx[i], batch.ny[i], batch.nz[i]});
+        phong[i] = {raster[i].x, raster[i].y, raster[i].inv_w,
+                    batch.px[i], batch.py[i], batch.pz[i],
+                    static_cast<float>(n.x), static_cast<float>(n.y), static_cast<float>(n.z)};
+      }
+    }
+
+    // Load the clipping attributes of a vertex: world position, normal (a unit one with Phong
+    // shading) and color.
+    auto load = [&](int i, pipeline::ClipVertex &v)
+    {
+      load_position(i, v);
+      v.attributes[0] = batch.px[i];
+      v.attributes[1] = batch.py[i];
+      v.attributes[2] = batch.pz[i];
+      v.attributes[3] = phong_shading ? phong[i].nx : batch.nx[i];
+      v.attributes[4] = phong_shading ? phong[i].ny : batch.ny[i];
+      v.attributes[5] = phong_shading ? phong[i].nz : batch.nz[i];
+      v.attributes[6] = raster[i].color.r;
+      v.attributes[7] = raster[i].color.g;
+      v.attributes[8] = raster[i].color.b;
+    };
+
+    // In painter mode the polygons are recorded with their mean 1/w instead of filled, and drawn
+    // once the polygons of all meshes are sorted. In wireframe mode outline tells whether their
+    // edges are drawn.
+    const bool painter = this->visibility_mode == VisibilityMode::PAINTER;
+    bool outline = true;
+    auto record = [&](const RasterVertex *polygon_raster, const PhongVertex *polygon_phong, const int *indices, int count)
+    {
+      const uint32_t first = static_cast<uint32_t>(this->painter_raster.size());
+      float key = 0.0f;
+
+      for (int i = 0; i < count; i++)
+      {
+        const int v = indices != nullptr ? indices[i] : i;
+        this->painter_raster.push_back(polygon_raster[v]);
+        if (polygon_phong != nullptr)
+        {
+          this->painter_phong.push_back(polygon_phong[v]);
+        }
+        key += polygon_raster[v].inv_w;
+      }
+
+      this->painter_polygons.push_back({first, static_cast<uint32_t>(count), outline});
+      this->painter_keys.push_back(key / count);
+    };
+
+    // Clip a convex polygon and fill what is left of it as a triangle fan.
+    pipeline::ClipPolygon clipped;
+    auto clip_and_fill = [&](const int *indices, int count, uint32_t planes)
+    {
+      clipped.current = 0;
+      clipped.count = count;
+      for (int i = 0; i < count; i++)
+      {
+        load(indices[i], clipped.buffers[0][i]);
+      }
+
+      pipeline::clip_polygon(clipped, volume, planes, NUM_CLIP_ATTRIBUTES);
+
+      RasterVertex fan_raster[pipeline::CLIP_MAX_VERTICES];
+      PhongVertex fan_phong[pipeline::CLIP_MAX_VERTICES];
+      const pipeline::ClipVertex *out = clipped.buffers[clipped.current];
+
+      for (int i = 0; i < clipped.count; i++)
+      {
+        RasterVertex &r = fan_raster[i];
+        to_screen(out[i], screen, r.x, r.y, r.inv_w);
+        r.color = {out[i].attributes[6], out[i].attributes[7], out[i].attributes[8]};
+
+        fan_phong[i] = {r.x, r.y, r.inv_w,
+                        out[i].attributes[0], out[i].attributes[1], out[i].attributes[2],
+                        out[i].attributes[3], out[i].attributes[4], out[i].attributes[5]};
+      }
+
+      if (painter)
+      {
+        record(fan_raster, this->shading_mode == ShadingMode::PHONG ? fan_phong : nullptr, nullptr, clipped.count);
+        return;
+      }
+
+      if (this->shading_mode != ShadingMode::PHONG)
+      {
+        fill_polygon(*this->framebuffer, fan_raster, nullptr, clipped.count);
+        return;
+      }
+
+      for (int i = 1; i + 1 < clipped.count; i++)
+      {
+        fill_triangle_phong(*this->framebuffer, fan_phong[0], fan_phong[i], fan_phong[i + 1], observer, this->material, this->eye_lights);
+      }
+    };
+
+    // The triangles of the faces that can't be filled from their loop, kept until the topology
+    // of the mesh changes. The corners are positions in the loops. In painter mode the lines are
+    // drawn from clipped polygons too, so large faces crossing the guard band need them.
+    const geometry::MeshTriangulation *triangulation = nullptr;
+    if (this->shading_mode != ShadingMode::WIREFRAME || painter)
+    {
+      triangulation = &this->triangulations.get(mesh);
+    }
+
+    for (size_t f = 0; f < loops.size(); f++)
+    {
+      const std::vector<int> &loop = loops[f];
+
+      // Faces whose vertexes are all outside of the same plane are rejected.
+      uint32_t code_and = pipeline::CLIP_ALL | pipeline::GUARD_ALL;
+      uint32_t code_or = 0;
+      for (int i : loop)
+      {
+        code_and &= codes[i];
+        code_or |= codes[i];
+      }
+
+      if (loop.size() < 3 || (code_and & pipeline::CLIP_ALL) != 0)
+      {
+        continue;
+      }
+
+      if (this->shading_mode == ShadingMode::WIREFRAME && !painter)
+      {
+        for (size_t i = 0; i < loop.size(); i++)
+        {
+          int a = loop[i];
+          int b = loop[(i + 1) % loop.size()];
+
+          if (((codes[a] | codes[b]) & pipeline::GUARD_ALL) == 0)
+          {
+            draw_line(*this->framebuffer, raster[a], raster[b]);
+            continue;
+          }
+
+          pipeline::ClipVertex ca, cb;
+          load_position(a, ca);
+          load_position(b, cb);
+          if (pipeline::clip_segment(ca, cb, volume, 0))
+          {
+            RasterVertex ra = raster[a];
+            RasterVertex rb = raster[b];
+            to_screen(ca, screen, ra.x, ra.y, ra.inv_w);
+            to_screen(cb, screen, rb.x, rb.y, rb.inv_w);
+            draw_line(*this->framebuffer, ra, rb);
+          }
+        }
+        continue;
+      }
+
+      if (this->shading_mode == ShadingMode::FLAT)
+      {
+        Core::Vertex::Vertex centroid = {0, 0, 0};
+        for (int i : loop)
+        {
+          centroid.x += batch.px[i];
+          centroid.y += batch.py[i];
+          centroid.z += batch.pz[i];
+        }
+        centroid = Math::dot(1.0 / loop.size(), centroid);
+
+        Color color = shade_point(centroid, normals[f], observer, this->material, this->eye_lights);
+
+        // The rasterizer interpolates vertex colors, so give all of them the face color.
+        for (int i : loop)
+        {
+          raster[i].color = color;
+        }
+      }
+
+      // Only the faces that cross the near plane or leave the guard band are clipped.
+      if ((code_or & pipeline::GUARD_ALL) != 0)
+      {
+        // Large faces may not fit in the clip buffers and Phong shading fills the clipped polygons
+        // as fans, so their triangles are clipped one by one.
+        if (loop.size() <= static_cast<size_t>(pipeline::CLIP_MAX_VERTICES / 2) && this->shading_mode != ShadingMode::PHONG)
+        {
+          clip_and_fill(loop.data(), static_cast<int>(loop.size()), code_or & pipeline::GUARD_ALL);
+        }
+        else
+        {
+          // In painter wireframe mode the triangles only hide what is behind the face, its edges
+          // are recorded after them as clipped segments, so the diagonals are not drawn.
+          const bool separate_edges = painter && this->shading_mode == ShadingMode::WIREFRAME;
+          const size_t first_key = this->painter_keys.size();
+          outline = !separate_edges;
+          for (uint32_t t = triangulation->offsets[f]; t < triangulation->offsets[f + 1]; t++)
+          {
+            const geometry::Triangle &tri = triangulation->triangles[t];
+            const int triangle[3] = {loop[tri.a], loop[tri.b], loop[tri.c]};
+            clip_and_fill(triangle, 3, (codes[triangle[0]] | codes[triangle[1]] | codes[triangle[2]]) & pipeline::GUARD_ALL);
+          }
+          outline = true;
+
+          if (separate_edges && this->painter_keys.size() > first_key)
+          {
+            // The sort is stable, so with the key of the nearest triangle the edges come after all of them.
+            const float key = *std::max_element(this->painter_keys.begin() + first_key, this->painter_keys.end());
+            for (size_t i = 0; i < loop.size(); i++)
+            {
+              const int a = loop[i];
+              const int b = loop[(i + 1) % loop.size()];
+              pipeline::ClipVertex ca, cb;
+              load_position(a, ca);
+              load_position(b, cb);
+              if (pipeline::clip_segment(ca, cb, volume, 0))
+              {
+                RasterVertex segment[2] = {raster[a], raster[b]};
+                to_screen(ca, screen, segment[0].x, segment[0].y, segment[0].inv_w);
+                to_screen(cb, screen, segment[1].x, segment[1].y, segment[1].inv_w);
+                record(segment, nullptr, nullptr, 2);
+                this->painter_keys.back() = key;
+              }
+            }
+          }
+        }
+        continue;
+      }
+
+      if (painter && this->shading_mode != ShadingMode::PHONG)
+      {
+        record(raster.data(), nullptr, loop.data(), static_cast<int>(loop.size()));
+        continue;
+      }
+
+      // The faces are filled directly from their loops; with Phong shading they are drawn as the
+      // triangles of their (possibly concave) polygon.
+      if (this->shading_mode != ShadingMode::PHONG)
+      {
+        fill_polygon(*this->framebuffer, raster.data(), loop.data(), static_cast<int>(loop.size()));
+        continue;
+      }
+
+      for (uint32_t t = triangulation->offsets[f]; t < triangulation->offsets[f + 1]; t++)
+      {
+        const geometry::Triangle &tri = triangulation->triangles[t];
+        if (painter)
+        {
+          const int triangle[3] = {loop[tri.a], loop[tri.b], loop[tri.c]};
+          record(raster.data(), phong.data(), triangle, 3);
+          continue;
+        }
+        fill_triangle_phong(*this->framebuffer, phong[loop[tri.a]], phong[loop[tri.b]], phong[loop[tri.c]], observer, this->material, this->eye_lights);
+      }
+    }
+  }
+
+  /**
+   * @brief Sort the polygons recorded in painter mode by depth and draw them from back to front
+   *
+   * The depth test is disabled, so each polygon covers the ones drawn before it. In wireframe mode
+   * a polygon is filled with the background color before its edges are drawn, hiding the lines
+   * behind it; the edges of faces cut by the clipping stage include the cut. The polygons were lit
+   * relative to the observer, which is at the origin.
+   *
+   */
+  void Renderer::drawPainterPolygons()
+  {
+    const Core::Vertex::Vertex observer = {0, 0, 0};
+    std::vector<uint32_t> order(this->painter_polygons.size());
+    radix_sort(this->painter_keys.data(), this->painter_keys.size(), order.data());
+
+    this->framebuffer->setDepthTest(false);
+    std::vector<RasterVertex> hidden;
+
+    // The least 1/w is the farthest polygon, so the ascending order is back to front.
+    for (uint32_t p : order)
+    {
+      const PainterPolygon &polygon = this->painter_polygons[p];
+      const RasterVertex *r = this->painter_raster.data() + polygon.first;
+      const int count = static_cast<int>(polygon.count);
+
+      if (this->shading_mode == ShadingMode::WIREFRAME)
+      {
+        hidden.assign(r, r + count);
+        for (RasterVertex &v : hidden)
+        {
+          v.color = this->background;
+        }
+        fill_polygon(*this->framebuffer, hidden.data(), nullptr, count);
+
+        // A segment has a single edge.
+        const int edges = polygon.outline ? (count == 2 ? 1 : count) : 0;
+        for (int i = 0; i < edges; i++)
+        {
+          draw_line(*this->framebuffer, r[i], r[(i + 1) % count]);
+        }
+      }
+      else if (this->shading_mode == ShadingMode::PHONG)
+      {
+        const PhongVertex *v = this->painter_phong.data() + polygon.first;
+        for (int i = 1; i + 1 < count; i++)
+        {
+          fill_triangle_phong(*this->framebuffer, v[0], v[i], v[i + 1], observer, this->material, this->eye_lights);
+        }
+      }
+      else
+      {
+        fill_polygon(*this->framebuffer, r, nullptr, count);
+      }
+    }
+
+    this->framebuffer->setDepthTest(true);
+  }
+} // namespace render
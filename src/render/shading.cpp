@@ -0,0 +1,204 @@
+#include <render/shading.hpp>
+#include <render/framebuffer.hpp>
+#include <math/math.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace render
+{
+  /**
+   * @brief Reciprocal square root, either to the float precision or approximated with
+   * Math::fast_rsqrt.
+   *
+   * The precise one refines Math::fast_rsqrt with a third Newton-Raphson iteration: std::sqrt
+   * checks its argument to set errno, and the branch keeps the loops scalar.
+   *
+   */
+  template <bool FAST>
+  static inline float rsqrt(float x)
+  {
+    const float y = Math::fast_rsqrt(x);
+    if constexpr (FAST)
+    {
+      return y;
+    }
+    else
+    {
+      return y * (1.5f - 0.5f * x * y * y);
+    }
+  }
+
+  /**
+   * @brief Evaluate the Phong illumination model for count points stored as a structure of arrays.
+   *
+   * The lights are iterated in the outer loop and the points in the inner one, which is free of
+   * branches and works on contiguous floats, so the compiler turns it into SIMD code. The specular
+   * power is Math::fast_pow, std::pow would keep the loop scalar. The lighting
+   * is two-sided: normals facing away from the eye are flipped.
+   *
+   */
+  template <bool FAST>
+  static void shade(const float *px, const float *py, const float *pz, const float *nx, const float *ny, const float *nz,
+                    size_t count, const Core::Vertex::Vertex &eye, const Material &material, const std::vector<Light> &lights,
+                    float *r, float *g, float *b)
+  {
+    const float ex = static_cast<float>(eye.x);
+    const float ey = static_cast<float>(eye.y);
+    const float ez = static_cast<float>(eye.z);
+    const float shininess = material.shininess;
+
+    for (size_t i = 0; i < count; i++)
+    {
+      r[i] = 0.0f;
+      g[i] = 0.0f;
+      b[i] = 0.0f;
+    }
+
+    for (const Light &light : lights)
+    {
+      const float lx = static_cast<float>(light.position.x);
+      const float ly = static_cast<float>(light.position.y);
+      const float lz = static_cast<float>(light.position.z);
+
+      const float ar = light.ambient.r * material.ka.r;
+      const float ag = light.ambient.g * material.ka.g;
+      const float ab = light.ambient.b * material.ka.b;
+      const float dr = light.diffuse.r * material.kd.r;
+      const float dg = light.diffuse.g * material.kd.g;
+      const float db = light.diffuse.b * material.kd.b;
+      const float sr = light.specular.r * material.ks.r;
+      const float sg = light.specular.g * material.ks.g;
+      const float sb = light.specular.b * material.ks.b;
+
+      for (size_t i = 0; i < count; i++)
+      {
+        // Normalized N, L (to the light) and S (to the observer).
+        float n_inv = rsqrt<FAST>(nx[i] * nx[i] + ny[i] * ny[i] + nz[i] * nz[i] + 1e-20f);
+        float n_x = nx[i] * n_inv;
+        float n_y = ny[i] * n_inv;
+        float n_z = nz[i] * n_inv;
+
+        float l_x = lx - px[i];
+        float l_y = ly - py[i];
+        float l_z = lz - pz[i];
+        float l_inv = rsqrt<FAST>(l_x * l_x + l_y * l_y + l_z * l_z + 1e-20f);
+        l_x *= l_inv;
+        l_y *= l_inv;
+        l_z *= l_inv;
+
+        float s_x = ex - px[i];
+        float s_y = ey - py[i];
+        float s_z = ez - pz[i];
+        float s_inv = rsqrt<FAST>(s_x * s_x + s_y * s_y + s_z * s_z + 1e-20f);
+        s_x *= s_inv;
+        s_y *= s_inv;
+        s_z *= s_inv;
+
+        float side = std::copysign(1.0f, n_x * s_x + n_y * s_y + n_z * s_z);
+        n_x *= side;
+        n_y *= side;
+        n_z *= side;
+
+        float n_dot_l = n_x * l_x + n_y * l_y + n_z * l_z;
+        float diffuse = Math::mask_select(n_dot_l > 0.0f, n_dot_l, 0.0f);
+
+        // R = 2(N.L)N - L
+        float r_x = 2.0f * n_dot_l * n_x - l_x;
+        float r_y = 2.0f * n_dot_l * n_y - l_y;
+        float r_z = 2.0f * n_dot_l * n_z - l_z;
+        float r_dot_s = r_x * s_x + r_y * s_y + r_z * s_z;
+        // Computed for every lane and masked, a branch around it would keep the loop scalar.
+        float specular = Math::mask_select(n_dot_l > 0.0f, Math::fast_pow(r_dot_s, shininess), 0.0f);
+
+        r[i] += ar + dr * diffuse + sr * specular;
+        g[i] += ag + dg * diffuse + sg * specular;
+        b[i] += ab + db * diffuse + sb * specular;
+      }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+      r[i] = std::min(r[i], 1.0f);
+      g[i] = std::min(g[i], 1.0f);
+      b[i] = std::min(b[i], 1.0f);
+    }
+  }
+
+  /**
+   * @brief Evaluate the Phong illumination model at a single point.
+   *
+   * Used for constant (flat) shading, where the whole face gets the intensity of its centroid.
+   *
+   * @param point The point being lit, in world coordinates (SRU).
+   * @param normal The normal of the surface at the point, it doesn't need to be normalized.
+   * @param eye The position of the observer (the VRP).
+   * @param material The reflection coefficients of the surface.
+   * @param lights The point lights of the scene.
+   * @return Color The intensity at the point, clamped to [0, 1].
+   */
+  Color shade_point(const Core::Vertex::Vertex &point, const Core::Vertex::Vertex &normal, const Core::Vertex::Vertex &eye,
+                    const Material &material, const std::vector<Light> &lights)
+  {
+    float px = static_cast<float>(point.x);
+    float py = static_cast<float>(point.y);
+    float pz = static_cast<float>(point.z);
+    float nx = static_cast<float>(normal.x);
+    float ny = static_cast<float>(normal.y);
+    float nz = static_cast<float>(normal.z);
+    Color color;
+
+    shade<false>(&px, &py, &pz, &nx, &ny, &nz, 1, eye, material, lights, &color.r, &color.g, &color.b);
+
+    return color;
+  }
+
+  /**
+   * @brief Evaluate the Phong illumination model for a batch of vertices, for Gouraud shading.
+   *
+   * @param batch The positions (world coordinates) and normals of the vertices.
+   * @param eye The position of the observer (the VRP).
+   * @param material The reflection coefficients of the surface.
+   * @param lights The point lights of the scene.
+   * @param out The intensities of each vertex, clamped to [0, 1].
+   */
+  void shade_vertices(const VertexBatch &batch, const Core::Vertex::Vertex &eye, const Material &material,
+                      const std::vector<Light> &lights, ColorBatch &out)
+  {
+    const size_t count = batch.px.size();
+
+    out.r.resize(count);
+    out.g.resize(count);
+    out.b.resize(count);
+
+    shade<false>(batch.px.data(), batch.py.data(), batch.pz.data(), batch.nx.data(), batch.ny.data(), batch.nz.data(),
+                 count, eye, material, lights, out.r.data(), out.g.data(), out.b.data());
+  }
+
+  /**
+   * @brief Evaluate the Phong illumination model for a group of fragments, for Phong shading.
+   *
+   * All the FRAGMENT_LANES lanes are always shaded, so the loops have a constant trip count and
+   * the vectors are normalized with Math::fast_rsqrt.
+   *
+   * @param batch The interpolated positions (world coordinates) and normals of the fragments.
+   * @param eye The position of the observer (the VRP).
+   * @param material The reflection coefficients of the surface.
+   * @param lights The point lights of the scene.
+   * @param out The packed colors of the fragments, FRAGMENT_LANES entries.
+   */
+  void shade_fragments(const FragmentBatch &batch, const Core::Vertex::Vertex &eye, const Material &material,
+                       const std::vector<Light> &lights, uint32_t *out)
+  {
+    alignas(32) float r[FRAGMENT_LANES];
+    alignas(32) float g[FRAGMENT_LANES];
+    alignas(32) float b[FRAGMENT_LANES];
+
+    shade<true>(batch.px, batch.py, batch.pz, batch.nx, batch.ny, batch.nz, FRAGMENT_LANES, eye, material, lights, r, g, b);
+
+    for (int i = 0; i < FRAGMENT_LANES; i++)
+    {
+      out[i] = pack_color(r[i], g[i], b[i]);
+    }
+  }
+} // namespace render
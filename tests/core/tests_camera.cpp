@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <core/camera.hpp>
+#include <core/vector.hpp>
+#include <math/math.hpp>
+#include <pipeline/pipeline.hpp>
+
+#include <cmath>
+
+class CameraTest : public ::testing::Test
+{
+protected:
+  Core::Camera camera = Core::Camera({25, 15, 80}, {20, 10, 25}, 40, {0, 319, 0, 239}, {0, 16, 0, 12});
+  // The step given to the camera, reused by every move
+  Core::Vector *step = new Core::Vector();
+
+  void SetUp() override {}
+
+  Core::Vector *setStep(double x, double y, double z)
+  {
+    step->setX(x);
+    step->setY(y);
+    step->setZ(z);
+    return step;
+  }
+
+  void expectMatrixNear(const Math::Matrix4 &result, const Math::Matrix4 &expected, double error)
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        EXPECT_NEAR(result[i][j], expected[i][j], error);
+      }
+    }
+  }
+};
+
+/**
+ * @brief Test case for move: the updated view matrix is the one built from the moved VRP and P,
+ * and only the view stage changes.
+ *
+ */
+TEST_F(CameraTest, move)
+{
+  // Arrange
+  const Core::Vertex::Vertex p = camera.getP();
+  const double distance = Math::length(camera.getVRP(), p);
+  const uint64_t projection_version = camera.getProjectionVersion();
+  const uint64_t screen_version = camera.getScreenVersion();
+  const uint64_t view_version = camera.getViewVersion();
+
+  // Act
+  camera.move(setStep(3, -2, -5));
+
+  // Expect
+  expectMatrixNear(camera.getView(), Math::to_matrix4(pipeline::santa_catarina::sru2src(camera.getVRP(), camera.getP())), 1e-9);
+  EXPECT_NEAR(Math::length(camera.getVRP(), camera.getP()), distance - 5, 1e-9);
+  EXPECT_NE(camera.getP(), p);
+  EXPECT_NE(camera.getViewVersion(), view_version);
+  EXPECT_EQ(camera.getProjectionVersion(), projection_version);
+  EXPECT_EQ(camera.getScreenVersion(), screen_version);
+}
+
+/**
+ * @brief Test case for rotate: the camera orbits around P, keeps its distance and looks at P,
+ * and a turn around the vertical axis is the view built from scratch.
+ *
+ */
+TEST_F(CameraTest, rotate)
+{
+  // Arrange
+  Core::Camera level({0, 0, 80}, {0, 0, 10}, 100, {0, 255, 0, 255}, {-3, 3, -3, 3});
+  const double distance = Math::length(camera.getVRP(), camera.getP());
+
+  // Act
+  level.rotate(setStep(0, M_PI / 2, 0));
+  for (int i = 0; i < 1000; i++)
+  {
+    camera.rotate(setStep(0.01, 0.02, 0.005));
+  }
+
+  // Expect
+  EXPECT_NEAR(level.getVRP().x, 70, 1e-9);
+  EXPECT_NEAR(level.getVRP().z, 10, 1e-9);
+  expectMatrixNear(level.getView(), Math::to_matrix4(pipeline::santa_catarina::sru2src(level.getVRP(), level.getP())), 1e-9);
+
+  EXPECT_NEAR(Math::length(camera.getVRP(), camera.getP()), distance, 1e-9);
+  const Math::Matrix4 view = camera.getView();
+  const Core::Vertex::Vertex p = camera.getP();
+  for (int i = 0; i < 3; i++)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      const double dot = view[i][0] * view[j][0] + view[i][1] * view[j][1] + view[i][2] * view[j][2];
+      EXPECT_NEAR(dot, i == j, 1e-12);
+    }
+    // P is on the view axis, in front of the camera.
+    const double coordinate = view[i][0] * p.x + view[i][1] * p.y + view[i][2] * p.z + view[i][3];
+    EXPECT_NEAR(coordinate, i == 2 ? -distance : 0, 1e-9);
+  }
+}
+
+/**
+ * @brief Test case for zoom: d changes and only the projection stage changes.
+ *
+ */
+TEST_F(CameraTest, zoom)
+{
+  // Arrange
+  const uint64_t view_version = camera.getViewVersion();
+  const uint64_t projection_version = camera.getProjectionVersion();
+
+  // Act
+  camera.zoom(setStep(0, 0, -std::log(2.0)));
+
+  // Expect
+  EXPECT_NEAR(camera.getD(), 80, 1e-9);
+  EXPECT_EQ(camera.getViewVersion(), view_version);
+  EXPECT_NE(camera.getProjectionVersion(), projection_version);
+}
+
+/**
+ * @brief Test case for orbiting over the poles: the view stays orthonormal while the camera looks
+ * straight down, and building it again from the up vector gives the same matrix.
+ *
+ */
+TEST_F(CameraTest, orbit_over_poles)
+{
+  // Arrange
+  Core::Camera level({0, 0, 80}, {0, 0, 10}, 100, {0, 255, 0, 255}, {-3, 3, -3, 3});
+
+  // Act
+  for (int i = 0; i < 400; i++)
+  {
+    level.rotate(setStep(M_PI / 100, 0, 0));
+  }
+  const Math::Matrix4 rotated = level.getView();
+  level.setP(level.getP());
+
+  // Expect
+  expectMatrixNear(level.getView(), rotated, 1e-9);
+  EXPECT_NEAR(level.getVRP().z, 80, 1e-6);
+  for (int i = 0; i < 3; i++)
+  {
+    for (int j = 0; j < 4; j++)
+    {
+      EXPECT_TRUE(std::isfinite(rotated[i][j]));
+    }
+  }
+}
+
+/**
+ * @brief Test case for copies: a copied or assigned camera keeps the versions and the view of the
+ * original, until one of them changes.
+ *
+ */
+TEST_F(CameraTest, copy_keeps_versions)
+{
+  // Arrange
+  camera.move(setStep(1, 2, 3));
+  Core::Camera assigned;
+
+  // Act
+  Core::Camera copy(camera);
+  assigned = camera;
+  copy.setD(20);
+
+  // Expect
+  EXPECT_EQ(assigned.getViewVersion(), camera.getViewVersion());
+  EXPECT_EQ(assigned.getProjectionVersion(), camera.getProjectionVersion());
+  EXPECT_EQ(assigned.getScreenVersion(), camera.getScreenVersion());
+  expectMatrixNear(assigned.getView(), camera.getView(), 0);
+  EXPECT_EQ(copy.getViewVersion(), camera.getViewVersion());
+  EXPECT_NE(copy.getProjectionVersion(), camera.getProjectionVersion());
+  expectMatrixNear(copy.getView(), camera.getView(), 0);
+}
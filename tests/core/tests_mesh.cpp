@@ -193,4 +193,13 @@ TEST_F(MeshTest, cube_mesh_constructor)
     }
     std::cout << std::endl;
   }
+
+  // Every half-edge of the closed cube has a twin going the other way.
+  EXPECT_EQ(mesh->getMesh().size(), 24);
+  for (Core::HalfEdge *he : mesh->getMesh())
+  {
+    ASSERT_NE(he->getTwin(), nullptr);
+    EXPECT_EQ(he->getTwin()->getTwin(), he);
+    EXPECT_EQ(he->getTwin()->getOrigin(), he->getNext()->getOrigin());
+  }
 }
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <core/camera.hpp>
+#include <core/mesh.hpp>
+#include <core/scene.hpp>
+#include <math/math.hpp>
+
+#include <vector>
+
+class SceneTest : public ::testing::Test
+{
+protected:
+  Core::Mesh *table = new Core::Mesh({}, {}, "table");
+  Core::Mesh *cup = new Core::Mesh({}, {}, "cup");
+  Core::Mesh *chair = new Core::Mesh({}, {}, "chair");
+  Core::Scene *scene = new Core::Scene({}, new Core::Camera());
+
+  void SetUp() override {}
+
+  static Math::Matrix4 translation(double x, double y, double z)
+  {
+    Math::Matrix4 m = Math::identity_matrix();
+    m[0][3] = x;
+    m[1][3] = y;
+    m[2][3] = z;
+    return m;
+  }
+
+  static void expectMatrix(const Math::Matrix4 &actual, const Math::Matrix4 &expected)
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        EXPECT_DOUBLE_EQ(actual[i][j], expected[i][j]);
+      }
+    }
+  }
+};
+
+/**
+ * @brief Test case for the world matrices: a child is placed relative to its parent, and moving
+ * the parent moves the child along.
+ *
+ */
+TEST_F(SceneTest, world_transforms)
+{
+  // Arrange
+  const int t = scene->addNode(table, -1, translation(10, 0, 0));
+  const int c = scene->addNode(cup, t, translation(0, 1, 0));
+  scene->addObject(chair);
+
+  // Act
+  scene->setLocalTransform(t, translation(20, 0, 5));
+
+  // Expect
+  expectMatrix(scene->getWorldTransform(c), translation(20, 1, 5));
+  const std::vector<Math::Matrix4> transforms = scene->getObjectTransforms();
+  ASSERT_EQ(transforms.size(), 3u);
+  expectMatrix(transforms[0], translation(20, 0, 5));
+  expectMatrix(transforms[1], translation(20, 1, 5));
+  expectMatrix(transforms[2], Math::identity_matrix());
+}
+
+/**
+ * @brief Test case for the transform version: it changes when a node is moved, added or removed,
+ * and the objects removed leave their children in place.
+ *
+ */
+TEST_F(SceneTest, transform_version)
+{
+  // Arrange
+  const int t = scene->addNode(table, -1, translation(10, 0, 0));
+  const int c = scene->addNode(cup, t, translation(0, 1, 0));
+  const uint64_t added = scene->getTransformVersion();
+
+  // Act
+  scene->setLocalTransform(c, translation(0, 2, 0));
+  const uint64_t moved = scene->getTransformVersion();
+  scene->removeObject(table);
+
+  // Expect
+  EXPECT_NE(moved, added);
+  EXPECT_NE(scene->getTransformVersion(), moved);
+  ASSERT_EQ(scene->getObjects().size(), 1u);
+  EXPECT_EQ(scene->getObjects()[0], cup);
+  expectMatrix(scene->getObjectTransforms()[0], translation(10, 2, 0));
+}
+
+/**
+ * @brief Test case for an invalid parent: the node isn't added and the scene is unchanged.
+ *
+ */
+TEST_F(SceneTest, invalid_parent)
+{
+  // Arrange
+  const int t = scene->addNode(table, -1, translation(10, 0, 0));
+  const uint64_t added = scene->getTransformVersion();
+
+  // Act
+  const int ahead = scene->addNode(cup, t + 1, translation(0, 1, 0));
+  const int negative = scene->addNode(chair, -2, translation(0, 1, 0));
+
+  // Expect
+  EXPECT_EQ(ahead, -1);
+  EXPECT_EQ(negative, -1);
+  EXPECT_EQ(scene->getTransformVersion(), added);
+  ASSERT_EQ(scene->getObjects().size(), 1u);
+  EXPECT_EQ(scene->getObjects()[0], table);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <core/face.hpp>
+#include <core/half_edge.hpp>
+#include <core/mesh.hpp>
+#include <core/vector.hpp>
+#include <geometry/constrained.hpp>
+#include <geometry/predicates.hpp>
+
+#include <random>
+#include <vector>
+
+class ConstrainedTest : public ::testing::Test
+{
+protected:
+  void SetUp() override {}
+
+  std::vector<Core::Vertex::Vertex> randomPoints(size_t count, unsigned seed)
+  {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coordinate(-100.0, 100.0);
+    std::vector<Core::Vertex::Vertex> points(count);
+    for (Core::Vertex::Vertex &p : points)
+    {
+      p = {coordinate(rng), coordinate(rng), 0.0};
+    }
+    return points;
+  }
+
+  static geometry::Point2 position(const Core::Vector *v)
+  {
+    return {v->getX(), v->getY()};
+  }
+
+  // Whether the mesh has a constrained edge between the two vertexes
+  static bool hasConstrainedEdge(Core::Mesh *mesh, const Core::Vector *from, const Core::Vector *to)
+  {
+    for (Core::HalfEdge *he : mesh->getMesh())
+    {
+      if (he->getOrigin() == from && he->getNext()->getOrigin() == to)
+      {
+        return he->isConstrained();
+      }
+    }
+    return false;
+  }
+
+  // Check the loops and twins are consistent, the faces turn counterclockwise and the edges that
+  // are not constrained are locally Delaunay.
+  void expectConstrainedDelaunay(Core::Mesh *mesh)
+  {
+    for (Core::HalfEdge *he : mesh->getMesh())
+    {
+      EXPECT_EQ(he->getNext()->getNext()->getNext(), he);
+      EXPECT_EQ(he->getNext()->getPrev(), he);
+      EXPECT_EQ(he->getNext()->getFace(), he->getFace());
+      EXPECT_GT(geometry::orient2d(position(he->getOrigin()), position(he->getNext()->getOrigin()),
+                                   position(he->getPrev()->getOrigin())),
+                0);
+
+      Core::HalfEdge *twin = he->getTwin();
+      if (twin == nullptr)
+      {
+        continue;
+      }
+      EXPECT_EQ(twin->getTwin(), he);
+      EXPECT_EQ(twin->getOrigin(), he->getNext()->getOrigin());
+      EXPECT_EQ(twin->isConstrained(), he->isConstrained());
+      if (!he->isConstrained())
+      {
+        EXPECT_LE(geometry::incircle(position(he->getOrigin()), position(he->getNext()->getOrigin()),
+                                     position(he->getPrev()->getOrigin()), position(twin->getPrev()->getOrigin())),
+                  0);
+      }
+    }
+    for (Core::Vector *v : mesh->getVertexes())
+    {
+      if (v->getHalfEdge() != nullptr)
+      {
+        EXPECT_EQ(v->getHalfEdge()->getOrigin(), v);
+      }
+    }
+  }
+};
+
+/**
+ * @brief Test case for breaklines across random points: their edges are in the mesh and
+ * constrained, the number of triangles doesn't change and the rest stays Delaunay.
+ *
+ */
+TEST_F(ConstrainedTest, random_breaklines)
+{
+  // Arrange
+  const std::vector<Core::Vertex::Vertex> points = randomPoints(400, 5);
+  const std::vector<geometry::Segment> segments = {{0, 1}, {2, 3}, {4, 5}, {6, 7}};
+
+  // Act
+  Core::Mesh *unconstrained = geometry::constrained_delaunay_mesh(points, {}, "terrain");
+  Core::Mesh *mesh = geometry::constrained_delaunay_mesh(points, segments, "terrain");
+
+  // Expect
+  EXPECT_EQ(mesh->getFaces().size(), unconstrained->getFaces().size());
+  const std::vector<Core::Vector *> vertexes = mesh->getVertexes();
+  int inserted = 0;
+  for (const geometry::Segment &segment : segments)
+  {
+    // The random segments may cross each other, then the later one is left out.
+    inserted += hasConstrainedEdge(mesh, vertexes[segment.a], vertexes[segment.b]) ||
+                hasConstrainedEdge(mesh, vertexes[segment.b], vertexes[segment.a]);
+  }
+  EXPECT_GE(inserted, 1);
+  EXPECT_TRUE(hasConstrainedEdge(mesh, vertexes[0], vertexes[1]));
+  expectConstrainedDelaunay(mesh);
+}
+
+/**
+ * @brief Test case for an outline through vertexes of a grid: it is split at the vertexes it
+ * goes through.
+ *
+ */
+TEST_F(ConstrainedTest, outline_through_vertexes)
+{
+  // Arrange
+  std::vector<Core::Vertex::Vertex> points;
+  for (int y = 0; y <= 10; y++)
+  {
+    for (int x = 0; x <= 10; x++)
+    {
+      points.push_back({x + 0.01 * ((x * 7 + y * 3) % 5), y + 0.0, 0.0});
+    }
+  }
+  points[2 * 11 + 4] = {4, 2, 0};
+  points[4 * 11 + 8] = {8, 4, 0};
+  Core::Mesh *mesh = geometry::constrained_delaunay_mesh(points, {}, "floorplan");
+  const uint64_t version = mesh->getTopologyVersion();
+  const std::vector<Core::Vector *> vertexes = mesh->getVertexes();
+
+  // Act
+  const bool inserted = geometry::insert_constraint(mesh, vertexes[0], vertexes[4 * 11 + 8]);
+
+  // Expect
+  EXPECT_TRUE(inserted);
+  EXPECT_NE(mesh->getTopologyVersion(), version);
+  EXPECT_TRUE(hasConstrainedEdge(mesh, vertexes[0], vertexes[2 * 11 + 4]));
+  EXPECT_TRUE(hasConstrainedEdge(mesh, vertexes[2 * 11 + 4], vertexes[4 * 11 + 8]));
+  expectConstrainedDelaunay(mesh);
+}
+
+/**
+ * @brief Test case for crossing constraints: the second one is refused and the first one kept.
+ *
+ */
+TEST_F(ConstrainedTest, crossing_constraints)
+{
+  // Arrange
+  std::vector<Core::Vertex::Vertex> points = randomPoints(200, 9);
+  points[0] = {-90, 0, 0};
+  points[1] = {90, 0, 0};
+  points[2] = {0, -90, 0};
+  points[3] = {0, 90, 0};
+
+  // Act
+  Core::Mesh *mesh = geometry::constrained_delaunay_mesh(points, {}, "floorplan");
+  const size_t inserted = geometry::insert_constraints(mesh, {{0, 1}, {2, 3}});
+
+  // Expect
+  const std::vector<Core::Vector *> vertexes = mesh->getVertexes();
+  EXPECT_EQ(inserted, 1);
+  EXPECT_TRUE(hasConstrainedEdge(mesh, vertexes[0], vertexes[1]));
+  EXPECT_FALSE(hasConstrainedEdge(mesh, vertexes[2], vertexes[3]));
+  expectConstrainedDelaunay(mesh);
+}
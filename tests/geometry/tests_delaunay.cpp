@@ -0,0 +1,374 @@
+#include <gtest/gtest.h>
+#include <core/face.hpp>
+#include <core/half_edge.hpp>
+#include <core/mesh.hpp>
+#include <core/vector.hpp>
+#include <geometry/delaunay.hpp>
+#include <geometry/mesh_io.hpp>
+#include <geometry/predicates.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+class DelaunayTest : public ::testing::Test
+{
+protected:
+  void SetUp() override {}
+
+  std::vector<geometry::Point2> randomPoints(size_t count, unsigned seed)
+  {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coordinate(-100.0, 100.0);
+    std::vector<geometry::Point2> points(count);
+    for (geometry::Point2 &p : points)
+    {
+      p = {coordinate(rng), coordinate(rng)};
+    }
+    return points;
+  }
+
+  // Check the neighbours are symmetric and no point is strictly inside of a circumcircle.
+  void expectDelaunay(const std::vector<geometry::Point2> &points, const geometry::DelaunayTriangulation &dt)
+  {
+    for (size_t t = 0; t < dt.triangles.size(); t++)
+    {
+      const geometry::Triangle &tri = dt.triangles[t];
+      EXPECT_GT(geometry::orient2d(points[tri.a], points[tri.b], points[tri.c]), 0);
+
+      for (int i = 0; i < 3; i++)
+      {
+        const int n = dt.neighbours[3 * t + i];
+        if (n >= 0)
+        {
+          int back = 0;
+          for (int j = 0; j < 3; j++)
+          {
+            back += dt.neighbours[3 * n + j] == static_cast<int>(t);
+          }
+          EXPECT_EQ(back, 1);
+        }
+      }
+
+      for (const geometry::Point2 &p : points)
+      {
+        EXPECT_LE(geometry::incircle(points[tri.a], points[tri.b], points[tri.c], p), 0);
+      }
+    }
+  }
+};
+
+/**
+ * @brief Test case for the orientation predicate: its sign is exact for points a few ulps away
+ * from a line, compared to integer arithmetic on the same values.
+ *
+ */
+TEST_F(DelaunayTest, orient2d_exact)
+{
+  // Arrange
+  const double ulp = std::ldexp(1.0, -53);
+  const geometry::Point2 b = {12, 12};
+  const geometry::Point2 c = {24, 24};
+  int wrong = 0;
+
+  // Act
+  for (int i = 0; i < 16; i++)
+  {
+    for (int j = 0; j < 16; j++)
+    {
+      const geometry::Point2 a = {0.5 + i * ulp, 0.5 + j * ulp};
+
+      // The coordinates are multiples of 2^-53, so the determinant is exact in 128-bit integers.
+      const __int128 ax = (static_cast<__int128>(1) << 52) + i;
+      const __int128 ay = (static_cast<__int128>(1) << 52) + j;
+      const __int128 bx = static_cast<__int128>(12) << 53;
+      const __int128 cx = static_cast<__int128>(24) << 53;
+      const __int128 exact = (ax - cx) * (bx - cx) - (ay - cx) * (bx - cx);
+      const int sign = (exact > 0) - (exact < 0);
+
+      const double result = geometry::orient2d(a, b, c);
+      wrong += ((result > 0) - (result < 0)) != sign;
+    }
+  }
+
+  // Expect
+  EXPECT_EQ(wrong, 0);
+}
+
+/**
+ * @brief Test case for the incircle predicate: cocircular points are exactly on the circle.
+ *
+ */
+TEST_F(DelaunayTest, incircle_cocircular)
+{
+  // Arrange
+  const geometry::Point2 a = {0.1, 0.1};
+  const geometry::Point2 b = {1.1, 0.1};
+  const geometry::Point2 c = {1.1, 1.1};
+
+  // Act
+  const double on = geometry::incircle(a, b, c, {0.1, 1.1});
+  const double inside = geometry::incircle(a, b, c, {0.6, 0.6});
+  const double outside = geometry::incircle(a, b, c, {2, 2});
+
+  // Expect
+  EXPECT_EQ(on, 0);
+  EXPECT_GT(inside, 0);
+  EXPECT_LT(outside, 0);
+}
+
+/**
+ * @brief Test case for random points: the triangulation is Delaunay and has 2n - 2 - h triangles.
+ *
+ */
+TEST_F(DelaunayTest, random_points)
+{
+  // Arrange
+  std::vector<geometry::Point2> points = randomPoints(500, 7);
+  geometry::DelaunayTriangulation dt;
+
+  // Act
+  geometry::delaunay(points.data(), points.size(), dt);
+
+  // Expect
+  int hull_edges = 0;
+  for (int n : dt.neighbours)
+  {
+    hull_edges += n < 0;
+  }
+  EXPECT_EQ(dt.triangles.size(), 2 * points.size() - 2 - hull_edges);
+  expectDelaunay(points, dt);
+}
+
+/**
+ * @brief Test case for a grid with duplicates: collinear and cocircular points everywhere, the
+ * duplicates are left out.
+ *
+ */
+TEST_F(DelaunayTest, grid_with_duplicates)
+{
+  // Arrange
+  std::vector<geometry::Point2> points;
+  for (int y = 0; y < 20; y++)
+  {
+    for (int x = 0; x < 20; x++)
+    {
+      points.push_back({x * 0.1, y * 0.1});
+    }
+  }
+  for (int i = 0; i < 50; i++)
+  {
+    points.push_back(points[i * 7]);
+  }
+  geometry::DelaunayTriangulation dt;
+
+  // Act
+  geometry::delaunay(points.data(), points.size(), dt);
+
+  // Expect
+  EXPECT_EQ(dt.triangles.size(), 2 * 19 * 19);
+  expectDelaunay(points, dt);
+}
+
+/**
+ * @brief Test case for collinear points: there is no triangle.
+ *
+ */
+TEST_F(DelaunayTest, collinear_points)
+{
+  // Arrange
+  std::vector<geometry::Point2> points = {{0, 0}, {1, 1}, {2, 2}, {3, 3}};
+  geometry::DelaunayTriangulation dt;
+
+  // Act
+  geometry::delaunay(points.data(), points.size(), dt);
+
+  // Expect
+  EXPECT_TRUE(dt.triangles.empty());
+}
+
+/**
+ * @brief Test case for the terrain mesh: read from a point cloud, the heights are kept, the
+ * twins come from the triangulation and it is written back as OBJ.
+ *
+ */
+TEST_F(DelaunayTest, terrain_mesh_io)
+{
+  // Arrange
+  const std::filesystem::path directory = std::filesystem::temp_directory_path();
+  const std::string xyz = (directory / "delaunay_test.xyz").string();
+  const std::string obj = (directory / "delaunay_test.obj").string();
+  std::vector<geometry::Point2> plane = randomPoints(100, 3);
+  {
+    std::ofstream file(xyz);
+    file << "# x y z\n";
+    for (const geometry::Point2 &p : plane)
+    {
+      file << p.x << " " << p.y << " " << std::sin(p.x) + p.y * 0.01 << " 255\n";
+    }
+  }
+
+  // Act
+  Core::Mesh *mesh = geometry::read_xyz_delaunay(xyz, "terrain");
+  bool written = geometry::write_obj(mesh, obj);
+
+  // Expect
+  ASSERT_NE(mesh, nullptr);
+  EXPECT_EQ(mesh->getVertexes().size(), 100);
+  EXPECT_NEAR(mesh->getVertexes()[10]->getZ(), std::sin(plane[10].x) + plane[10].y * 0.01, 1e-4);
+
+  int boundary = 0;
+  for (Core::HalfEdge *he : mesh->getMesh())
+  {
+    if (he->getTwin() == nullptr)
+    {
+      boundary++;
+      continue;
+    }
+    EXPECT_EQ(he->getTwin()->getTwin(), he);
+    EXPECT_EQ(he->getTwin()->getOrigin(), he->getNext()->getOrigin());
+  }
+  EXPECT_EQ(mesh->getFaces().size(), 2 * 100 - 2 - boundary);
+
+  EXPECT_TRUE(written);
+  std::ifstream file(obj);
+  std::string line;
+  int vertexes = 0, faces = 0;
+  while (std::getline(file, line))
+  {
+    vertexes += line.rfind("v ", 0) == 0;
+    faces += line.rfind("f ", 0) == 0;
+  }
+  EXPECT_EQ(vertexes, 100);
+  EXPECT_EQ(faces, static_cast<int>(mesh->getFaces().size()));
+
+  std::remove(xyz.c_str());
+  std::remove(obj.c_str());
+}
+
+/**
+ * @brief Test case for the parallel triangulation: the blocks and the seams between them give the
+ * same triangles as a single block (random points have a unique triangulation).
+ *
+ */
+TEST_F(DelaunayTest, parallel_matches_sequential)
+{
+  // Arrange
+  std::vector<geometry::Point2> points = randomPoints(5000, 11);
+  geometry::DelaunayTriangulation sequential;
+  geometry::DelaunayTriangulation parallel;
+
+  // Act
+  geometry::delaunay(points.data(), points.size(), sequential);
+  geometry::delaunay_parallel(points.data(), points.size(), parallel, 4);
+
+  // Expect
+  auto canonical = [](const geometry::DelaunayTriangulation &dt)
+  {
+    std::vector<std::array<int, 3>> triangles;
+    for (geometry::Triangle t : dt.triangles)
+    {
+      while (t.a > t.b || t.a > t.c)
+      {
+        t = {t.b, t.c, t.a};
+      }
+      triangles.push_back({t.a, t.b, t.c});
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+  };
+  EXPECT_EQ(canonical(parallel), canonical(sequential));
+
+  for (size_t t = 0; t < parallel.triangles.size(); t++)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      const int n = parallel.neighbours[3 * t + i];
+      if (n >= 0)
+      {
+        EXPECT_NE(std::find(parallel.neighbours.begin() + 3 * n, parallel.neighbours.begin() + 3 * n + 3, static_cast<int>(t)),
+                  parallel.neighbours.begin() + 3 * n + 3);
+      }
+    }
+  }
+  EXPECT_EQ(std::count(parallel.neighbours.begin(), parallel.neighbours.end(), -1),
+            std::count(sequential.neighbours.begin(), sequential.neighbours.end(), -1));
+}
+
+/**
+ * @brief Test case for the parallel triangulation of a grid: the borders of the blocks fall on
+ * columns of points and every square has cocircular corners.
+ *
+ */
+TEST_F(DelaunayTest, parallel_grid)
+{
+  // Arrange
+  std::vector<geometry::Point2> points;
+  for (int y = 0; y < 30; y++)
+  {
+    for (int x = 0; x < 30; x++)
+    {
+      points.push_back({x * 0.5, y * 0.5});
+    }
+  }
+  geometry::DelaunayTriangulation dt;
+
+  // Act
+  geometry::delaunay_parallel(points.data(), points.size(), dt, 3);
+
+  // Expect
+  EXPECT_EQ(dt.triangles.size(), 2 * 29 * 29);
+  expectDelaunay(points, dt);
+}
+
+/**
+ * @brief Test case for points on a few scan lines: the triangulation is Delaunay, in one block and
+ * in several, and a large scan keeps its 2n - 2 - h triangles (it took seconds with the points
+ * inserted along a single Hilbert curve).
+ *
+ */
+TEST_F(DelaunayTest, scan_lines)
+{
+  // Arrange
+  auto scanLines = [](int lines, size_t per_line)
+  {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coordinate(0.0, 100.0);
+    std::vector<geometry::Point2> points;
+    for (int line = 0; line < lines; line++)
+    {
+      for (size_t i = 0; i < per_line; i++)
+      {
+        points.push_back({coordinate(rng), line * 10.0});
+      }
+    }
+    return points;
+  };
+  std::vector<geometry::Point2> points = scanLines(3, 1000);
+  std::vector<geometry::Point2> large = scanLines(10, 10000);
+  geometry::DelaunayTriangulation dt;
+  geometry::DelaunayTriangulation parallel;
+  geometry::DelaunayTriangulation large_dt;
+
+  // Act
+  geometry::delaunay(points.data(), points.size(), dt);
+  geometry::delaunay_parallel(points.data(), points.size(), parallel, 4);
+  geometry::delaunay_parallel(large.data(), large.size(), large_dt, 4);
+
+  // Expect
+  expectDelaunay(points, dt);
+  expectDelaunay(points, parallel);
+  EXPECT_EQ(parallel.triangles.size(), dt.triangles.size());
+  int hull_edges = 0;
+  for (int n : large_dt.neighbours)
+  {
+    hull_edges += n < 0;
+  }
+  EXPECT_EQ(large_dt.triangles.size(), 2 * large.size() - 2 - hull_edges);
+}
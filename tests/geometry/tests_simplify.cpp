@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <core/face.hpp>
+#include <core/half_edge.hpp>
+#include <core/mesh.hpp>
+#include <core/vector.hpp>
+#include <geometry/simplify.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+class SimplifyTest : public ::testing::Test
+{
+protected:
+  void SetUp() override {}
+
+  // A square grid of n x n quads on the plane z = 0, from (0, 0) to (n, n)
+  Core::Mesh *makeGrid(int n)
+  {
+    std::vector<Core::Vector *> vertexes;
+    for (int y = 0; y <= n; y++)
+    {
+      for (int x = 0; x <= n; x++)
+      {
+        vertexes.push_back(new Core::Vector(x, y, 0.0, 1.0, nullptr, "v" + std::to_string(vertexes.size())));
+      }
+    }
+    std::vector<std::vector<int>> faces;
+    for (int y = 0; y < n; y++)
+    {
+      for (int x = 0; x < n; x++)
+      {
+        const int v = y * (n + 1) + x;
+        faces.push_back({v, v + 1, v + n + 2, v + n + 1});
+      }
+    }
+    return new Core::Mesh(vertexes, faces, "grid");
+  }
+};
+
+/**
+ * @brief Test case for vertex clustering: the vertexes of each cell are merged into one, and the
+ * faces that collapse are dropped while the others keep their loop and orientation.
+ *
+ */
+TEST_F(SimplifyTest, simplify_mesh)
+{
+  // Arrange
+  Core::Mesh *grid = makeGrid(8);
+
+  // Act
+  Core::Mesh *simplified = geometry::simplify_mesh(grid, 2.0, "simplified");
+
+  // Expect
+  // The cells of side 2 hold the vertexes 0-1, 2-3, ..., 8 on each axis: 5 x 5 clusters.
+  ASSERT_EQ(simplified->getVertexes().size(), 25u);
+  EXPECT_EQ(simplified->getId(), "simplified");
+  EXPECT_EQ(grid->getVertexes().size(), 81u);
+  // Only the quads between two cells on both axes are left, one per pair of cells.
+  ASSERT_EQ(simplified->getFaces().size(), 16u);
+  for (Core::Face *face : simplified->getFaces())
+  {
+    std::vector<Core::Vertex::Vertex> loop;
+    Core::HalfEdge *he = face->getHalfEdge();
+    do
+    {
+      loop.push_back(he->getOrigin()->getVertex());
+      he = he->getNext();
+    } while (he != face->getHalfEdge());
+
+    ASSERT_EQ(loop.size(), 4u);
+    double area = 0;
+    for (size_t i = 0; i < loop.size(); i++)
+    {
+      const Core::Vertex::Vertex &a = loop[i];
+      const Core::Vertex::Vertex &b = loop[(i + 1) % loop.size()];
+      area += a.x * b.y - b.x * a.y;
+    }
+    EXPECT_GT(area, 0);
+  }
+}
+
+/**
+ * @brief Test case for the levels of detail: each level has fewer vertexes than the one before, a
+ * larger error, and no vertex farther from the mesh than its error.
+ *
+ */
+TEST_F(SimplifyTest, build_lods)
+{
+  // Arrange
+  Core::Mesh *grid = makeGrid(128);
+
+  // Act
+  const std::vector<Core::MeshLod> lods = geometry::build_lods(grid, 4);
+
+  // Expect
+  ASSERT_EQ(lods.size(), 4u);
+  size_t previous = grid->getVertexes().size();
+  double previous_error = 0;
+  for (const Core::MeshLod &lod : lods)
+  {
+    EXPECT_LE(lod.mesh->getVertexes().size(), geometry::LOD_MIN_REDUCTION * previous);
+    EXPECT_GT(lod.error, previous_error);
+    EXPECT_FALSE(lod.mesh->getFaces().empty());
+    for (Core::Vector *v : lod.mesh->getVertexes())
+    {
+      const Core::Vertex::Vertex p = v->getVertex();
+      EXPECT_LE(std::max(0.0, -p.x), lod.error);
+      EXPECT_LE(std::max(0.0, p.x - 128), lod.error);
+      EXPECT_DOUBLE_EQ(p.z, 0.0);
+    }
+    previous = lod.mesh->getVertexes().size();
+    previous_error = lod.error;
+  }
+}
+
+/**
+ * @brief Test case for the levels skipped: on a small grid the finest cells hold one vertex each,
+ * those levels are left out and the levels kept are numbered in order.
+ *
+ */
+TEST_F(SimplifyTest, build_lods_skips_levels)
+{
+  // Arrange
+  Core::Mesh *grid = makeGrid(8);
+
+  // Act
+  const std::vector<Core::MeshLod> lods = geometry::build_lods(grid, 7);
+
+  // Expect
+  // Cells of side 1/8 up to 1 keep the 81 vertexes, cells of side 2, 4 and 8 merge them.
+  ASSERT_EQ(lods.size(), 3u);
+  const size_t vertexes[] = {25, 9, 4};
+  for (size_t i = 0; i < lods.size(); i++)
+  {
+    EXPECT_EQ(lods[i].mesh->getId(), "grid_lod" + std::to_string(i + 1));
+    EXPECT_EQ(lods[i].mesh->getVertexes().size(), vertexes[i]);
+    EXPECT_DOUBLE_EQ(lods[i].error, 2.0 * (1 << i) * std::sqrt(3.0));
+  }
+}
+
+/**
+ * @brief Test case for a mesh of a single point simplified with cells of no size: its vertex is
+ * kept where it is.
+ *
+ */
+TEST_F(SimplifyTest, single_point)
+{
+  // Arrange
+  Core::Mesh *point = new Core::Mesh({new Core::Vector(3.0, -2.0, 5.0, 1.0, nullptr, "v0")}, {}, "point");
+
+  // Act
+  Core::Mesh *simplified = geometry::simplify_mesh(point, 0.0, "simplified");
+
+  // Expect
+  ASSERT_EQ(simplified->getVertexes().size(), 1u);
+  const Core::Vertex::Vertex p = simplified->getVertexes()[0]->getVertex();
+  EXPECT_DOUBLE_EQ(p.x, 3.0);
+  EXPECT_DOUBLE_EQ(p.y, -2.0);
+  EXPECT_DOUBLE_EQ(p.z, 5.0);
+  EXPECT_TRUE(simplified->getFaces().empty());
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <core/mesh.hpp>
+#include <core/vector.hpp>
+#include <geometry/triangulation.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+class TriangulationTest : public ::testing::Test
+{
+protected:
+  // A concave L with 6 vertices, counterclockwise, its area is 3.
+  std::vector<geometry::Point2> l_shape = {{0, 0}, {2, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 2}};
+
+  void SetUp() override {}
+
+  /**
+   * @brief A rectangle with teeth going down along its bottom and up along its top, so the sweep
+   * meets split, merge and horizontal edges. Counterclockwise, 6 * teeth + 1 vertices and an area
+   * of 13 * teeth - 2.5 (its top right corner is cut).
+   *
+   */
+  std::vector<geometry::Point2> makeComb(int teeth)
+  {
+    std::vector<geometry::Point2> comb;
+    for (int i = 0; i < teeth; i++)
+    {
+      comb.push_back({2.0 * i, 0});
+      comb.push_back({2.0 * i + 0.5, -3});
+      comb.push_back({2.0 * i + 1, 0});
+    }
+    comb.push_back({2.0 * teeth, 0});
+    for (int i = teeth - 1; i >= 0; i--)
+    {
+      comb.push_back({2.0 * i + 1, 5});
+      comb.push_back({2.0 * i + 0.5, 8});
+      comb.push_back({2.0 * i, 5});
+    }
+    return comb;
+  }
+
+  // The sum of the signed areas of the triangles, positive for counterclockwise ones.
+  double area(const std::vector<geometry::Point2> &points, const std::vector<geometry::Triangle> &triangles, double sign)
+  {
+    double sum = 0.0;
+    for (const geometry::Triangle &t : triangles)
+    {
+      double a = geometry::orient(points[t.a], points[t.b], points[t.c]) / 2.0;
+      EXPECT_GE(sign * a, 0.0);
+      sum += a;
+    }
+    return sum;
+  }
+
+  Core::Mesh *makeBox(std::string name)
+  {
+    std::vector<Core::Vector *> vertexes;
+    for (int corner = 0; corner < 8; corner++)
+    {
+      double x = (corner == 1 || corner == 2 || corner == 5 || corner == 6) ? 1 : -1;
+      double y = corner >= 4 ? 1 : -1;
+      double z = (corner == 2 || corner == 3 || corner == 6 || corner == 7) ? 1 : -1;
+      vertexes.push_back(new Core::Vector(x, y, z, 1.0, nullptr, name + std::to_string(corner)));
+    }
+    std::vector<std::vector<int>> faces = {{2, 6, 7, 3}, {1, 0, 4, 5}, {3, 7, 4, 0}, {2, 3, 0, 1}, {6, 2, 1, 5}, {6, 5, 4, 7}};
+    return new Core::Mesh(vertexes, faces, name);
+  }
+};
+
+/**
+ * @brief Test case for the quad fast path: a dart is split along the diagonal of its reflex vertex.
+ *
+ */
+TEST_F(TriangulationTest, concave_quad)
+{
+  // Arrange
+  std::vector<geometry::Point2> dart = {{0, 0}, {2, 1}, {4, 0}, {2, 4}};
+  std::vector<geometry::Triangle> triangles(2);
+
+  // Act
+  geometry::triangulate_polygon(dart.data(), 4, triangles.data());
+
+  // Expect
+  EXPECT_EQ(triangles[0].a, 0);
+  EXPECT_EQ(triangles[0].b, 1);
+  EXPECT_EQ(triangles[0].c, 3);
+  EXPECT_EQ(triangles[1].a, 1);
+  EXPECT_EQ(triangles[1].b, 2);
+  EXPECT_EQ(triangles[1].c, 3);
+  EXPECT_DOUBLE_EQ(area(dart, triangles, 1), 6.0);
+}
+
+/**
+ * @brief Test case for ear clipping: the triangles of a concave polygon cover it exactly, in
+ * the orientation of the polygon.
+ *
+ */
+TEST_F(TriangulationTest, ear_clipping_concave)
+{
+  // Arrange
+  std::vector<geometry::Triangle> triangles(4);
+  std::vector<geometry::Point2> reversed(l_shape.rbegin(), l_shape.rend());
+  std::vector<geometry::Triangle> reversed_triangles(4);
+
+  // Act
+  bool valid = geometry::ear_clipping(l_shape.data(), 6, triangles.data());
+  bool reversed_valid = geometry::ear_clipping(reversed.data(), 6, reversed_triangles.data());
+
+  // Expect
+  EXPECT_TRUE(valid);
+  EXPECT_TRUE(reversed_valid);
+  EXPECT_DOUBLE_EQ(area(l_shape, triangles, 1), 3.0);
+  EXPECT_DOUBLE_EQ(area(reversed, reversed_triangles, -1), -3.0);
+}
+
+/**
+ * @brief Test case for the monotone decomposition: it agrees with ear clipping on the area of a
+ * comb in both orientations, and large polygons go through it.
+ *
+ */
+TEST_F(TriangulationTest, monotone_comb)
+{
+  // Arrange
+  std::vector<geometry::Point2> comb = makeComb(24);
+  std::vector<geometry::Point2> reversed(comb.rbegin(), comb.rend());
+  const int n = static_cast<int>(comb.size());
+  std::vector<geometry::Triangle> monotone(n - 2);
+  std::vector<geometry::Triangle> reversed_monotone(n - 2);
+  std::vector<geometry::Triangle> ears(n - 2);
+  std::vector<geometry::Triangle> polygon(n - 2);
+
+  // Act
+  bool valid = geometry::monotone_triangulation(comb.data(), n, monotone.data());
+  bool reversed_valid = geometry::monotone_triangulation(reversed.data(), n, reversed_monotone.data());
+  geometry::ear_clipping(comb.data(), n, ears.data());
+  geometry::triangulate_polygon(comb.data(), n, polygon.data());
+
+  // Expect
+  EXPECT_GT(n, geometry::EAR_CLIPPING_MAX_VERTICES);
+  EXPECT_TRUE(valid);
+  EXPECT_TRUE(reversed_valid);
+  EXPECT_NEAR(area(comb, monotone, 1), 309.5, 1e-9);
+  EXPECT_NEAR(area(reversed, reversed_monotone, -1), -309.5, 1e-9);
+  EXPECT_NEAR(area(comb, ears, 1), 309.5, 1e-9);
+  EXPECT_NEAR(area(comb, polygon, 1), 309.5, 1e-9);
+}
+
+/**
+ * @brief Test case for the triangulation cache: a mesh is triangulated once, and again only after
+ * its topology changes.
+ *
+ */
+TEST_F(TriangulationTest, mesh_cache)
+{
+  // Arrange
+  Core::Mesh *box = makeBox("box");
+  geometry::TriangulationCache cache;
+
+  // Act
+  const geometry::MeshTriangulation &first = cache.get(box);
+  const uint64_t first_version = first.topology_version;
+  const geometry::Triangle *first_triangles = first.triangles.data();
+  const geometry::MeshTriangulation &again = cache.get(box);
+  const geometry::Triangle *again_triangles = again.triangles.data();
+
+  box->setFaces(box->getFaces());
+  const geometry::MeshTriangulation &changed = cache.get(box);
+
+  // Expect
+  EXPECT_EQ(first.offsets.size(), 7);
+  EXPECT_EQ(first.offsets.back(), 12);
+  EXPECT_EQ(again_triangles, first_triangles);
+  EXPECT_NE(first_version, box->getTopologyVersion());
+  EXPECT_EQ(changed.topology_version, box->getTopologyVersion());
+  EXPECT_EQ(changed.triangles.size(), 12);
+}
@@ -121,3 +121,83 @@ TEST_F(MathVectorTest, cross)
   EXPECT_EQ(actual_vector->getH(), expected_H);
   EXPECT_EQ(actual_vector->getHalfEdge(), expected_halfedge);
 }
+
+/**
+ * @brief Test case for the fast_rsqrt and fast_normalize functions.
+ *
+ */
+TEST_F(MathVectorTest, fast_rsqrt)
+{
+  // Arrange
+  const float values[] = {0.0001f, 0.5f, 1.0f, 2.0f, 3.0f, 100.0f, 12345.0f};
+
+  for (float value : values)
+  {
+    // Act
+    float actual = Math::fast_rsqrt(value);
+
+    // Expect
+    EXPECT_NEAR(actual * std::sqrt(value), 1.0, 0.00001);
+  }
+
+  // Act
+  Core::Vertex::Vertex actual_vector = Math::fast_normalize({3.0, 0.0, 4.0});
+
+  // Expect
+  EXPECT_NEAR(actual_vector.x, 0.6, 0.00001);
+  EXPECT_NEAR(actual_vector.y, 0.0, 0.00001);
+  EXPECT_NEAR(actual_vector.z, 0.8, 0.00001);
+}
+
+/**
+ * @brief Test case for the fast_log2, fast_exp2 and fast_pow functions, over the bases and
+ * shininess exponents of the specular highlights.
+ *
+ */
+TEST_F(MathVectorTest, fast_pow)
+{
+  // Arrange
+  const float bases[] = {0.0f, 1e-6f, 0.01f, 0.3f, 0.7071f, 0.9f, 0.999f, 1.0f};
+  const float exponents[] = {1.0f, 2.15f, 8.0f, 32.5f, 128.0f};
+
+  for (float x : bases)
+  {
+    if (x > 0.0f)
+    {
+      // Act & Expect
+      EXPECT_NEAR(Math::fast_log2(x), std::log2(x), 1e-6);
+    }
+
+    for (float y : exponents)
+    {
+      // Act
+      float actual = Math::fast_pow(x, y);
+
+      // Expect
+      EXPECT_NEAR(actual, std::pow(x, y), 1e-6 + 1e-5 * std::pow(x, y));
+    }
+  }
+  EXPECT_NEAR(Math::fast_exp2(-3.25f), std::exp2(-3.25), 1e-6);
+  EXPECT_NEAR(Math::fast_exp2(10.5f), std::exp2(10.5), 1e-6 * std::exp2(10.5));
+  EXPECT_EQ(Math::fast_exp2(-1000.0f), std::exp2(-126.0f));
+}
+
+/**
+ * @brief Test case for the fixed size matrices: they multiply like the std::vector ones.
+ *
+ */
+TEST_F(MathVectorTest, matrix4)
+{
+  // Arrange
+  std::vector<std::vector<double>> m1 = {{1, 2, 3, 4}, {0, 1, 0, 5}, {2, 0, 1, 0}, {0, 0, -0.5, 1}};
+  std::vector<std::vector<double>> m2 = {{0, 1, 0, 0}, {-1, 0, 0, 2}, {0, 0, 3, 0}, {1, 1, 1, 1}};
+
+  // Act
+  std::vector<std::vector<double>> expected = Math::multiply_matrix(m1, m2);
+  Math::Matrix4 actual = Math::multiply_matrix(Math::to_matrix4(m1), Math::to_matrix4(m2));
+  Math::Matrix4 identity = Math::multiply_matrix(Math::identity_matrix(), Math::to_matrix4(m1));
+
+  // Expect
+  EXPECT_EQ(Math::to_matrix(actual), expected);
+  EXPECT_EQ(Math::to_matrix(identity), m1);
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <math/math.hpp>
+#include <math/matrix.hpp>
+#include <pipeline/pipeline.hpp>
+
+#include <cmath>
+#include <vector>
+
+class MatrixKindsTest : public ::testing::Test
+{
+protected:
+  Math::ScaleTranslateMatrix<double> scale_translate = {{2, -3, 0.5}, {10, 20, -1}};
+  Math::AffineMatrix<double> affine = {{{0.6, -0.8, 0, 4}, {0.8, 0.6, 0, -2}, {0, 0, 1, 7}}};
+  Math::PerspectiveMatrix<double> perspective = {1, 0, -0.025, 0};
+  Math::Matrix4 dense = {{{1, 2, 3, 4}, {0, 1, 0, 5}, {2, 0, 1, 0}, {0, 0, -0.5, 1}}};
+
+  Math::Point4<double> point = {1.5, -2, 3, 1};
+
+  void expectMatrix(const Math::Matrix4 &actual, const Math::Matrix4 &expected)
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        EXPECT_NEAR(actual[i][j], expected[i][j], 1e-12);
+      }
+    }
+  }
+
+  void expectPoint(const Math::Point4<double> &actual, const Math::Point4<double> &expected)
+  {
+    EXPECT_NEAR(actual.x, expected.x, 1e-12);
+    EXPECT_NEAR(actual.y, expected.y, 1e-12);
+    EXPECT_NEAR(actual.z, expected.z, 1e-12);
+    EXPECT_NEAR(actual.h, expected.h, 1e-12);
+  }
+};
+
+/**
+ * @brief Test case for the specialized products: each one is the same as the dense product.
+ *
+ */
+TEST_F(MatrixKindsTest, products)
+{
+  // Arrange
+  Math::Matrix4 st = Math::to_dense(scale_translate);
+  Math::Matrix4 a = Math::to_dense(affine);
+  Math::Matrix4 p = Math::to_dense(perspective);
+
+  // Act
+  Math::ScaleTranslateMatrix<double> st_st = Math::multiply(scale_translate, scale_translate);
+  Math::AffineMatrix<double> st_a = Math::multiply(scale_translate, affine);
+  Math::AffineMatrix<double> a_st = Math::multiply(affine, scale_translate);
+  Math::AffineMatrix<double> a_a = Math::multiply(affine, affine);
+  Math::Matrix4 p_a = Math::multiply(perspective, affine);
+  Math::Matrix4 st_d = Math::multiply(scale_translate, dense);
+  Math::Matrix4 p_st = Math::multiply(perspective, scale_translate);
+  Math::Matrix4 d_st = Math::multiply(dense, scale_translate);
+
+  // Expect
+  expectMatrix(Math::to_dense(st_st), Math::multiply_matrix(st, st));
+  expectMatrix(Math::to_dense(st_a), Math::multiply_matrix(st, a));
+  expectMatrix(Math::to_dense(a_st), Math::multiply_matrix(a, st));
+  expectMatrix(Math::to_dense(a_a), Math::multiply_matrix(a, a));
+  expectMatrix(p_a, Math::multiply_matrix(p, a));
+  expectMatrix(st_d, Math::multiply_matrix(st, dense));
+  expectMatrix(p_st, Math::multiply_matrix(p, st));
+  expectMatrix(d_st, Math::multiply_matrix(dense, st));
+}
+
+/**
+ * @brief Test case for the application of each kind to a point.
+ *
+ */
+TEST_F(MatrixKindsTest, apply)
+{
+  // Act & Expect
+  expectPoint(Math::apply(scale_translate, point), Math::apply(Math::to_dense(scale_translate), point));
+  expectPoint(Math::apply(affine, point), Math::apply(Math::to_dense(affine), point));
+  expectPoint(Math::apply(perspective, point), Math::apply(Math::to_dense(perspective), point));
+
+  expectPoint(Math::apply_point(scale_translate, point.x, point.y, point.z), Math::apply(scale_translate, point));
+  expectPoint(Math::apply_point(affine, point.x, point.y, point.z), Math::apply(affine, point));
+  expectPoint(Math::apply_point(perspective, point.x, point.y, point.z), Math::apply(perspective, point));
+  expectPoint(Math::apply_point(dense, point.x, point.y, point.z), Math::apply(dense, point));
+}
+
+/**
+ * @brief Test case for the composition of the santa_catarina stages, which can also be done at
+ * compile time.
+ *
+ */
+TEST_F(MatrixKindsTest, compose_pipeline)
+{
+  // Arrange
+  Core::Vertex::Vertex vrp = {25, 15, 80};
+  Core::Vertex::Vertex p = {20, 10, 25};
+  std::vector<std::vector<double>> sru2src = pipeline::santa_catarina::sru2src(vrp, p);
+  std::vector<std::vector<double>> projection = pipeline::santa_catarina::projection(vrp, p, 40);
+  std::vector<std::vector<double>> src2srt = pipeline::santa_catarina::src2srt({0, 16, 0, 12}, {0, 319, 0, 239}, true);
+
+  // Act
+  Math::Matrix4 composed = Math::compose(Math::to_scale_translate(Math::to_matrix4(src2srt)),
+                                         Math::to_perspective(Math::to_matrix4(projection)),
+                                         Math::to_affine(Math::to_matrix4(sru2src)));
+  constexpr Math::AffineMatrix<float> constant = Math::compose(Math::ScaleTranslateMatrix<float>{{2, 2, 2}, {1, 0, 0}},
+                                                               Math::AffineMatrix<float>{{{0, -1, 0, 0}, {1, 0, 0, 0}, {0, 0, 1, 3}}});
+
+  // Expect
+  expectMatrix(composed, Math::to_matrix4(Math::multiply_matrix(src2srt, Math::multiply_matrix(projection, sru2src))));
+  static_assert(constant.m[0][1] == -2 && constant.m[0][3] == 1 && constant.m[2][3] == 6);
+}
+
+/**
+ * @brief Test case for the single precision projection: the screen coordinates of the float batch
+ * stay within half a subpixel of the double ones, near the origin of the SRU and far from it. The
+ * float points are given relative to the VRP, which is folded into the matrix in double.
+ *
+ */
+TEST_F(MatrixKindsTest, float_projection_error)
+{
+  for (const Core::Vertex::Vertex origin : {Core::Vertex::Vertex{0, 0, 0}, Core::Vertex::Vertex{1e5, -2e5, 5e4}})
+  {
+    // Arrange
+    // The camera of the pipeline tests, with a 1920x1080 viewport, moved by origin.
+    Core::Vertex::Vertex vrp = {25 + origin.x, 15 + origin.y, 80 + origin.z};
+    Core::Vertex::Vertex p = {20 + origin.x, 10 + origin.y, 25 + origin.z};
+    Math::Matrix4 view = Math::multiply(Math::to_matrix4(pipeline::santa_catarina::projection(vrp, p, 40)),
+                                        Math::to_matrix4(pipeline::santa_catarina::sru2src(vrp, p)));
+    Math::Matrix4 eye_view = Math::multiply(view, Math::ScaleTranslateMatrix<double>{{1, 1, 1}, {vrp.x, vrp.y, vrp.z}});
+    Math::ScaleTranslateMatrix<double> screen = Math::to_scale_translate(
+        Math::to_matrix4(pipeline::santa_catarina::src2srt({0, 16, 0, 12}, {0, 1919, 0, 1079}, true)));
+
+    // Points from 1 to 150 units in front of the camera, spread over the window, built from the
+    // u, v and n axes of the camera (the rows of sru2src).
+    std::vector<std::vector<double>> sru2src = pipeline::santa_catarina::sru2src(vrp, p);
+    std::vector<double> x, y, z;
+    std::vector<float> fx, fy, fz;
+    for (int i = 0; i < 1000; i++)
+    {
+      double distance = 1 + 149 * (i + 1) / 1000.0;
+      double u = (8 + 7.9 * std::sin(i * 0.37)) * distance / 40;
+      double v = (6 + 5.9 * std::cos(i * 0.61)) * distance / 40;
+
+      double relative[3];
+      for (int k = 0; k < 3; k++)
+      {
+        relative[k] = u * sru2src[0][k] + v * sru2src[1][k] - distance * sru2src[2][k];
+      }
+      x.push_back(vrp.x + relative[0]);
+      y.push_back(vrp.y + relative[1]);
+      z.push_back(vrp.z + relative[2]);
+      fx.push_back(static_cast<float>(x.back() - vrp.x));
+      fy.push_back(static_cast<float>(y.back() - vrp.y));
+      fz.push_back(static_cast<float>(z.back() - vrp.z));
+    }
+    size_t n = x.size();
+
+    std::vector<double> cx(n), cy(n), cz(n), ch(n), sx(n), sy(n), inv_h(n);
+    std::vector<float> fcx(n), fcy(n), fcz(n), fch(n), fsx(n), fsy(n), finv_h(n);
+
+    // Act
+    Math::apply_points(view, x.data(), y.data(), z.data(), n, cx.data(), cy.data(), cz.data(), ch.data());
+    Math::divide_points(screen, cx.data(), cy.data(), ch.data(), n, sx.data(), sy.data(), inv_h.data());
+
+    Math::apply_points(Math::matrix_cast<float>(eye_view), fx.data(), fy.data(), fz.data(), n, fcx.data(), fcy.data(), fcz.data(), fch.data());
+    Math::divide_points(Math::matrix_cast<float>(screen), fcx.data(), fcy.data(), fch.data(), n, fsx.data(), fsy.data(), finv_h.data());
+
+    // Expect
+    for (size_t i = 0; i < n; i++)
+    {
+      Math::Point4<double> expected = Math::apply_point(view, x[i], y[i], z[i]);
+      EXPECT_NEAR(ch[i], expected.h, 1e-9);
+
+      // A 28.4 subpixel is 1/16 of a pixel, the float error must stay below half of it.
+      EXPECT_NEAR(fsx[i], sx[i], 1.0 / 32);
+      EXPECT_NEAR(fsy[i], sy[i], 1.0 / 32);
+      EXPECT_NEAR(finv_h[i], inv_h[i], 1e-5 * inv_h[i]);
+    }
+  }
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <parallel/scheduler.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+class SchedulerTest : public ::testing::Test
+{
+protected:
+  // More threads than the machine may have, the tasks are stolen all the same.
+  parallel::Scheduler scheduler = parallel::Scheduler(4);
+
+  void SetUp() override {}
+
+  // Fork both halves of the recursion, like a divide and conquer algorithm
+  long fibonacci(int n)
+  {
+    if (n < 12)
+    {
+      return n < 2 ? n : fibonacci(n - 1) + fibonacci(n - 2);
+    }
+    long a = 0;
+    parallel::TaskGroup group(&scheduler);
+    group.run([&]
+              { a = fibonacci(n - 1); });
+    const long b = fibonacci(n - 2);
+    group.wait();
+    return a + b;
+  }
+};
+
+/**
+ * @brief Test case for parallel_for: every index is visited once, in ranges of at most the grain.
+ *
+ */
+TEST_F(SchedulerTest, parallel_for_covers_range)
+{
+  // Arrange
+  std::vector<std::atomic<int>> visits(100003);
+  std::atomic<size_t> largest = 0;
+
+  // Act
+  parallel::parallel_for(0, visits.size(), 1000, [&](size_t begin, size_t end)
+                         {
+                           size_t size = end - begin;
+                           size_t seen = largest.load();
+                           while (size > seen && !largest.compare_exchange_weak(seen, size))
+                           {
+                           }
+                           for (size_t i = begin; i < end; i++)
+                           {
+                             visits[i]++;
+                           } },
+                         "visit", scheduler);
+
+  // Expect
+  for (size_t i = 0; i < visits.size(); i++)
+  {
+    ASSERT_EQ(visits[i], 1) << i;
+  }
+  EXPECT_LE(largest, 1000u);
+}
+
+/**
+ * @brief Test case for for_each_chunk: the chunks tile the range in order of their index.
+ *
+ */
+TEST_F(SchedulerTest, chunks_tile_range)
+{
+  // Arrange
+  const int chunks = 7;
+  std::vector<size_t> begins(chunks), ends(chunks);
+
+  // Act
+  parallel::for_each_chunk(1000, chunks, [&](int chunk, size_t begin, size_t end)
+                           {
+                             begins[chunk] = begin;
+                             ends[chunk] = end; },
+                           "tile", scheduler);
+
+  // Expect
+  EXPECT_EQ(begins[0], 0u);
+  EXPECT_EQ(ends[chunks - 1], 1000u);
+  for (int c = 1; c < chunks; c++)
+  {
+    EXPECT_EQ(begins[c], ends[c - 1]);
+  }
+}
+
+/**
+ * @brief Test case for nested fork/join: the tasks waiting for their children run other tasks
+ * instead of blocking the workers.
+ *
+ */
+TEST_F(SchedulerTest, nested_fork_join)
+{
+  // Act
+  const long result = fibonacci(24);
+
+  // Expect
+  EXPECT_EQ(result, 46368);
+}
+
+/**
+ * @brief Test case for the profiling hook: it is told about every task, with its name, a valid
+ * thread and its times.
+ *
+ */
+TEST_F(SchedulerTest, profile_hook)
+{
+  // Arrange
+  std::mutex mutex;
+  std::vector<parallel::TaskProfile> profiles;
+  scheduler.setProfileHook([&](const parallel::TaskProfile &profile)
+                           {
+                             std::lock_guard<std::mutex> lock(mutex);
+                             profiles.push_back(profile); });
+
+  // Act
+  parallel::for_each_chunk(64, 8, [](int, size_t, size_t) {}, "profiled", scheduler);
+  scheduler.setProfileHook(nullptr);
+  parallel::for_each_chunk(64, 8, [](int, size_t, size_t) {}, "not_profiled", scheduler);
+
+  // Expect
+  ASSERT_EQ(profiles.size(), 7u);
+  for (const parallel::TaskProfile &profile : profiles)
+  {
+    EXPECT_STREQ(profile.name, "profiled");
+    EXPECT_GE(profile.worker, -1);
+    EXPECT_LT(profile.worker, scheduler.getThreads() - 1);
+    EXPECT_LE(profile.start, profile.end);
+  }
+}
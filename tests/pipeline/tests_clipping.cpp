@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include <pipeline/clipping.hpp>
+#include <vector>
+
+class ClippingTest : public ::testing::Test
+{
+protected:
+  // The window (x_min, x_max, y_min, y_max) and the near plane h >= 0.5.
+  pipeline::ClipVolume volume = pipeline::clip_volume({-1, 1, -1, 1}, 0.5);
+
+  pipeline::ClipPolygon polygon;
+
+  void SetUp() override
+  {
+    polygon.current = 0;
+    polygon.count = 0;
+  }
+
+  // Add a vertex with h = 1 (so x and y are already in the window), carrying x as attribute.
+  void addVertex(double x, double y, double h = 1.0)
+  {
+    pipeline::ClipVertex &v = polygon.buffers[0][polygon.count++];
+    v = {x * h, y * h, 0, h, {}};
+    v.attributes[0] = static_cast<float>(x);
+  }
+
+  const pipeline::ClipVertex *vertices()
+  {
+    return polygon.buffers[polygon.current];
+  }
+};
+
+/**
+ * @brief Test case for the outcodes of the vertices.
+ *
+ */
+TEST_F(ClippingTest, outcode)
+{
+  // Arrange
+  pipeline::ClipVertex inside = {0.5, 0.5, 0, 1, {}};
+  pipeline::ClipVertex left_top = {-2, 3, 0, 1, {}};
+  pipeline::ClipVertex behind = {0, 0, 0, -1, {}};
+
+  // Act & Expect
+  EXPECT_EQ(pipeline::outcode(inside, volume), 0u);
+  EXPECT_EQ(pipeline::outcode(left_top, volume) & pipeline::CLIP_ALL, pipeline::CLIP_LEFT | pipeline::CLIP_TOP);
+  EXPECT_TRUE(pipeline::outcode(behind, volume) & pipeline::CLIP_NEAR);
+}
+
+/**
+ * @brief Test case for the guard band: vertices slightly outside of the window are inside of it.
+ *
+ */
+TEST_F(ClippingTest, guard_band)
+{
+  // Arrange
+  // A 100x100 pixels viewport, so the guard band extends 4096 / 50 window units on each side.
+  pipeline::ClipVolume guarded = pipeline::clip_volume({-1, 1, -1, 1}, {0, 100, 0, 100}, 0.5);
+  pipeline::ClipVertex slightly_out = {1.5, -3, 0, 1, {}};
+  pipeline::ClipVertex far_out = {90, 0, 0, 1, {}};
+
+  // Act
+  uint32_t slightly_out_code = pipeline::outcode(slightly_out, guarded);
+  uint32_t far_out_code = pipeline::outcode(far_out, guarded);
+
+  // Expect
+  EXPECT_NEAR(guarded.guard_x_max, 1 + 4096.0 / 50.0, 1e-9);
+  EXPECT_EQ(slightly_out_code, pipeline::CLIP_RIGHT | pipeline::CLIP_BOTTOM);
+  EXPECT_EQ(slightly_out_code & pipeline::GUARD_ALL, 0u);
+  EXPECT_EQ(far_out_code & pipeline::GUARD_ALL, pipeline::GUARD_RIGHT);
+}
+
+/**
+ * @brief Test case for the clipping against the guard band planes.
+ *
+ */
+TEST_F(ClippingTest, guard_band_polygon)
+{
+  // Arrange
+  pipeline::ClipVolume guarded = pipeline::clip_volume({-1, 1, -1, 1}, {0, 100, 0, 100}, 0.5);
+  addVertex(0, -0.5);
+  addVertex(200, 0);
+  addVertex(0, 0.5);
+
+  // Act
+  pipeline::clip_polygon(polygon, guarded, pipeline::GUARD_ALL, 1);
+
+  // Expect
+  ASSERT_EQ(polygon.count, 4);
+  for (int i = 0; i < polygon.count; i++)
+  {
+    const pipeline::ClipVertex &v = vertices()[i];
+    EXPECT_LE(v.x / v.h, guarded.guard_x_max + 1e-9);
+    EXPECT_GT(v.x / v.h, -1e-9);
+  }
+}
+
+/**
+ * @brief Test case for a polygon inside of the window, it must not change.
+ *
+ */
+TEST_F(ClippingTest, inside_polygon)
+{
+  // Arrange
+  addVertex(-0.5, -0.5);
+  addVertex(0.5, -0.5);
+  addVertex(0, 0.5);
+
+  // Act
+  pipeline::clip_polygon(polygon, volume, pipeline::CLIP_ALL, 1);
+
+  // Expect
+  ASSERT_EQ(polygon.count, 3);
+  EXPECT_EQ(vertices()[0].x, -0.5);
+  EXPECT_EQ(vertices()[1].x, 0.5);
+  EXPECT_EQ(vertices()[2].y, 0.5);
+}
+
+/**
+ * @brief Test case for a triangle crossing the right edge of the window: it becomes a quad.
+ *
+ */
+TEST_F(ClippingTest, window_edge)
+{
+  // Arrange
+  addVertex(0, -0.5);
+  addVertex(2, 0);
+  addVertex(0, 0.5);
+
+  // Act
+  pipeline::clip_polygon(polygon, volume, pipeline::CLIP_RIGHT, 1);
+
+  // Expect
+  ASSERT_EQ(polygon.count, 4);
+  for (int i = 0; i < polygon.count; i++)
+  {
+    const pipeline::ClipVertex &v = vertices()[i];
+    EXPECT_LE(v.x / v.h, 1.0 + 1e-9);
+    // The attribute is interpolated along with the position.
+    EXPECT_NEAR(v.attributes[0], v.x / v.h, 1e-6);
+  }
+}
+
+/**
+ * @brief Test case for a polygon crossing the near plane, with a vertex behind the observer.
+ *
+ */
+TEST_F(ClippingTest, near_plane)
+{
+  // Arrange
+  addVertex(0, 0, 1);
+  addVertex(0.5, 0, 1);
+  polygon.buffers[0][polygon.count++] = {0, 0.5, 0, -1, {}};
+
+  // Act
+  pipeline::clip_polygon(polygon, volume, pipeline::CLIP_ALL, 1);
+
+  // Expect
+  ASSERT_EQ(polygon.count, 4);
+  for (int i = 0; i < polygon.count; i++)
+  {
+    EXPECT_GE(vertices()[i].h, 0.5 - 1e-9);
+    EXPECT_EQ(pipeline::outcode(vertices()[i], volume) & ~pipeline::CLIP_NEAR, 0u);
+  }
+}
+
+/**
+ * @brief Test case for a polygon covering the whole window: the window corners are produced.
+ *
+ */
+TEST_F(ClippingTest, covering_polygon)
+{
+  // Arrange
+  addVertex(-10, -10);
+  addVertex(10, -10);
+  addVertex(10, 10);
+  addVertex(-10, 10);
+
+  // Act
+  pipeline::clip_polygon(polygon, volume, pipeline::CLIP_ALL, 1);
+
+  // Expect
+  ASSERT_EQ(polygon.count, 4);
+  for (int i = 0; i < polygon.count; i++)
+  {
+    EXPECT_NEAR(std::abs(vertices()[i].x), 1.0, 1e-9);
+    EXPECT_NEAR(std::abs(vertices()[i].y), 1.0, 1e-9);
+  }
+}
+
+/**
+ * @brief Test case for the clipping of segments.
+ *
+ */
+TEST_F(ClippingTest, segment)
+{
+  // Arrange
+  pipeline::ClipVertex a = {-3, 0, 0, 1, {}};
+  pipeline::ClipVertex b = {3, 0, 0, 1, {}};
+  pipeline::ClipVertex c = {-3, 2, 0, 1, {}};
+  pipeline::ClipVertex d = {3, 2, 0, 1, {}};
+
+  // Act
+  bool visible = pipeline::clip_segment(a, b, volume, 0);
+  bool hidden = pipeline::clip_segment(c, d, volume, 0);
+
+  // Expect
+  EXPECT_TRUE(visible);
+  EXPECT_FALSE(hidden);
+  EXPECT_NEAR(a.x, -1.0, 1e-9);
+  EXPECT_NEAR(b.x, 1.0, 1e-9);
+}
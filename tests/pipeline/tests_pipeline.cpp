@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
+#include <cmath>
 #include <iostream>
+#include <core/camera.hpp>
 #include <pipeline/pipeline.hpp>
 #include <vector>
 
@@ -54,6 +56,34 @@ TEST_F(PipelineTest, sru2src)
   }
 }
 
+/**
+ * @brief Test case for the function view_basis: looking straight down along the up vector, the
+ * basis is still orthonormal, and an up vector out of the view direction is followed.
+ *
+ */
+TEST_F(PipelineTest, view_basis_degenerate)
+{
+  // Act
+  pipeline::ViewBasis down = pipeline::view_basis({0, 50, 0}, {0, 0, 0}, {0, 1, 0});
+  pipeline::ViewBasis north = pipeline::view_basis({0, 50, 0}, {0, 0, 0}, {0, 0, -2});
+
+  // Expect
+  for (const pipeline::ViewBasis &basis : {down, north})
+  {
+    const Core::Vertex::Vertex axes[3] = {basis.u, basis.v, basis.n};
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        EXPECT_NEAR(Math::dot(axes[i], axes[j]), i == j, 1e-12);
+      }
+    }
+    EXPECT_NEAR(basis.n.y, 1, 1e-12);
+  }
+  EXPECT_NEAR(north.v.z, -1, 1e-12);
+  EXPECT_NEAR(north.u.x, 1, 1e-12);
+}
+
 /**
  * @brief Test case for the function projection.
  *
@@ -129,4 +159,145 @@ TEST_F(PipelineTest, src2srt_without_reflection)
       EXPECT_NEAR(result[i][j], expected[i][j], 0.0001);
     }
   }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Test case for the normalization of the madeiras_pereira pipeline: the window corners
+ * end up on the sides of the canonical volume and the back plane at z = -1.
+ *
+ */
+TEST_F(PipelineTest, madeiras_pereira_canonical_volume)
+{
+  // Arrange
+  Math::Matrix4 normalization = pipeline::madeiras_pereira::normalization(window, dp, 200);
+  Math::Matrix4 per = pipeline::madeiras_pereira::perspective_to_parallel(-10.0 / 200);
+  Math::Matrix4 m = Math::multiply_matrix(per, normalization);
+
+  // A corner of the window on the projection plane, and the same corner on the front and back planes.
+  double corners[3][3] = {{16, 12, -dp}, {16 * 10 / dp, 12 * 10 / dp, -10}, {16 * 200 / dp, 12 * 200 / dp, -200}};
+  double expected_z[3] = {-(dp - 10) / (200 - 10) * 200 / dp, 0, -1};
+
+  for (int i = 0; i < 3; i++)
+  {
+    // Act
+    double x = m[0][0] * corners[i][0] + m[0][1] * corners[i][1] + m[0][2] * corners[i][2] + m[0][3];
+    double y = m[1][0] * corners[i][0] + m[1][1] * corners[i][1] + m[1][2] * corners[i][2] + m[1][3];
+    double z = m[2][0] * corners[i][0] + m[2][1] * corners[i][1] + m[2][2] * corners[i][2] + m[2][3];
+    double h = m[3][0] * corners[i][0] + m[3][1] * corners[i][1] + m[3][2] * corners[i][2] + m[3][3];
+
+    // Expect
+    EXPECT_NEAR(x / h, 1, 1e-9);
+    EXPECT_NEAR(y / h, 1, 1e-9);
+    EXPECT_NEAR(z / h, expected_z[i], 1e-9);
+    EXPECT_NEAR(h, -corners[i][2] / 200, 1e-9);
+  }
+}
+
+/**
+ * @brief Test case for the pipeline interface: both pipelines take the points to the same place on
+ * the screen.
+ *
+ */
+TEST_F(PipelineTest, pipelines_agree)
+{
+  // Arrange
+  Core::Camera camera(vrp, p, dp, viewport, window);
+  const pipeline::Pipeline &santa_catarina = pipeline::get_pipeline(pipeline::PipelineKind::SANTA_CATARINA);
+  const pipeline::Pipeline &madeiras_pereira = pipeline::get_pipeline(pipeline::PipelineKind::MADEIRAS_PEREIRA);
+
+  // Act
+  Math::Matrix4 sc = santa_catarina.transform(camera);
+  Math::Matrix4 mp = madeiras_pereira.transform(camera);
+
+  // Expect
+  EXPECT_STREQ(madeiras_pereira.getName(), "Madeiras Pereira");
+  for (Core::Vertex::Vertex v : {a, b, c, d, e})
+  {
+    double sc_h = sc[3][0] * v.x + sc[3][1] * v.y + sc[3][2] * v.z + sc[3][3];
+    double mp_h = mp[3][0] * v.x + mp[3][1] * v.y + mp[3][2] * v.z + mp[3][3];
+
+    for (int i = 0; i < 2; i++)
+    {
+      double sc_coordinate = (sc[i][0] * v.x + sc[i][1] * v.y + sc[i][2] * v.z + sc[i][3]) / sc_h;
+      double mp_coordinate = (mp[i][0] * v.x + mp[i][1] * v.y + mp[i][2] * v.z + mp[i][3]) / mp_h;
+      EXPECT_NEAR(sc_coordinate, mp_coordinate, 1e-6);
+    }
+
+    // Both h grow with the distance to the observer, so the depth test works the same way.
+    EXPECT_NEAR(sc_h / mp_h, santa_catarina.depthToH(camera, 1) / madeiras_pereira.depthToH(camera, 1), 1e-9);
+  }
+}
+
+/**
+ * @brief Test case for a camera looking along the x axis: the projection doesn't depend on the
+ * direction of the camera, both pipelines still agree.
+ *
+ */
+TEST_F(PipelineTest, side_view)
+{
+  // Arrange
+  Core::Camera camera({80, 10, 25}, {20, 10, 25}, dp, viewport, window);
+  const pipeline::Pipeline &santa_catarina = pipeline::get_pipeline(pipeline::PipelineKind::SANTA_CATARINA);
+  const pipeline::Pipeline &madeiras_pereira = pipeline::get_pipeline(pipeline::PipelineKind::MADEIRAS_PEREIRA);
+
+  // Act
+  Math::Matrix4 sc = santa_catarina.transform(camera);
+  Math::Matrix4 mp = madeiras_pereira.transform(camera);
+
+  // Expect
+  for (Core::Vertex::Vertex v : {a, b, c, d, e})
+  {
+    double sc_h = sc[3][0] * v.x + sc[3][1] * v.y + sc[3][2] * v.z + sc[3][3];
+    double mp_h = mp[3][0] * v.x + mp[3][1] * v.y + mp[3][2] * v.z + mp[3][3];
+    EXPECT_NEAR(sc_h, (80 - v.x) / dp, 1e-9);
+
+    for (int i = 0; i < 3; i++)
+    {
+      double sc_coordinate = (sc[i][0] * v.x + sc[i][1] * v.y + sc[i][2] * v.z + sc[i][3]) / sc_h;
+      EXPECT_TRUE(std::isfinite(sc_coordinate));
+      if (i < 2)
+      {
+        EXPECT_NEAR(sc_coordinate, (mp[i][0] * v.x + mp[i][1] * v.y + mp[i][2] * v.z + mp[i][3]) / mp_h, 1e-6);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Test case for the function algebraic_pipeline_sta_catarina: the closed form is the same as
+ * the product of the three matrices.
+ *
+ */
+TEST_F(PipelineTest, algebraic_pipeline_sta_catarina)
+{
+  // Arrange
+  int int_window[4] = {0, 16, 0, 12};
+  int int_viewport[4] = {0, 319, 0, 239};
+  std::vector<std::vector<double>> expected = Math::multiply_matrix(
+      pipeline::santa_catarina::src2srt(window, viewport, true),
+      Math::multiply_matrix(pipeline::santa_catarina::projection(vrp, p, dp), pipeline::santa_catarina::sru2src(vrp, p)));
+
+  // Act
+  std::vector<std::vector<double>> result = pipeline::santa_catarina::algebraic_pipeline_sta_catarina(vrp, p, p, dp, int_window, int_viewport);
+  pipeline::santa_catarina::ScreenProjection s = pipeline::santa_catarina::screen_projection(result);
+
+  // Expect
+  for (int i = 0; i < 4; i++)
+  {
+    for (int j = 0; j < 4; j++)
+    {
+      EXPECT_NEAR(result[i][j], expected[i][j], 1e-9);
+    }
+  }
+
+  for (Core::Vertex::Vertex v : {a, b, c, d, e})
+  {
+    double x, y, inv_h;
+    pipeline::santa_catarina::project_vertex(s, v, x, y, inv_h);
+
+    double h = expected[3][0] * v.x + expected[3][1] * v.y + expected[3][2] * v.z + expected[3][3];
+    EXPECT_NEAR(x, (expected[0][0] * v.x + expected[0][1] * v.y + expected[0][2] * v.z + expected[0][3]) / h, 1e-9);
+    EXPECT_NEAR(y, (expected[1][0] * v.x + expected[1][1] * v.y + expected[1][2] * v.z + expected[1][3]) / h, 1e-9);
+    EXPECT_NEAR(inv_h, 1 / h, 1e-12);
+  }
+}
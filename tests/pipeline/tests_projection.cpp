@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <core/camera.hpp>
+#include <core/mesh.hpp>
+#include <core/scene.hpp>
+#include <core/vector.hpp>
+#include <math/matrix.hpp>
+#include <pipeline/projection.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+class ProjectionTest : public ::testing::Test
+{
+protected:
+  Core::Camera *camera = new Core::Camera({25, 15, 80}, {20, 10, 25}, 40, {0, 319, 0, 239}, {0, 16, 0, 12});
+
+  void SetUp() override {}
+
+  // A mesh made only of vertexes, scattered around the focal point moved by offset
+  Core::Mesh *makeCloud(size_t count, unsigned seed, Core::Vertex::Vertex offset = {0, 0, 0})
+  {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coordinate(-20.0, 20.0);
+    std::vector<Core::Vector *> vertexes(count);
+    for (Core::Vector *&v : vertexes)
+    {
+      v = new Core::Vector(offset.x + 20 + coordinate(rng), offset.y + 10 + coordinate(rng), offset.z + 25 + coordinate(rng), 1.0, nullptr, "v");
+    }
+    return new Core::Mesh(vertexes, {}, "cloud");
+  }
+};
+
+/**
+ * @brief Test case for project_scene: meshes smaller than a chunk, of exactly one chunk and
+ * spanning several chunks are projected like each vertex alone through the camera stages.
+ *
+ */
+TEST_F(ProjectionTest, project_scene)
+{
+  // Arrange
+  const std::vector<size_t> sizes = {1, pipeline::PROJECTION_CHUNK_VERTEXES, 0, 3 * pipeline::PROJECTION_CHUNK_VERTEXES + 17};
+  Core::Scene *scene = new Core::Scene({}, camera);
+  for (size_t m = 0; m < sizes.size(); m++)
+  {
+    scene->addObject(makeCloud(sizes[m], static_cast<unsigned>(m)));
+  }
+  const pipeline::Pipeline &stages = pipeline::get_pipeline(pipeline::PipelineKind::SANTA_CATARINA);
+  const Math::Matrix4 transform = Math::multiply_matrix(stages.projection(*camera), stages.view(*camera));
+  const Math::ScaleTranslateMatrix<double> screen = Math::to_scale_translate(stages.screen(*camera));
+  std::vector<pipeline::ProjectedVertexes> projected;
+
+  // Act
+  pipeline::project_scene(scene, pipeline::PipelineKind::SANTA_CATARINA, projected);
+
+  // Expect
+  ASSERT_EQ(projected.size(), sizes.size());
+  for (size_t m = 0; m < sizes.size(); m++)
+  {
+    const std::vector<Core::Vector *> &vertexes = scene->getObjects()[m]->getVertexes();
+    ASSERT_EQ(projected[m].screen_x.size(), sizes[m]);
+    for (size_t i = 0; i < vertexes.size(); i++)
+    {
+      const Core::Vertex::Vertex v = vertexes[i]->getVertex();
+      const Math::Point4<double> clip = Math::apply_point(transform, v.x, v.y, v.z);
+      const double x = screen.s[0] * clip.x / clip.h + screen.t[0];
+      const double y = screen.s[1] * clip.y / clip.h + screen.t[1];
+      ASSERT_NEAR(projected[m].clip_h[i], clip.h, 1e-3 * std::abs(clip.h));
+      ASSERT_NEAR(projected[m].screen_x[i], x, 0.05);
+      ASSERT_NEAR(projected[m].screen_y[i], y, 0.05);
+    }
+  }
+}
+
+/**
+ * @brief Test case for the projection buffers: they start on a cache line and are kept when the
+ * scene is projected again with fewer vertexes.
+ *
+ */
+TEST_F(ProjectionTest, buffers_reused)
+{
+  // Arrange
+  Core::Scene *scene = new Core::Scene({makeCloud(5000, 1)}, camera);
+  std::vector<pipeline::ProjectedVertexes> projected;
+  pipeline::project_scene(scene, pipeline::PipelineKind::MADEIRAS_PEREIRA, projected);
+  const float *buffer = projected[0].screen_x.data();
+
+  // Act
+  scene->setObjects({makeCloud(3000, 2)});
+  pipeline::project_scene(scene, pipeline::PipelineKind::MADEIRAS_PEREIRA, projected);
+
+  // Expect
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer) % parallel::CACHE_LINE, 0u);
+  EXPECT_EQ(projected[0].screen_x.data(), buffer);
+  EXPECT_EQ(projected[0].screen_x.size(), 3000u);
+}
+
+/**
+ * @brief Test case for the model matrices: a mesh placed by its node is projected like its
+ * vertexes moved by hand, without changing the mesh.
+ *
+ */
+TEST_F(ProjectionTest, model_transform)
+{
+  // Arrange
+  Core::Mesh *cloud = makeCloud(100, 3);
+  Math::Matrix4 model = Math::identity_matrix();
+  model[0][3] = 2;
+  model[1][3] = -1;
+  model[2][3] = 3;
+  Core::Scene *scene = new Core::Scene({}, camera);
+  scene->addNode(cloud, -1, model);
+  const pipeline::Pipeline &stages = pipeline::get_pipeline(pipeline::PipelineKind::SANTA_CATARINA);
+  const Math::Matrix4 transform = Math::multiply_matrix(stages.projection(*camera), stages.view(*camera));
+  const Math::ScaleTranslateMatrix<double> screen = Math::to_scale_translate(stages.screen(*camera));
+  std::vector<pipeline::ProjectedVertexes> projected;
+
+  // Act
+  pipeline::project_scene(scene, pipeline::PipelineKind::SANTA_CATARINA, projected);
+
+  // Expect
+  ASSERT_EQ(projected.size(), 1u);
+  const std::vector<Core::Vector *> &vertexes = cloud->getVertexes();
+  for (size_t i = 0; i < vertexes.size(); i++)
+  {
+    const Core::Vertex::Vertex v = vertexes[i]->getVertex();
+    const Math::Point4<double> clip = Math::apply_point(transform, v.x + 2, v.y - 1, v.z + 3);
+    ASSERT_NEAR(projected[0].screen_x[i], screen.s[0] * clip.x / clip.h + screen.t[0], 0.05);
+    ASSERT_NEAR(projected[0].screen_y[i], screen.s[1] * clip.y / clip.h + screen.t[1], 0.05);
+  }
+}
+
+/**
+ * @brief Test case for instanced meshes: each instance of a shared mesh is projected with its own
+ * model matrix, like a mesh of its own.
+ *
+ */
+TEST_F(ProjectionTest, instances)
+{
+  // Arrange
+  Core::Mesh *cloud = makeCloud(2 * pipeline::PROJECTION_CHUNK_VERTEXES + 5, 4);
+  Core::Scene *scene = new Core::Scene({}, camera);
+  for (int i = 0; i < 3; i++)
+  {
+    Math::Matrix4 model = Math::identity_matrix();
+    model[0][3] = 4.0 * i;
+    scene->addInstance(cloud, model);
+  }
+  const pipeline::Pipeline &stages = pipeline::get_pipeline(pipeline::PipelineKind::SANTA_CATARINA);
+  const Math::Matrix4 transform = Math::multiply_matrix(stages.projection(*camera), stages.view(*camera));
+  const Math::ScaleTranslateMatrix<double> screen = Math::to_scale_translate(stages.screen(*camera));
+  std::vector<pipeline::ProjectedVertexes> projected;
+
+  // Act
+  pipeline::project_scene(scene, pipeline::PipelineKind::SANTA_CATARINA, projected);
+
+  // Expect
+  ASSERT_EQ(projected.size(), 3u);
+  const std::vector<Core::Vector *> &vertexes = cloud->getVertexes();
+  for (size_t m = 0; m < 3; m++)
+  {
+    ASSERT_EQ(projected[m].screen_x.size(), vertexes.size());
+    for (size_t i = 0; i < vertexes.size(); i++)
+    {
+      const Core::Vertex::Vertex v = vertexes[i]->getVertex();
+      const Math::Point4<double> clip = Math::apply_point(transform, v.x + 4.0 * m, v.y, v.z);
+      ASSERT_NEAR(projected[m].screen_x[i], screen.s[0] * clip.x / clip.h + screen.t[0], 0.05);
+      ASSERT_NEAR(projected[m].screen_y[i], screen.s[1] * clip.y / clip.h + screen.t[1], 0.05);
+    }
+  }
+}
+
+/**
+ * @brief Test case for the precision far from the origin: a mesh and its camera moved millions of
+ * units away are projected like each vertex alone through the camera stages in double.
+ *
+ */
+TEST_F(ProjectionTest, far_from_origin)
+{
+  // Arrange
+  const Core::Vertex::Vertex far = {1e6, -2e6, 5e5};
+  Core::Camera *far_camera = new Core::Camera({25 + far.x, 15 + far.y, 80 + far.z}, {20 + far.x, 10 + far.y, 25 + far.z}, 40, {0, 319, 0, 239}, {0, 16, 0, 12});
+  Core::Scene *scene = new Core::Scene({makeCloud(pipeline::PROJECTION_CHUNK_VERTEXES + 100, 5, far)}, far_camera);
+  const pipeline::Pipeline &stages = pipeline::get_pipeline(pipeline::PipelineKind::SANTA_CATARINA);
+  const Math::Matrix4 transform = Math::multiply_matrix(stages.projection(*far_camera), stages.view(*far_camera));
+  const Math::ScaleTranslateMatrix<double> screen = Math::to_scale_translate(stages.screen(*far_camera));
+  std::vector<pipeline::ProjectedVertexes> projected;
+
+  // Act
+  pipeline::project_scene(scene, pipeline::PipelineKind::SANTA_CATARINA, projected);
+
+  // Expect
+  ASSERT_EQ(projected.size(), 1u);
+  const std::vector<Core::Vector *> &vertexes = scene->getObjects()[0]->getVertexes();
+  for (size_t i = 0; i < vertexes.size(); i++)
+  {
+    const Core::Vertex::Vertex v = vertexes[i]->getVertex();
+    const Math::Point4<double> clip = Math::apply_point(transform, v.x, v.y, v.z);
+    ASSERT_NEAR(projected[0].screen_x[i], screen.s[0] * clip.x / clip.h + screen.t[0], 0.05);
+    ASSERT_NEAR(projected[0].screen_y[i], screen.s[1] * clip.y / clip.h + screen.t[1], 0.05);
+  }
+}
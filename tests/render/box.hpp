@@ -0,0 +1,22 @@
+#pragma once
+
+#include <core/mesh.hpp>
+#include <core/vector.hpp>
+
+#include <string>
+#include <vector>
+
+// An axis aligned box from low to high, with its faces facing out
+inline Core::Mesh *make_box(Core::Vertex::Vertex low, Core::Vertex::Vertex high, std::string name)
+{
+  std::vector<Core::Vector *> vertexes;
+  for (int corner = 0; corner < 8; corner++)
+  {
+    double x = (corner == 1 || corner == 2 || corner == 5 || corner == 6) ? high.x : low.x;
+    double y = corner >= 4 ? high.y : low.y;
+    double z = (corner == 2 || corner == 3 || corner == 6 || corner == 7) ? high.z : low.z;
+    vertexes.push_back(new Core::Vector(x, y, z, 1.0, nullptr, name + std::to_string(corner)));
+  }
+  std::vector<std::vector<int>> faces = {{2, 6, 7, 3}, {1, 0, 4, 5}, {3, 7, 4, 0}, {2, 3, 0, 1}, {6, 2, 1, 5}, {6, 5, 4, 7}};
+  return new Core::Mesh(vertexes, faces, name);
+}
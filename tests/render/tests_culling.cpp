@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <core/mesh.hpp>
+#include <core/scene.hpp>
+#include <core/vector.hpp>
+#include <render/depth_pyramid.hpp>
+#include <render/framebuffer.hpp>
+#include <render/renderer.hpp>
+#include "box.hpp"
+
+#include <string>
+
+class CullingTest : public ::testing::Test
+{
+protected:
+  // An odd size, so the pyramid has partial texels on its borders.
+  render::FrameBuffer fb = render::FrameBuffer(37, 23);
+
+  void SetUp() override
+  {
+    fb.clear(0);
+  }
+
+  void fillDepth(int x_min, int y_min, int x_max, int y_max, float inv_w)
+  {
+    for (int y = y_min; y < y_max; y++)
+    {
+      for (int x = x_min; x < x_max; x++)
+      {
+        fb.getDepth()[y * fb.getWidth() + x] = inv_w;
+      }
+    }
+  }
+};
+
+/**
+ * @brief Test case for the depth pyramid: each level keeps the farthest depth of its block.
+ *
+ */
+TEST_F(CullingTest, pyramid_levels)
+{
+  // Arrange
+  fillDepth(0, 0, 37, 23, 0.5f);
+  fillDepth(36, 22, 37, 23, 0.25f);
+
+  // Act
+  render::DepthPyramid pyramid;
+  pyramid.build(fb);
+
+  // Expect
+  // 37x23, 19x12, 10x6, 5x3, 3x2, 2x1, 1x1
+  ASSERT_EQ(pyramid.getNumLevels(), 7);
+  EXPECT_EQ(pyramid.getWidth(1), 19);
+  EXPECT_EQ(pyramid.getHeight(1), 12);
+  EXPECT_EQ(pyramid.getDepth(1, 18, 11), 0.25f);
+  EXPECT_EQ(pyramid.getDepth(1, 17, 11), 0.5f);
+  EXPECT_EQ(pyramid.getDepth(6, 0, 0), 0.25f);
+}
+
+/**
+ * @brief Test case for the occlusion test of a screen rectangle.
+ *
+ */
+TEST_F(CullingTest, pyramid_occlusion)
+{
+  // Arrange
+  // A hole in the bottom right corner, where nothing was drawn.
+  fillDepth(0, 0, 37, 23, 0.5f);
+  fillDepth(34, 20, 37, 23, 0.0f);
+  render::DepthPyramid pyramid;
+
+  // Act & Expect
+  // An empty pyramid occludes nothing.
+  EXPECT_FALSE(pyramid.isOccluded(10, 10, 12, 12, 0.1f));
+
+  pyramid.build(fb);
+
+  EXPECT_TRUE(pyramid.isOccluded(8, 8, 25, 15, 0.4f));
+  EXPECT_FALSE(pyramid.isOccluded(8, 8, 25, 15, 0.6f));
+  // The rectangle reaches pixels where nothing was drawn.
+  EXPECT_FALSE(pyramid.isOccluded(30, 18, 35, 21, 0.4f));
+  EXPECT_FALSE(pyramid.isOccluded(8, 8, 1e9f, 1e9f, 0.4f));
+  // The rectangle is outside of the frame buffer.
+  EXPECT_TRUE(pyramid.isOccluded(-50, -50, -10, -10, 0.4f));
+}
+
+/**
+ * @brief Test case for the renderer: the boxes hidden behind a wall are culled once the wall is
+ * known to be visible, and the image is the same as without culling.
+ *
+ */
+TEST_F(CullingTest, render_occluded_meshes)
+{
+  // Arrange
+  // The default camera looks down the z axis from z = 80, the wall covers its whole window.
+  Core::Scene *scene = new Core::Scene();
+  scene->addObject(make_box({-3, -3, 0.9}, {3, 3, 1.1}, "wall"));
+  scene->addObject(make_box({-0.5, -0.5, 5}, {0.5, 0.5, 6}, "front"));
+  const int HIDDEN = 10;
+  for (int i = 0; i < HIDDEN; i++)
+  {
+    double x = -2 + 0.4 * i;
+    scene->addObject(make_box({x, -0.2, -5.0 - i}, {x + 0.3, 0.2, -4.0 - i}, "hidden" + std::to_string(i)));
+  }
+
+  render::FrameBuffer culled(256, 256);
+  render::FrameBuffer reference(256, 256);
+  render::Renderer renderer(&culled);
+  render::Renderer no_culling(&reference);
+  no_culling.setOcclusionCulling(false);
+
+  // Act
+  // The first frame knows no occluders, the second learns the visible set, the third uses it.
+  renderer.render(scene);
+  int first = renderer.getCulledMeshes();
+  renderer.render(scene);
+  renderer.render(scene);
+  no_culling.render(scene);
+
+  // Expect
+  EXPECT_EQ(first, 0);
+  EXPECT_EQ(renderer.getCulledMeshes(), HIDDEN);
+  EXPECT_EQ(no_culling.getCulledMeshes(), 0);
+  for (int i = 0; i < 256 * 256; i++)
+  {
+    ASSERT_EQ(culled.getColor()[i], reference.getColor()[i]);
+  }
+}
+
+/**
+ * @brief Test case for instanced meshes: each instance of a shared box is culled on its own, and
+ * the image is the same as with a copy of the box at each place.
+ *
+ */
+TEST_F(CullingTest, render_instances)
+{
+  // Arrange
+  Core::Mesh *wall = make_box({-3, -3, 0.9}, {3, 3, 1.1}, "wall");
+  Core::Mesh *box = make_box({-0.2, -0.2, 0}, {0.2, 0.2, 1}, "box");
+  Core::Scene *instanced = new Core::Scene();
+  Core::Scene *copied = new Core::Scene();
+  instanced->addObject(wall);
+  copied->addObject(wall);
+  const std::vector<double> depths = {5, -4, -6, -8};
+  for (size_t i = 0; i < depths.size(); i++)
+  {
+    const double x = 0.5 * static_cast<double>(i) - 0.75;
+    Math::Matrix4 model = Math::identity_matrix();
+    model[0][3] = x;
+    model[2][3] = depths[i];
+    instanced->addInstance(box, model);
+    copied->addObject(make_box({x - 0.2, -0.2, depths[i]}, {x + 0.2, 0.2, depths[i] + 1}, "copy" + std::to_string(i)));
+  }
+
+  render::FrameBuffer culled(256, 256);
+  render::FrameBuffer reference(256, 256);
+  render::Renderer renderer(&culled);
+  render::Renderer no_culling(&reference);
+  no_culling.setOcclusionCulling(false);
+
+  // Act
+  // As for the meshes, the third frame culls with the instances found visible in the second one.
+  renderer.render(instanced);
+  renderer.render(instanced);
+  renderer.render(instanced);
+  no_culling.render(copied);
+
+  // Expect
+  EXPECT_EQ(instanced->getObjects().size(), 5u);
+  EXPECT_EQ(renderer.getCulledMeshes(), 3);
+  for (int i = 0; i < 256 * 256; i++)
+  {
+    ASSERT_EQ(culled.getColor()[i], reference.getColor()[i]);
+  }
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <core/camera.hpp>
+#include <core/mesh.hpp>
+#include <core/scene.hpp>
+#include <core/vector.hpp>
+#include <geometry/simplify.hpp>
+#include <math/matrix.hpp>
+#include <pipeline/pipeline.hpp>
+#include <render/framebuffer.hpp>
+#include <render/renderer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+class LodTest : public ::testing::Test
+{
+protected:
+  Core::Scene *scene = new Core::Scene();
+  Core::Mesh *grid = nullptr;
+  Core::Mesh *coarse = nullptr;
+
+  // A grid of 32 x 32 quads facing the default camera, with a single level of detail
+  void SetUp() override
+  {
+    const int n = 32;
+    std::vector<Core::Vector *> vertexes;
+    for (int y = 0; y <= n; y++)
+    {
+      for (int x = 0; x <= n; x++)
+      {
+        vertexes.push_back(new Core::Vector(x / 8.0 - 2, y / 8.0 - 2, 0.0, 1.0, nullptr, "v" + std::to_string(vertexes.size())));
+      }
+    }
+    std::vector<std::vector<int>> faces;
+    for (int y = 0; y < n; y++)
+    {
+      for (int x = 0; x < n; x++)
+      {
+        const int v = y * (n + 1) + x;
+        faces.push_back({v, v + 1, v + n + 2, v + n + 1});
+      }
+    }
+    grid = new Core::Mesh(vertexes, faces, "grid");
+    coarse = geometry::simplify_mesh(grid, 0.5, "coarse");
+    scene->addObject(grid);
+  }
+
+  // The size on the screen of a unit of the grid, measured as the renderer does on its coarsest level
+  double pixelsPerUnit()
+  {
+    Core::Camera *camera = scene->getCamera();
+    const pipeline::Pipeline &stages = pipeline::get_pipeline(pipeline::PipelineKind::SANTA_CATARINA);
+    const Math::Matrix4 transform = Math::multiply_matrix(stages.projection(*camera), stages.view(*camera));
+    const Math::ScaleTranslateMatrix<double> screen = Math::to_scale_translate(stages.screen(*camera));
+
+    Core::Vertex::Vertex low = coarse->getVertexes()[0]->getVertex();
+    Core::Vertex::Vertex high = low;
+    for (Core::Vector *v : coarse->getVertexes())
+    {
+      const Core::Vertex::Vertex p = v->getVertex();
+      low = {std::min(low.x, p.x), std::min(low.y, p.y), std::min(low.z, p.z)};
+      high = {std::max(high.x, p.x), std::max(high.y, p.y), std::max(high.z, p.z)};
+    }
+
+    double x_min = INFINITY, y_min = INFINITY, x_max = -INFINITY, y_max = -INFINITY;
+    for (int corner = 0; corner < 8; corner++)
+    {
+      const Math::Point4<double> p = Math::apply_point(transform, corner & 1 ? high.x : low.x, corner & 2 ? high.y : low.y, corner & 4 ? high.z : low.z);
+      const double x = screen.s[0] * p.x / p.h + screen.t[0];
+      const double y = screen.s[1] * p.y / p.h + screen.t[1];
+      x_min = std::min(x_min, x);
+      x_max = std::max(x_max, x);
+      y_min = std::min(y_min, y);
+      y_max = std::max(y_max, y);
+    }
+    return std::max(x_max - x_min, y_max - y_min) / std::max({high.x - low.x, high.y - low.y, high.z - low.z});
+  }
+
+  // Give the grid its level, losing details of the given size on the screen
+  void setErrorPixels(double pixels)
+  {
+    grid->setLods({{coarse, pixels / pixelsPerUnit()}});
+  }
+};
+
+/**
+ * @brief Test case for the choice of a level: a mesh whose level loses less than LOD_MAX_ERROR
+ * pixels is drawn with it, exactly as the simplified mesh alone.
+ *
+ */
+TEST_F(LodTest, select_level)
+{
+  // Arrange
+  render::FrameBuffer result(256, 256);
+  render::FrameBuffer expected(256, 256);
+  render::Renderer renderer(&result);
+  render::Renderer reference(&expected);
+  Core::Scene *simplified = new Core::Scene({coarse}, scene->getCamera());
+
+  // Act
+  setErrorPixels(0.5 * render::LOD_MAX_ERROR);
+  renderer.render(scene);
+  reference.render(simplified);
+
+  // Expect
+  EXPECT_EQ(renderer.getSimplifiedMeshes(), 1);
+  int covered = 0;
+  for (int i = 0; i < 256 * 256; i++)
+  {
+    ASSERT_EQ(result.getColor()[i], expected.getColor()[i]);
+    covered += result.getColor()[i] != result.getColor()[0];
+  }
+  EXPECT_GT(covered, 0);
+}
+
+/**
+ * @brief Test case for the hysteresis: a mesh keeps its level while the error stays within the
+ * margin around LOD_MAX_ERROR, a renderer without a previous level draws it in full, and it
+ * switches back once the error leaves the margin.
+ *
+ */
+TEST_F(LodTest, hysteresis)
+{
+  // Arrange
+  render::FrameBuffer fb(64, 64);
+  render::Renderer renderer(&fb);
+  render::Renderer fresh(&fb);
+  const double inside = render::LOD_MAX_ERROR * (1 + 0.5 * render::LOD_HYSTERESIS);
+  const double outside = render::LOD_MAX_ERROR * (1 + 2 * render::LOD_HYSTERESIS);
+
+  // Act
+  setErrorPixels(0.5 * render::LOD_MAX_ERROR);
+  renderer.render(scene);
+  setErrorPixels(inside);
+  renderer.render(scene);
+  const int kept = renderer.getSimplifiedMeshes();
+  fresh.render(scene);
+  setErrorPixels(outside);
+  renderer.render(scene);
+
+  // Expect
+  EXPECT_EQ(kept, 1);
+  EXPECT_EQ(fresh.getSimplifiedMeshes(), 0);
+  EXPECT_EQ(renderer.getSimplifiedMeshes(), 0);
+}
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <core/mesh.hpp>
+#include <core/scene.hpp>
+#include <core/vector.hpp>
+#include <render/depth_sort.hpp>
+#include <render/framebuffer.hpp>
+#include <render/renderer.hpp>
+#include "box.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+
+class PainterTest : public ::testing::Test
+{
+protected:
+  std::mt19937 generator = std::mt19937(42);
+
+  std::vector<float> randomKeys(size_t count)
+  {
+    // Few distinct values, so the order of equal keys is checked too.
+    std::uniform_int_distribution<int> distribution(-500, 500);
+    std::vector<float> keys(count);
+    for (float &key : keys)
+    {
+      key = distribution(generator) / 64.0f;
+    }
+    return keys;
+  }
+
+  std::vector<uint32_t> stableOrder(const std::vector<float> &keys)
+  {
+    std::vector<uint32_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                     { return keys[a] < keys[b]; });
+    return order;
+  }
+
+  int differentPixels(const render::FrameBuffer &a, const render::FrameBuffer &b)
+  {
+    int different = 0;
+    for (int i = 0; i < a.getWidth() * a.getHeight(); i++)
+    {
+      different += a.getColor()[i] != b.getColor()[i];
+    }
+    return different;
+  }
+};
+
+/**
+ * @brief Test case for the order preserving mapping of floats to integers.
+ *
+ */
+TEST_F(PainterTest, sortable_key)
+{
+  // Arrange
+  std::vector<float> keys = {-INFINITY, -1e30f, -2.5f, -1.0f, -1e-30f, -0.0f, 0.0f, 1e-30f, 1.0f, 2.5f, 1e30f, INFINITY};
+
+  // Act & Expect
+  for (size_t i = 0; i + 1 < keys.size(); i++)
+  {
+    EXPECT_LE(render::sortable_key(keys[i]), render::sortable_key(keys[i + 1]));
+  }
+  EXPECT_LT(render::sortable_key(-1e-30f), render::sortable_key(1e-30f));
+}
+
+/**
+ * @brief Test case for the radix sort: the same order as a stable comparison sort, with one
+ * thread and with the input split in chunks.
+ *
+ */
+TEST_F(PainterTest, radix_sort)
+{
+  for (size_t count : {size_t(0), size_t(1), size_t(1000), 3 * render::PARALLEL_SORT_MIN_KEYS + 7})
+  {
+    for (int threads : {1, 3})
+    {
+      // Arrange
+      std::vector<float> keys = randomKeys(count);
+      std::vector<uint32_t> order(count);
+
+      // Act
+      render::radix_sort(keys.data(), count, order.data(), threads);
+
+      // Expect
+      ASSERT_EQ(order, stableOrder(keys)) << count << " keys, " << threads << " threads";
+    }
+  }
+}
+
+/**
+ * @brief Test case for the painter's algorithm: separated meshes are drawn as with the z-buffer.
+ *
+ */
+TEST_F(PainterTest, render_painter)
+{
+  // Arrange
+  Core::Scene *scene = new Core::Scene();
+  scene->addObject(make_box({-1, -1, -3}, {1, 1, -1}, "back"));
+  scene->addObject(make_box({-0.5, -0.5, 4}, {1.5, 0.5, 6}, "front"));
+
+  render::FrameBuffer painter(256, 256);
+  render::FrameBuffer z_buffer(256, 256);
+  render::Renderer renderer(&painter);
+  render::Renderer reference(&z_buffer);
+  renderer.setVisibilityMode(render::VisibilityMode::PAINTER);
+
+  for (render::ShadingMode mode : {render::ShadingMode::FLAT, render::ShadingMode::GOURAUD, render::ShadingMode::PHONG})
+  {
+    // Act
+    renderer.setShadingMode(mode);
+    reference.setShadingMode(mode);
+    renderer.render(scene);
+    reference.render(scene);
+
+    // Expect
+    EXPECT_EQ(differentPixels(painter, z_buffer), 0);
+    EXPECT_TRUE(painter.getDepthTest());
+  }
+}
+
+/**
+ * @brief Test case for hidden lines: in wireframe mode the painter's algorithm hides the edges
+ * of the boxes behind a wall, which are drawn over it with the z-buffer.
+ *
+ */
+TEST_F(PainterTest, render_hidden_lines)
+{
+  // Arrange
+  Core::Scene *scene = new Core::Scene();
+  scene->addObject(make_box({-3, -3, 0.9}, {3, 3, 1.1}, "wall"));
+  scene->addObject(make_box({-0.5, -0.5, 5}, {0.5, 0.5, 6}, "front"));
+  Core::Scene *hidden = new Core::Scene();
+  hidden->addObject(make_box({-3, -3, 0.9}, {3, 3, 1.1}, "wall"));
+  hidden->addObject(make_box({-0.5, -0.5, 5}, {0.5, 0.5, 6}, "front"));
+  hidden->addObject(make_box({-1, -1, -3}, {1, 1, -1}, "back"));
+
+  render::FrameBuffer visible_only(256, 256);
+  render::FrameBuffer painter(256, 256);
+  render::FrameBuffer lines(256, 256);
+  render::Renderer renderer(&visible_only);
+  renderer.setShadingMode(render::ShadingMode::WIREFRAME);
+  renderer.setVisibilityMode(render::VisibilityMode::PAINTER);
+
+  // Act
+  renderer.render(scene);
+  renderer.setFrameBuffer(&painter);
+  renderer.render(hidden);
+  renderer.setVisibilityMode(render::VisibilityMode::Z_BUFFER);
+  renderer.setFrameBuffer(&lines);
+  renderer.render(hidden);
+
+  // Expect
+  render::FrameBuffer empty(256, 256);
+  empty.clear(render::pack_color(0, 0, 0));
+  EXPECT_GT(differentPixels(visible_only, empty), 0);
+  EXPECT_EQ(differentPixels(visible_only, painter), 0);
+  EXPECT_GT(differentPixels(visible_only, lines), 0);
+}
+
+/**
+ * @brief Test case for large faces in painter wireframe mode: a face with more vertexes than fit in
+ * the clip buffers that crosses the guard band is clipped by triangles, and hides what is behind it.
+ *
+ */
+TEST_F(PainterTest, render_large_face)
+{
+  // Arrange
+  std::vector<Core::Vector *> vertexes;
+  std::vector<int> loop;
+  for (int i = 0; i < 20; i++)
+  {
+    const double angle = 2 * M_PI * i / 20;
+    vertexes.push_back(new Core::Vector(1000 * std::cos(angle), 1000 * std::sin(angle), 0.0, 1.0, nullptr, "v" + std::to_string(i)));
+    loop.push_back(i);
+  }
+  Core::Scene *scene = new Core::Scene();
+  scene->addObject(new Core::Mesh(vertexes, {loop}, "disk"));
+  scene->addObject(make_box({-0.5, -0.5, 5}, {0.5, 0.5, 6}, "front"));
+  scene->addObject(make_box({-1, -1, -3}, {1, 1, -1}, "back"));
+  Core::Scene *front_only = new Core::Scene();
+  front_only->addObject(make_box({-0.5, -0.5, 5}, {0.5, 0.5, 6}, "front"));
+
+  render::FrameBuffer painter(256, 256);
+  render::FrameBuffer expected(256, 256);
+  render::Renderer renderer(&painter);
+  renderer.setShadingMode(render::ShadingMode::WIREFRAME);
+  renderer.setVisibilityMode(render::VisibilityMode::PAINTER);
+
+  // Act
+  renderer.render(scene);
+  renderer.setFrameBuffer(&expected);
+  renderer.render(front_only);
+
+  // Expect
+  // The disk covers the viewport, its edges are off the screen.
+  render::FrameBuffer empty(256, 256);
+  empty.clear(render::pack_color(0, 0, 0));
+  EXPECT_GT(differentPixels(painter, empty), 0);
+  EXPECT_EQ(differentPixels(painter, expected), 0);
+}
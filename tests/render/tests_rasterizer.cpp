@@ -0,0 +1,533 @@
+#include <gtest/gtest.h>
+#include <core/camera.hpp>
+#include <core/mesh.hpp>
+#include <core/scene.hpp>
+#include <core/vector.hpp>
+#include <render/framebuffer.hpp>
+#include <render/rasterizer.hpp>
+#include <render/renderer.hpp>
+#include "box.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+class RasterizerTest : public ::testing::Test
+{
+protected:
+  render::FrameBuffer fb = render::FrameBuffer(32, 32);
+
+  render::Color red = {1, 0, 0};
+  render::Color blue = {0, 0, 1};
+
+  void SetUp() override
+  {
+    fb.clear(0);
+  }
+
+  int coveredPixels()
+  {
+    int covered = 0;
+    for (int y = 0; y < fb.getHeight(); y++)
+    {
+      for (int x = 0; x < fb.getWidth(); x++)
+      {
+        covered += fb.getPixel(x, y) != 0;
+      }
+    }
+    return covered;
+  }
+};
+
+/**
+ * @brief Test case for the coverage of a triangle: only pixels whose centers are inside are filled.
+ *
+ */
+TEST_F(RasterizerTest, triangle_coverage)
+{
+  // Arrange
+  render::RasterVertex a = {0, 0, 1, red};
+  render::RasterVertex b = {16, 0, 1, red};
+  render::RasterVertex c = {0, 16, 1, red};
+
+  // Act
+  render::fill_triangle(fb, a, b, c);
+
+  // Expect
+  EXPECT_EQ(fb.getPixel(0, 0), render::pack_color(1, 0, 0));
+  EXPECT_EQ(fb.getPixel(14, 0), render::pack_color(1, 0, 0));
+  EXPECT_EQ(fb.getPixel(15, 0), 0u);
+  EXPECT_EQ(fb.getPixel(8, 8), 0u);
+  EXPECT_EQ(coveredPixels(), 16 * 15 / 2);
+}
+
+/**
+ * @brief Test case for the top-left rule: the pixel centers on the shared diagonal and on the
+ * borders of a square are drawn once, by the triangle that owns them.
+ *
+ */
+TEST_F(RasterizerTest, top_left_rule)
+{
+  // Arrange
+  // A square whose borders pass through pixel centers, split along a diagonal through centers.
+  render::RasterVertex a = {0.5f, 0.5f, 1, red};
+  render::RasterVertex b = {8.5f, 0.5f, 1, red};
+  render::RasterVertex c = {8.5f, 8.5f, 1, blue};
+  render::RasterVertex d = {0.5f, 8.5f, 1, blue};
+
+  // Act
+  render::fill_triangle(fb, a, b, c);
+  int first = coveredPixels();
+  render::fill_triangle(fb, a, c, d);
+
+  // Expect
+  // The top and left borders are drawn, the bottom and right ones belong to the neighbours.
+  EXPECT_EQ(coveredPixels(), 8 * 8);
+  EXPECT_NE(fb.getPixel(0, 0), 0u);
+  EXPECT_NE(fb.getPixel(7, 7), 0u);
+  EXPECT_EQ(fb.getPixel(8, 4), 0u);
+  EXPECT_EQ(fb.getPixel(4, 8), 0u);
+  // The diagonal (x == y) is a left edge of the first triangle, and a right edge of the second one.
+  EXPECT_EQ(first, 8 * 9 / 2);
+}
+
+/**
+ * @brief Test case for a mesh of triangles at subpixel positions: they cover every pixel exactly
+ * once, without cracks or overlaps along the shared edges.
+ *
+ */
+TEST_F(RasterizerTest, no_cracks)
+{
+  // Arrange
+  // A jittered grid larger than the frame buffer, each cell split along one of its diagonals.
+  const int N = 9;
+  float gx[N][N];
+  float gy[N][N];
+  for (int j = 0; j < N; j++)
+  {
+    for (int i = 0; i < N; i++)
+    {
+      gx[j][i] = -8.0f + i * 6.0f + ((i * 7 + j * 3) % 5) * 0.37f;
+      gy[j][i] = -8.0f + j * 6.0f + ((i * 5 + j * 11) % 7) * 0.29f;
+    }
+  }
+  // Some vertices exactly on pixel centers, where the tie breaking matters.
+  gx[3][3] = 10.5f;
+  gy[3][3] = 10.5f;
+  gx[4][5] = 22.5f;
+
+  std::vector<int> count(32 * 32, 0);
+  auto accumulate = [&](int j0, int i0, int j1, int i1, int j2, int i2)
+  {
+    fb.clear(0);
+    render::fill_triangle(fb, {gx[j0][i0], gy[j0][i0], 1, red}, {gx[j1][i1], gy[j1][i1], 1, red}, {gx[j2][i2], gy[j2][i2], 1, red});
+    for (int k = 0; k < 32 * 32; k++)
+    {
+      count[k] += fb.getPixel(k % 32, k / 32) != 0;
+    }
+  };
+
+  // Act
+  for (int j = 0; j + 1 < N; j++)
+  {
+    for (int i = 0; i + 1 < N; i++)
+    {
+      if ((i + j) % 2 == 0)
+      {
+        accumulate(j, i, j, i + 1, j + 1, i + 1);
+        accumulate(j, i, j + 1, i + 1, j + 1, i);
+      }
+      else
+      {
+        accumulate(j, i, j, i + 1, j + 1, i);
+        accumulate(j, i + 1, j + 1, i + 1, j + 1, i);
+      }
+    }
+  }
+
+  // Expect
+  for (int k = 0; k < 32 * 32; k++)
+  {
+    EXPECT_EQ(count[k], 1) << "pixel (" << k % 32 << ", " << k / 32 << ")";
+  }
+}
+
+/**
+ * @brief Test case for the polygon fill: a triangle covers the same pixels as with fill_triangle,
+ * and a convex polygon the same pixels as its triangle fan.
+ *
+ */
+TEST_F(RasterizerTest, polygon_matches_triangles)
+{
+  // Arrange
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> coordinate(-4.0f, 36.0f);
+  std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+  render::FrameBuffer fan(32, 32);
+
+  for (int test = 0; test < 200; test++)
+  {
+    // A random triangle, or a convex polygon with up to 20 vertices on an ellipse.
+    std::vector<render::RasterVertex> polygon;
+    if (test < 100)
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        polygon.push_back({coordinate(generator), coordinate(generator), 1, red});
+      }
+    }
+    else
+    {
+      std::vector<float> angles(3 + test % 18);
+      for (float &a : angles)
+      {
+        a = angle(generator);
+      }
+      std::sort(angles.begin(), angles.end());
+      const float cx = coordinate(generator), cy = coordinate(generator);
+      for (float a : angles)
+      {
+        polygon.push_back({cx + 14.0f * std::cos(a), cy + 9.0f * std::sin(a), 1, red});
+      }
+    }
+
+    // Act
+    fb.clear(0);
+    fan.clear(0);
+    render::fill_polygon(fb, polygon.data(), nullptr, static_cast<int>(polygon.size()));
+    for (size_t i = 1; i + 1 < polygon.size(); i++)
+    {
+      render::fill_triangle(fan, polygon[0], polygon[i], polygon[i + 1]);
+    }
+
+    // Expect
+    for (int k = 0; k < 32 * 32; k++)
+    {
+      ASSERT_EQ(fb.getColor()[k] != 0, fan.getColor()[k] != 0) << "polygon " << test << ", pixel " << k;
+    }
+  }
+}
+
+/**
+ * @brief Test case for concave polygons and polygons indexed by a loop, as the faces of a mesh.
+ *
+ */
+TEST_F(RasterizerTest, polygon_concave)
+{
+  // Arrange
+  // An L shape, 20x20 without its 10x10 top right quarter, and a U shape inside of it.
+  const render::RasterVertex vertices[] = {{2, 2, 1, red}, {12, 2, 1, red}, {12, 12, 1, red}, {22, 12, 1, red},
+                                           {22, 22, 1, red}, {2, 22, 1, red}};
+  const int loop[] = {5, 4, 3, 2, 1, 0};
+  const render::RasterVertex u[] = {{24, 2, 1, blue}, {26, 2, 1, blue}, {26, 8, 1, blue}, {29, 8, 1, blue},
+                                    {29, 2, 1, blue}, {31, 2, 1, blue}, {31, 10, 1, blue}, {24, 10, 1, blue}};
+
+  // Act
+  render::fill_polygon(fb, vertices, loop, 6);
+  int l_pixels = coveredPixels();
+  render::fill_polygon(fb, u, nullptr, 8);
+
+  // Expect
+  // The pixel centers are at half integers, so the shapes cover exactly their areas.
+  EXPECT_EQ(l_pixels, 300);
+  EXPECT_EQ(coveredPixels(), 300 + 7 * 8 - 3 * 6);
+  EXPECT_EQ(fb.getPixel(17, 7), 0u);
+  EXPECT_EQ(fb.getPixel(27, 5), 0u);
+  EXPECT_EQ(fb.getPixel(27, 9), render::pack_color(0, 0, 1));
+}
+
+/**
+ * @brief Test case for the Gouraud interpolation of the vertex colors.
+ *
+ */
+TEST_F(RasterizerTest, gouraud_interpolation)
+{
+  // Arrange
+  render::RasterVertex a = {0, 0, 1, red};
+  render::RasterVertex b = {32, 0, 1, blue};
+  render::RasterVertex c = {0, 32, 1, red};
+
+  // Act
+  render::fill_triangle(fb, a, b, c);
+
+  // Expect
+  uint32_t left = fb.getPixel(0, 0);
+  uint32_t middle = fb.getPixel(15, 0);
+  EXPECT_GT(left & 0xFF, 250u);
+  EXPECT_LT((left >> 16) & 0xFF, 5u);
+  EXPECT_NEAR(static_cast<double>(middle & 0xFF), 255.0 * 16.5 / 32.0, 2.0);
+  EXPECT_NEAR(static_cast<double>((middle >> 16) & 0xFF), 255.0 * 15.5 / 32.0, 2.0);
+}
+
+/**
+ * @brief Test case for the Phong shading: each pixel is lit with its own interpolated position.
+ *
+ */
+TEST_F(RasterizerTest, phong_matches_point_lighting)
+{
+  // Arrange
+  render::Material material = {{0.1, 0.1, 0.1}, {0.6, 0.6, 0.6}, {0.8, 0.8, 0.8}, 10};
+  render::Light light = {{16, 16, 10}, {1, 1, 1}, {1, 1, 1}, {1, 1, 1}};
+  Core::Vertex::Vertex eye = {16, 16, 20};
+
+  // A triangle on the z = 0 plane, where the screen and world coordinates coincide.
+  render::PhongVertex a = {0, 0, 1, 0, 0, 0, 0, 0, 1};
+  render::PhongVertex b = {32, 0, 1, 32, 0, 0, 0, 0, 1};
+  render::PhongVertex c = {0, 32, 1, 0, 32, 0, 0, 0, 1};
+
+  // Act
+  render::fill_triangle_phong(fb, a, b, c, eye, material, {light});
+
+  // Expect
+  for (int y = 0; y < 16; y += 3)
+  {
+    for (int x = 0; x < 16; x += 5)
+    {
+      render::Color expected = render::shade_point({x + 0.5, y + 0.5, 0}, {0, 0, 1}, eye, material, {light});
+      uint32_t actual = fb.getPixel(x, y);
+
+      EXPECT_NEAR(static_cast<double>(actual & 0xFF), expected.r * 255.0, 2.0);
+    }
+  }
+
+  // The highlight is brighter than the corner, which Gouraud shading would miss entirely.
+  EXPECT_GT(fb.getPixel(15, 15) & 0xFF, fb.getPixel(0, 0) & 0xFF);
+}
+
+/**
+ * @brief Test case for the depth test: the fragment with the greatest 1/w is kept.
+ *
+ */
+TEST_F(RasterizerTest, depth_test)
+{
+  // Arrange
+  render::RasterVertex far_a = {0, 0, 0.1f, red};
+  render::RasterVertex far_b = {32, 0, 0.1f, red};
+  render::RasterVertex far_c = {0, 32, 0.1f, red};
+  render::RasterVertex near_a = {0, 0, 0.5f, blue};
+  render::RasterVertex near_b = {32, 0, 0.5f, blue};
+  render::RasterVertex near_c = {0, 32, 0.5f, blue};
+
+  // Act
+  render::fill_triangle(fb, near_a, near_b, near_c);
+  render::fill_triangle(fb, far_a, far_b, far_c);
+
+  // Expect
+  EXPECT_EQ(fb.getPixel(4, 4), render::pack_color(0, 0, 1));
+}
+
+/**
+ * @brief Test case for triangles partially outside of the frame buffer.
+ *
+ */
+TEST_F(RasterizerTest, scissor)
+{
+  // Arrange
+  render::RasterVertex a = {-100, -100, 1, red};
+  render::RasterVertex b = {200, -100, 1, red};
+  render::RasterVertex c = {-100, 200, 1, red};
+
+  // Act
+  render::fill_triangle(fb, a, b, c);
+
+  // Expect
+  EXPECT_EQ(coveredPixels(), 32 * 32);
+}
+
+/**
+ * @brief Test case for the scissor rectangle: nothing is drawn outside of it.
+ *
+ */
+TEST_F(RasterizerTest, scissor_rectangle)
+{
+  // Arrange
+  render::RasterVertex a = {-100, -100, 1, red};
+  render::RasterVertex b = {200, -100, 1, red};
+  render::RasterVertex c = {-100, 200, 1, red};
+  fb.setScissor(4, 8, 12, 24);
+
+  // Act
+  render::fill_triangle(fb, a, b, c);
+  render::draw_line(fb, {0, 16, 1, blue}, {32, 16, 1, blue});
+
+  // Expect
+  EXPECT_EQ(coveredPixels(), 8 * 16);
+  EXPECT_EQ(fb.getPixel(4, 8), render::pack_color(1, 0, 0));
+  EXPECT_EQ(fb.getPixel(11, 16), render::pack_color(0, 0, 1));
+  EXPECT_EQ(fb.getPixel(3, 16), 0u);
+}
+
+/**
+ * @brief Test case for the renderer: a cube in front of the default camera is drawn at the
+ * center of the viewport, in every shading mode.
+ *
+ */
+TEST_F(RasterizerTest, render_cube)
+{
+  // Arrange
+  Core::Vector *v0 = new Core::Vector(-1.0, -1.0, -1.0, 1.0, nullptr, "v0");
+  Core::Vector *v1 = new Core::Vector(1.0, -1.0, -1.0, 1.0, nullptr, "v1");
+  Core::Vector *v2 = new Core::Vector(1.0, -1.0, 1.0, 1.0, nullptr, "v2");
+  Core::Vector *v3 = new Core::Vector(-1.0, -1.0, 1.0, 1.0, nullptr, "v3");
+  Core::Vector *v4 = new Core::Vector(-1.0, 1.0, -1.0, 1.0, nullptr, "v4");
+  Core::Vector *v5 = new Core::Vector(1.0, 1.0, -1.0, 1.0, nullptr, "v5");
+  Core::Vector *v6 = new Core::Vector(1.0, 1.0, 1.0, 1.0, nullptr, "v6");
+  Core::Vector *v7 = new Core::Vector(-1.0, 1.0, 1.0, 1.0, nullptr, "v7");
+  std::vector<std::vector<int>> faces = {{2, 6, 7, 3}, {1, 0, 4, 5}, {3, 7, 4, 0}, {2, 3, 0, 1}, {6, 2, 1, 5}, {6, 5, 4, 7}};
+
+  Core::Scene *scene = new Core::Scene();
+  scene->addObject(new Core::Mesh({v0, v1, v2, v3, v4, v5, v6, v7}, faces, "cube"));
+
+  render::FrameBuffer target(256, 256);
+  render::Renderer renderer(&target);
+
+  for (render::ShadingMode mode : {render::ShadingMode::FLAT, render::ShadingMode::GOURAUD, render::ShadingMode::PHONG})
+  {
+    // Act
+    renderer.setShadingMode(mode);
+    renderer.render(scene);
+
+    // Expect
+    EXPECT_NE(target.getPixel(128, 128), render::pack_color(0, 0, 0));
+    EXPECT_EQ(target.getPixel(2, 2), render::pack_color(0, 0, 0));
+  }
+
+  // The madeiras_pereira pipeline projects the cube to the same pixels.
+  render::FrameBuffer santa_catarina_target = target;
+  renderer.setPipeline(pipeline::PipelineKind::MADEIRAS_PEREIRA);
+  renderer.render(scene);
+
+  int different = 0;
+  for (int i = 0; i < 256 * 256; i++)
+  {
+    different += santa_catarina_target.getColor()[i] != target.getColor()[i];
+  }
+  EXPECT_LT(different, 32);
+  renderer.setPipeline(pipeline::PipelineKind::SANTA_CATARINA);
+
+  // A camera inside of the cube: the faces cross the near plane and the window and are clipped.
+  scene->getCamera()->setVRP({0.0, 0.0, 0.5});
+  scene->getCamera()->setP({0.0, 0.0, -10.0});
+  renderer.setShadingMode(render::ShadingMode::GOURAUD);
+  renderer.render(scene);
+
+  for (int y = 0; y < 255; y += 50)
+  {
+    for (int x = 0; x < 255; x += 50)
+    {
+      EXPECT_NE(target.getPixel(x, y), render::pack_color(0, 0, 0));
+    }
+  }
+
+  // The vertexes of the mesh are left untouched.
+  EXPECT_EQ(v6->getX(), 1.0);
+  EXPECT_EQ(v6->getZ(), 1.0);
+}
+
+/**
+ * @brief Test case for the precision far from the origin: a cube, its camera and its light moved
+ * millions of units away are drawn like they are near the origin.
+ *
+ */
+TEST_F(RasterizerTest, render_far_from_origin)
+{
+  // Arrange
+  auto makeScene = [](Core::Vertex::Vertex offset)
+  {
+    std::vector<Core::Vector *> vertexes;
+    for (int i = 0; i < 8; i++)
+    {
+      vertexes.push_back(new Core::Vector(offset.x + (i & 1 ? 1.0 : -1.0), offset.y + (i & 2 ? 1.0 : -1.0), offset.z + (i & 4 ? 1.0 : -1.0), 1.0, nullptr,
+                                          "v" + std::to_string(i)));
+    }
+    std::vector<std::vector<int>> faces = {{0, 2, 3, 1}, {4, 5, 7, 6}, {0, 4, 6, 2}, {1, 3, 7, 5}, {0, 1, 5, 4}, {2, 6, 7, 3}};
+
+    Core::Scene *scene = new Core::Scene();
+    scene->addObject(new Core::Mesh(vertexes, faces, "cube"));
+    Core::Camera *camera = scene->getCamera();
+    camera->setVRP({offset.x + 30, offset.y + 20, offset.z + 80});
+    camera->setP({offset.x, offset.y, offset.z});
+    return scene;
+  };
+  const Core::Vertex::Vertex far = {1e6, -2e6, 5e5};
+
+  render::FrameBuffer near_target(256, 256);
+  render::FrameBuffer far_target(256, 256);
+  render::Renderer near_renderer(&near_target);
+  render::Renderer far_renderer(&far_target);
+  std::vector<render::Light> lights = near_renderer.getLights();
+  for (render::Light &light : lights)
+  {
+    light.position = {light.position.x + far.x, light.position.y + far.y, light.position.z + far.z};
+  }
+  far_renderer.setLights(lights);
+
+  for (render::ShadingMode mode : {render::ShadingMode::GOURAUD, render::ShadingMode::PHONG})
+  {
+    // Act
+    near_renderer.setShadingMode(mode);
+    far_renderer.setShadingMode(mode);
+    near_renderer.render(makeScene({0, 0, 0}));
+    far_renderer.render(makeScene(far));
+
+    // Expect
+    int covered = 0;
+    int different = 0;
+    for (int i = 0; i < 256 * 256; i++)
+    {
+      covered += near_target.getColor()[i] != 0;
+      different += near_target.getColor()[i] != far_target.getColor()[i];
+    }
+    EXPECT_GT(covered, 1000);
+    EXPECT_LT(different, 32);
+  }
+}
+
+/**
+ * @brief Test case for the projections kept between frames: only the objects that moved are
+ * projected again, the camera moving projects all of them, and the frames are the same as the
+ * ones of a renderer without anything kept.
+ *
+ */
+TEST_F(RasterizerTest, reproject_changes_only)
+{
+  // Arrange
+  Core::Scene *scene = new Core::Scene();
+  scene->addObject(make_box({-2, -1, -1}, {-0.5, 1, 1}, "left"));
+  scene->addObject(make_box({0.5, -1, -1}, {2, 1, 1}, "right"));
+  render::FrameBuffer target(256, 256);
+  render::FrameBuffer expected(256, 256);
+  render::Renderer renderer(&target);
+  Math::Matrix4 moved = Math::identity_matrix();
+  moved[1][3] = 0.5;
+  auto expectFresh = [&]()
+  {
+    render::Renderer fresh(&expected);
+    fresh.render(scene);
+    for (int i = 0; i < 256 * 256; i++)
+    {
+      ASSERT_EQ(target.getColor()[i], expected.getColor()[i]);
+    }
+  };
+
+  // Act
+  renderer.render(scene);
+  const int first = renderer.getProjectedMeshes();
+  renderer.render(scene);
+  const int same = renderer.getProjectedMeshes();
+  scene->setLocalTransform(1, moved);
+  renderer.render(scene);
+  const int one_moved = renderer.getProjectedMeshes();
+  expectFresh();
+  scene->getCamera()->setD(80);
+  renderer.render(scene);
+
+  // Expect
+  EXPECT_EQ(first, 2);
+  EXPECT_EQ(same, 0);
+  EXPECT_EQ(one_moved, 1);
+  EXPECT_EQ(renderer.getProjectedMeshes(), 2);
+  expectFresh();
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <render/shading.hpp>
+#include <vector>
+
+class ShadingTest : public ::testing::Test
+{
+protected:
+  // A purely diffuse white material.
+  render::Material diffuse_material = {{0, 0, 0}, {1, 1, 1}, {0, 0, 0}, 1};
+
+  // A white light straight above the origin.
+  render::Light light = {{0, 10, 0}, {0, 0, 0}, {1, 1, 1}, {0, 0, 0}};
+
+  // The observer, also above the origin.
+  Core::Vertex::Vertex eye = {0, 20, 0};
+
+  void SetUp() override {}
+};
+
+/**
+ * @brief Test case for the diffuse term of a single point.
+ *
+ */
+TEST_F(ShadingTest, diffuse_point)
+{
+  // Arrange
+  Core::Vertex::Vertex point = {0, 0, 0};
+  Core::Vertex::Vertex facing_normal = {0, 1, 0};
+  Core::Vertex::Vertex tilted_normal = {1, 1, 0};
+
+  // Act
+  render::Color facing = render::shade_point(point, facing_normal, eye, diffuse_material, {light});
+  render::Color tilted = render::shade_point(point, tilted_normal, eye, diffuse_material, {light});
+
+  // Expect
+  EXPECT_NEAR(facing.r, 1.0, 0.0001);
+  EXPECT_NEAR(tilted.r, 0.7071, 0.0001);
+  EXPECT_NEAR(tilted.g, tilted.r, 0.0001);
+  EXPECT_NEAR(tilted.b, tilted.r, 0.0001);
+}
+
+/**
+ * @brief Test case for the two-sided lighting: a normal facing away from the observer is flipped.
+ *
+ */
+TEST_F(ShadingTest, two_sided_lighting)
+{
+  // Arrange
+  Core::Vertex::Vertex point = {0, 0, 0};
+  Core::Vertex::Vertex back_normal = {0, -1, 0};
+
+  // Act
+  render::Color color = render::shade_point(point, back_normal, eye, diffuse_material, {light});
+
+  // Expect
+  EXPECT_NEAR(color.r, 1.0, 0.0001);
+}
+
+/**
+ * @brief Test case for the ambient and specular terms, and for the clamping of the result.
+ *
+ */
+TEST_F(ShadingTest, ambient_and_specular)
+{
+  // Arrange
+  render::Material material = {{0.5, 0.5, 0.5}, {0, 0, 0}, {1, 1, 1}, 8};
+  render::Light ambient_light = {{0, 10, 0}, {0.2, 0.4, 0.6}, {0, 0, 0}, {0, 0, 0}};
+  render::Light specular_light = {{0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {2, 2, 2}};
+  Core::Vertex::Vertex point = {0, 0, 0};
+  Core::Vertex::Vertex normal = {0, 1, 0};
+
+  // Act
+  render::Color ambient = render::shade_point(point, normal, eye, material, {ambient_light});
+  render::Color specular = render::shade_point(point, normal, eye, material, {specular_light});
+
+  // Expect
+  EXPECT_NEAR(ambient.r, 0.1, 0.0001);
+  EXPECT_NEAR(ambient.g, 0.2, 0.0001);
+  EXPECT_NEAR(ambient.b, 0.3, 0.0001);
+  EXPECT_NEAR(specular.r, 1.0, 0.0001);
+}
+
+/**
+ * @brief Test case for the batch evaluation, it must match the evaluation of each point.
+ *
+ */
+TEST_F(ShadingTest, batch_matches_single_points)
+{
+  // Arrange
+  render::Material material = {{0.1, 0.1, 0.1}, {0.6, 0.5, 0.4}, {0.5, 0.5, 0.5}, 4};
+  render::VertexBatch batch;
+  for (int i = 0; i < 37; i++)
+  {
+    batch.px.push_back(i * 0.5f - 9.0f);
+    batch.py.push_back(0.0f);
+    batch.pz.push_back(i * 0.25f);
+    batch.nx.push_back(0.1f * i);
+    batch.ny.push_back(1.0f);
+    batch.nz.push_back(-0.05f * i);
+  }
+  render::ColorBatch out;
+
+  // Act
+  render::shade_vertices(batch, eye, material, {light}, out);
+
+  // Expect
+  for (int i = 0; i < 37; i++)
+  {
+    render::Color expected = render::shade_point(
+        {batch.px[i], batch.py[i], batch.pz[i]}, {batch.nx[i], batch.ny[i], batch.nz[i]}, eye, material, {light});
+
+    EXPECT_NEAR(out.r[i], expected.r, 0.0001);
+    EXPECT_NEAR(out.g[i], expected.g, 0.0001);
+    EXPECT_NEAR(out.b[i], expected.b, 0.0001);
+  }
+}
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <core/camera.hpp>
+#include <core/mesh.hpp>
+#include <core/scene.hpp>
+#include <core/vector.hpp>
+#include <render/framebuffer.hpp>
+#include <render/render_worker.hpp>
+#include <render/renderer.hpp>
+#include "box.hpp"
+
+#include <chrono>
+#include <thread>
+
+class WorkerTest : public ::testing::Test
+{
+protected:
+  Core::Scene *scene = new Core::Scene();
+
+  void SetUp() override
+  {
+    Core::Vector *v0 = new Core::Vector(-1.0, -1.0, -1.0, 1.0, nullptr, "v0");
+    Core::Vector *v1 = new Core::Vector(1.0, -1.0, -1.0, 1.0, nullptr, "v1");
+    Core::Vector *v2 = new Core::Vector(1.0, -1.0, 1.0, 1.0, nullptr, "v2");
+    Core::Vector *v3 = new Core::Vector(-1.0, -1.0, 1.0, 1.0, nullptr, "v3");
+    Core::Vector *v4 = new Core::Vector(-1.0, 1.0, -1.0, 1.0, nullptr, "v4");
+    Core::Vector *v5 = new Core::Vector(1.0, 1.0, -1.0, 1.0, nullptr, "v5");
+    Core::Vector *v6 = new Core::Vector(1.0, 1.0, 1.0, 1.0, nullptr, "v6");
+    Core::Vector *v7 = new Core::Vector(-1.0, 1.0, 1.0, 1.0, nullptr, "v7");
+    std::vector<std::vector<int>> faces = {{2, 6, 7, 3}, {1, 0, 4, 5}, {3, 7, 4, 0}, {2, 3, 0, 1}, {6, 2, 1, 5}, {6, 5, 4, 7}};
+    scene->addObject(new Core::Mesh({v0, v1, v2, v3, v4, v5, v6, v7}, faces, "cube"));
+  }
+
+  render::RenderRequest makeRequest(const Core::Camera &camera)
+  {
+    return {camera, scene->getObjects(), scene->getObjectTransforms(), pipeline::PipelineKind::SANTA_CATARINA, render::ShadingMode::GOURAUD,
+            render::VisibilityMode::Z_BUFFER, true, 256, 256};
+  }
+
+  // Wait until the worker finished every submitted frame, then take the last one
+  const render::FrameBuffer *waitFrame(render::RenderWorker &worker)
+  {
+    while (worker.isBusy())
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return worker.takeFrame();
+  }
+
+  void expectSameFrame(const render::FrameBuffer &result, const render::FrameBuffer &expected)
+  {
+    ASSERT_EQ(result.getWidth(), expected.getWidth());
+    ASSERT_EQ(result.getHeight(), expected.getHeight());
+    int different = 0;
+    for (int y = 0; y < expected.getHeight(); y++)
+    {
+      for (int x = 0; x < expected.getWidth(); x++)
+      {
+        different += result.getPixel(x, y) != expected.getPixel(x, y);
+      }
+    }
+    EXPECT_EQ(different, 0);
+  }
+};
+
+/**
+ * @brief Test case for a frame of the worker: it is the frame the renderer draws on this thread,
+ * and it is taken only once.
+ *
+ */
+TEST_F(WorkerTest, same_frame)
+{
+  // Arrange
+  render::RenderWorker worker;
+  render::FrameBuffer expected(256, 256);
+  render::Renderer renderer(&expected);
+  renderer.render(scene);
+
+  // Act
+  worker.submit(makeRequest(*scene->getCamera()));
+  const render::FrameBuffer *frame = waitFrame(worker);
+
+  // Expect
+  ASSERT_NE(frame, nullptr);
+  expectSameFrame(*frame, expected);
+  EXPECT_FALSE(worker.hasFrame());
+  EXPECT_EQ(worker.takeFrame(), nullptr);
+}
+
+/**
+ * @brief Test case for a burst of camera moves: the last frame shown is the one of the last
+ * camera, and the frames taken in between are never drawn over while they are shown.
+ *
+ */
+TEST_F(WorkerTest, burst_of_moves)
+{
+  // Arrange
+  render::RenderWorker worker;
+  Core::Camera camera = *scene->getCamera();
+  Core::Vector *step = new Core::Vector(0.05, 0.0, 0.0, 1.0, nullptr, "step");
+  render::FrameBuffer shown;
+
+  // Act
+  for (int i = 0; i < 50; i++)
+  {
+    camera.rotate(step);
+    worker.submit(makeRequest(camera));
+
+    const render::FrameBuffer *frame = worker.takeFrame();
+    if (frame != nullptr)
+    {
+      shown = *frame;
+      // The worker keeps going while the frame is read.
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      expectSameFrame(*frame, shown);
+    }
+  }
+  // The last frame may have been taken in the loop already.
+  const render::FrameBuffer *last = waitFrame(worker);
+  if (last != nullptr)
+  {
+    shown = *last;
+  }
+
+  // Expect
+  scene->setCamera(&camera);
+  render::FrameBuffer expected(256, 256);
+  render::Renderer renderer(&expected);
+  renderer.render(scene);
+  expectSameFrame(shown, expected);
+}
+
+/**
+ * @brief Test case for a moved mesh: the worker draws it where its model matrix places it, like
+ * a copy of the mesh modeled there.
+ *
+ */
+TEST_F(WorkerTest, moved_mesh)
+{
+  // Arrange
+  render::RenderWorker worker;
+  Math::Matrix4 model = Math::identity_matrix();
+  model[0][3] = 2;
+  model[2][3] = -1;
+  Core::Mesh *cube = scene->getObjects()[0];
+  std::vector<Core::Vector *> vertexes;
+  for (Core::Vector *v : cube->getVertexes())
+  {
+    const Core::Vertex::Vertex p = v->getVertex();
+    vertexes.push_back(new Core::Vector(p.x + 2, p.y, p.z - 1, 1.0, nullptr, "v"));
+  }
+  std::vector<std::vector<int>> faces = {{2, 6, 7, 3}, {1, 0, 4, 5}, {3, 7, 4, 0}, {2, 3, 0, 1}, {6, 2, 1, 5}, {6, 5, 4, 7}};
+  Core::Scene *modeled = new Core::Scene({new Core::Mesh(vertexes, faces, "cube")}, scene->getCamera());
+  render::FrameBuffer expected(256, 256);
+  render::Renderer renderer(&expected);
+  renderer.render(modeled);
+
+  // Act
+  scene->setLocalTransform(0, model);
+  worker.submit(makeRequest(*scene->getCamera()));
+  const render::FrameBuffer *frame = waitFrame(worker);
+
+  // Expect
+  ASSERT_NE(frame, nullptr);
+  expectSameFrame(*frame, expected);
+}
+
+/**
+ * @brief Test case for occlusion culling through the worker: the visible meshes of a frame are
+ * kept for the next one, so the meshes behind a wall are culled from the third frame on.
+ *
+ */
+TEST_F(WorkerTest, occlusion_culling)
+{
+  // Arrange
+  render::RenderWorker worker;
+  Core::Scene *occluded = new Core::Scene({}, scene->getCamera());
+  occluded->addObject(make_box({-3, -3, 0.9}, {3, 3, 1.1}, "wall"));
+  for (int i = 0; i < 10; i++)
+  {
+    const double x = -2 + 0.4 * i;
+    occluded->addObject(make_box({x, -0.2, -5.0 - i}, {x + 0.3, 0.2, -4.0 - i}, "hidden" + std::to_string(i)));
+  }
+  render::RenderRequest request = makeRequest(*scene->getCamera());
+  request.meshes = occluded->getObjects();
+  request.transforms = occluded->getObjectTransforms();
+
+  // Act
+  for (int i = 0; i < 3; i++)
+  {
+    worker.submit(request);
+    waitFrame(worker);
+  }
+
+  // Expect
+  EXPECT_GT(worker.getCulledMeshes(), 0);
+}
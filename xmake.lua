@@ -12,13 +12,18 @@ add_cxflags("-std=c++20", { force = true })
 
 add_includedirs("include")
 
+-- std::thread
+add_syslinks("pthread")
+
 -- add libraries
 local project_libs = { "cxxopts", "fmt", "imgui-sfml", "imgui" }
 local test_libs = { "gtest" }
+local bench_libs = { "benchmark" }
 
 
 add_requires(table.unpack(project_libs))
 add_requires(table.unpack(test_libs))
+add_requires(table.unpack(bench_libs))
 
 -- librarys
 target("core")
@@ -39,6 +44,24 @@ add_files("src/pipeline/*.cpp")
 add_packages(table.unpack(project_libs))
 set_targetdir("./app")
 
+target("parallel")
+set_kind("static")
+add_files("src/parallel/*.cpp")
+add_packages(table.unpack(project_libs))
+set_targetdir("./app")
+
+target("geometry")
+set_kind("static")
+add_files("src/geometry/*.cpp")
+add_packages(table.unpack(project_libs))
+set_targetdir("./app")
+
+target("render")
+set_kind("static")
+add_files("src/render/*.cpp")
+add_packages(table.unpack(project_libs))
+set_targetdir("./app")
+
 target("gui")
 set_kind("static")
 add_files("src/gui/*.cpp")
@@ -73,6 +96,9 @@ add_deps("gui")
 add_deps("core")
 add_deps("math")
 add_deps("pipeline")
+add_deps("parallel")
+add_deps("geometry")
+add_deps("render")
 add_deps("gui/imgui")
 add_deps("gui/imgui-sfml")
 add_deps("utils")
@@ -86,16 +112,25 @@ add_packages(table.unpack(test_libs))
 add_deps("core")
 add_deps("math")
 add_deps("pipeline")
+add_deps("parallel")
+add_deps("geometry")
+add_deps("render")
 add_deps("utils")
 set_targetdir("./app")
 
--- -- benchmarks
--- target("app_bench")
--- set_kind("binary")
--- add_files("bench/**/*.cpp", "bench/main.cpp")
--- add_packages(table.unpack(bench_libs))
--- add_deps("core")
--- set_targetdir("./app")
+-- benchmarks
+target("app_bench")
+set_kind("binary")
+add_files("bench/**/*.cpp", "bench/main.cpp")
+add_packages(table.unpack(bench_libs))
+add_deps("core")
+add_deps("math")
+add_deps("pipeline")
+add_deps("parallel")
+add_deps("geometry")
+add_deps("render")
+add_deps("utils")
+set_targetdir("./app")
 
 --
 -- If you want to known more usage about xmake, please see https://xmake.io